@@ -1,9 +1,15 @@
 #ifndef APPLICATION_H
 #define APPLICATION_H
 
+#include <chrono>
+#include <cstddef>
+#include <memory>
 #include <string>
+#include "ChangeLog.h"
 #include "DataManager.h"
 #include "MenuSystem.h"
+#include "Server.h"
+#include "StartupProfile.h"
 
 class Application {
 private:
@@ -11,12 +17,56 @@ private:
     MenuSystem menu;
     std::string dataDir;
     bool safeToSave;
+    std::string changeLogPath;
+    std::unique_ptr<ChangeLogWriter> changeLog;
+    std::chrono::steady_clock::time_point constructedAt;
+    StartupProfile startup;
+
+    bool loadForHeadless();
+    bool startChangeLog();
+    // Records time-to-ready since construction and appends the startup
+    // profile to dataDir/startup.log (best effort)
+    void finishStartup(bool interactive);
 
 public:
     explicit Application(std::string dataDir = "data");
-    void initialize();
+    // Streams every change made after loading to `path` (see ChangeLog.h).
+    void setChangeLog(const std::string& path);
+    // False when the requested change log could not be started: the
+    // session would otherwise take edits that followers never see.
+    bool initialize();
     void run();
     void shutdown();
+
+    // Headless mode: runs commands from `source` ("-" for stdin) and saves
+    // every `commitEvery` mutations. Returns the process exit code.
+    int runBatch(const std::string& source, size_t commitEvery);
+    // Serves requests until Server::requestStop(). Returns the exit code.
+    int runServer(const ServerOptions& options);
+    // Warm standby: replays the primary's change log at `logPath` into this
+    // data directory until Follower::requestStop(), saving every
+    // `commitEvery` changes and about once a second when caught up. With a
+    // non-empty serve.endpoint it also serves reads until promoted.
+    int runFollower(const std::string& logPath, const ServerOptions& serve, size_t commitEvery);
+
+    // Sharding (see ShardRouter): splits this data directory into `shards`
+    // shard directories under `root`, by customer ID hash or balanced ranges.
+    int splitShards(const std::string& root, size_t shards, bool byRange);
+    // Like runBatch, over the shards under `root`.
+    int runShardedBatch(const std::string& root, const std::string& source, size_t commitEvery);
+
+    // Moves finalized orders dated before `cutoff` into a new archive
+    // segment (see OrderArchive) and saves. Returns the exit code.
+    int archiveOrders(const std::string& cutoff);
+
+    // Writes the invoices of finalized orders dated within [from, to] (blank
+    // = open) to the directory `out`, or with `bundle` to the single file
+    // `out` plus `out`.idx (see InvoiceExport). Saves nothing.
+    int exportInvoices(const std::string& out, bool bundle, const std::string& from, const std::string& to);
+
+    // Loads the data directory `runs` times into fresh DataManagers and
+    // prints the distribution of each load phase. Saves nothing.
+    int profileStartup(size_t runs);
 };
 
 #endif
\ No newline at end of file
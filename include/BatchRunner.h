@@ -0,0 +1,56 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+#include "DataManager.h"
+
+struct BatchStats {
+    size_t lines = 0;
+    size_t ok = 0;
+    size_t failed = 0;
+    size_t commits = 0;
+};
+
+// Executes one command per line against DataManager, without prompts:
+//
+//   create-order <orderId> <customerId> <YYYY-MM-DD>
+//   add-item     <orderId> <productId> <qty>
+//   remove-item  <orderId> <productId>
+//   finalize     <orderId>
+//   finalize-batch <orderId> [orderId ...]   (prints "orderId,reason" per skipped order)
+//   restock      <productId> <qty> [YYYY-MM-DD]
+//   expense      <amount> <YYYY-MM-DD|N/A> <description...>
+//   query-orders [from=D] [to=D] [customer=N] [tier=regular|premium] [product=N]
+//                [min=X] [max=X] [finalized=0|1] [sort=id|date|total|customer]
+//                [desc=1] [offset=N] [limit=N]
+//   commit
+//
+// Blank lines and lines starting with '#' are ignored. Data is saved every
+// `commitEvery` successful mutations (0 = only at the end).
+class BatchRunner {
+public:
+    BatchRunner(DataManager& dm, std::string dataDir, size_t commitEvery = 1000);
+
+    BatchStats run(std::istream& in, std::ostream& out, std::ostream& err);
+
+    // Runs a single command; throws on failure. Returns true if it mutated data.
+    bool execute(const std::string& line, std::ostream& out);
+
+    // The key=value arguments of query-orders, and its CSV output row
+    static OrderQuery parseOrderQuery(std::istream& args);
+    static void printOrderRow(const Order& order, std::ostream& out);
+
+private:
+    DataManager& dm;
+    std::string dataDir;
+    size_t commitEvery;
+    size_t pending;
+    BatchStats stats;
+
+    void commit();
+};
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef CHANGEFEED_H
+#define CHANGEFEED_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class ChangeType : uint8_t {
+    ProductUpsert = 1,
+    ProductRemove,
+    StockDelta,
+    CustomerUpsert,
+    CustomerUpgrade,
+    OrderCreate,
+    OrderItem,
+    OrderItemRemove,
+    OrderFinalize,
+    LedgerAppend,
+};
+
+const char* changeTypeName(ChangeType type);
+
+// One committed DataManager mutation. Field use per type:
+//
+//   ProductUpsert    id, name, amount = price, cost, qty = quantity
+//   ProductRemove    id
+//   StockDelta       id = productId, qty = delta
+//   CustomerUpsert   id, name, ref = 1 if premium, amount = loyalty
+//   CustomerUpgrade  id, amount = loyalty
+//   OrderCreate      id = orderId, ref = customerId, date
+//   OrderItem        id = orderId, ref = productId, qty = quantity added
+//   OrderItemRemove  id = orderId, ref = productId
+//   OrderFinalize    id = orderId, amount = total
+//   LedgerAppend     ref = 1 revenue / 0 expense, amount, name = description, date
+//
+// `derived` events are consequences of the event before them (the stock
+// and revenue of a finalization). They are published for consumers that
+// track state, and skipped by anything that replays operations.
+struct ChangeEvent {
+    uint64_t seq = 0;
+    ChangeType type = ChangeType::ProductUpsert;
+    bool derived = false;
+    int id = 0;
+    int ref = 0;
+    int qty = 0;
+    double amount = 0.0;
+    double cost = 0.0;
+    std::string name;
+    std::string date;
+};
+
+// Bounded single-producer/single-consumer queue. The producer only writes
+// `head` and the consumer only writes `tail`, so each side needs one
+// acquire load and one release store per element, and no locks.
+template<typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    bool tryPush(T&& value) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) > m_mask) return false;   // full
+        m_slots[head & m_mask] = std::move(value);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& out) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) return false;   // empty
+        out = std::move(m_slots[tail & m_mask]);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return m_mask + 1; }
+
+private:
+    std::vector<T> m_slots;
+    size_t m_mask = 0;
+    alignas(64) std::atomic<size_t> m_head{0};   // next slot to write
+    alignas(64) std::atomic<size_t> m_tail{0};   // next slot to read
+};
+
+// A subscriber's private queue. Drain it from one thread only.
+class ChangeSubscription {
+public:
+    ChangeSubscription(size_t capacity, bool lossless);
+
+    bool poll(ChangeEvent& out);
+    size_t drain(std::vector<ChangeEvent>& out, size_t max = SIZE_MAX);
+
+    // Lossy subscriptions drop events when full; the gap shows in `seq`.
+    uint64_t dropped() const;
+
+    // Called by the consumer when it can no longer keep the events (e.g. its
+    // log file failed). publish() then skips this subscription instead of
+    // waiting for room, and ChangeFeed::failure() reports `reason`.
+    void fail(const std::string& reason);
+    bool failed() const;
+
+private:
+    friend class ChangeFeed;
+    SpscRing<ChangeEvent> m_ring;
+    bool m_lossless;
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<bool> m_failed{false};
+    mutable std::mutex m_failureMutex;
+    std::string m_failure;
+};
+
+// Fan-out of DataManager change events, one SPSC ring per subscriber.
+// Publishing and (un)subscribing happen on the writer side, which
+// DataManager already requires to be a single thread at a time.
+class ChangeFeed {
+public:
+    // Lossless subscribers apply back-pressure: publish() waits for room
+    // instead of dropping, so their consumer must keep draining.
+    std::shared_ptr<ChangeSubscription> subscribe(size_t capacity = 4096, bool lossless = false);
+    void unsubscribe(const std::shared_ptr<ChangeSubscription>& subscription);
+
+    bool active() const;         // cheap check before building an event
+    void publish(ChangeEvent event);
+    uint64_t lastSeq() const;
+    // Why a lossless subscriber failed, or "" while they all keep up. Saving
+    // after one failed would put the data files ahead of its copy.
+    std::string failure() const;
+
+private:
+    std::vector<std::shared_ptr<ChangeSubscription>> m_subscribers;
+    uint64_t m_seq = 0;
+};
+
+#endif
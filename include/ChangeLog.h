@@ -0,0 +1,77 @@
+#ifndef CHANGELOG_H
+#define CHANGELOG_H
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "ChangeFeed.h"
+
+// Binary change log, readable while it is being written (like `tail -f`).
+//
+//   file   := "BMSCDC1\n" record*
+//   record := u32 length, then `length` bytes:
+//             u64 seq, u8 type, u8 derived, i32 id, i32 ref, i32 qty,
+//             f64 amount, f64 cost, u32 n, name[n], u32 n, date[n]
+//
+// Integers and doubles are in host byte order: the log is meant for
+// processes on the same machine.
+class ChangeLogWriter {
+public:
+    // Truncates `path` and starts a thread that drains a lossless
+    // subscription of `feed` into it, flushing after every batch. Throws
+    // FileOperationException if the file cannot be created. If a later
+    // write fails the thread logs it to stderr and stops, and the feed
+    // reports the failure (ChangeFeed::failure()), so saves refuse to run
+    // ahead of the log.
+    ChangeLogWriter(ChangeFeed& feed, const std::string& path);
+    ~ChangeLogWriter();   // close()
+
+    // Stops taking new events, drains what is queued and joins the thread
+    void close();
+
+    ChangeLogWriter(const ChangeLogWriter&) = delete;
+    ChangeLogWriter& operator=(const ChangeLogWriter&) = delete;
+
+    const std::string& path() const;
+    uint64_t written() const;
+    bool failed() const;
+
+private:
+    ChangeFeed& m_feed;
+    std::string m_path;
+    std::ofstream m_out;
+    std::shared_ptr<ChangeSubscription> m_subscription;
+    std::atomic<bool> m_stop{false};
+    std::atomic<uint64_t> m_written{0};
+    std::thread m_thread;
+
+    void run();
+};
+
+class ChangeLogReader {
+public:
+    explicit ChangeLogReader(const std::string& path);
+
+    // Reads the next complete record. Returns false at the current end of
+    // the file (including a record still being written); call again later
+    // to pick up new records.
+    bool next(ChangeEvent& event);
+
+    // True once `path` was deleted or now names a different file, i.e. the
+    // writer restarted and this reader is following a dead log.
+    bool replaced() const;
+
+private:
+    std::ifstream m_in;
+    std::string m_path;
+    std::streamoff m_pos;
+    uint64_t m_fileId;   // inode at open (0 where unsupported)
+};
+
+std::string encodeChangeEvent(const ChangeEvent& event);
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef CUSTOMER_H
 #define CUSTOMER_H
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -18,6 +19,7 @@ public:
     const std::string& getName() const;
     const std::vector<int>& getOrderHistory() const;
     void addOrderToHistory(int orderId);
+    void reserveHistory(size_t count);   // loader hint: history size known up front
 
     virtual double calculateDiscount() const = 0;
     void upgradeToPremium(Customer*& customer, double loyaltyPercent);
@@ -3,19 +3,40 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <utility>
 
 #include "Product.h"
 #include "Customer.h"
 #include "Order.h"
 #include "Finance.h"
+#include "SalesVelocity.h"
+#include "Query.h"
+#include "StockIndex.h"
+#include "ReportCache.h"
+#include "Reservations.h"
+#include "Snapshot.h"
+#include "ChangeFeed.h"
+#include "MemoryStats.h"
+#include "OrderArchive.h"
+#include "StartupProfile.h"
+
+struct BatchFinalizeResult {
+    std::vector<int> finalized;                       // in request order
+    std::vector<std::pair<int, std::string>> failed;  // (orderId, reason)
+    double revenue = 0.0;
+};
 
 class DataManager {
 public:
     DataManager() = default;
     ~DataManager(); // important: free Customer* pointers
 
-    // Load/Save everything
-    void loadAll(const std::string& dataDir = "data");
+    // Load/Save everything. `profile`, when given, receives the time spent
+    // in each load phase (read, parse, resolve, index). saveAll throws
+    // FileOperationException once the change log has failed (see
+    // ChangeFeed::failure()).
+    void loadAll(const std::string& dataDir = "data", StartupProfile* profile = nullptr);
     void saveAll(const std::string& dataDir = "data") const;
 
     // Accessors
@@ -28,15 +49,124 @@ public:
     const std::vector<Customer*>& customers() const;
     const std::vector<Order>& orders() const;
     const Finance& finance() const;
+    const SalesVelocity& salesVelocity() const;
+    StockIndex& stockIndex();
+    const StockIndex& stockIndex() const;
+    const ReservationLedger& reservations() const;
+
+    // On-hand stock not held by open orders (never negative)
+    int available(const Product& product) const;
+    // Frees reservations whose TTL has run out; returns how many lapsed.
+    size_t expireReservations();
+    void setReservationTtl(int seconds);
+    void clearReservations();
+
+    // Mutation counters for cache invalidation. Only changes made through
+    // the DataManager mutation methods below (or loadAll) bump them.
+    const DataEpochs& epochs() const;
+
+    // Lookups
+    Product* findProduct(int productId);
+    Customer* findCustomer(int customerId);
+    Order* findOrder(int orderId);
+
+    // Queries over the columnar order/ledger indexes
+    QueryResult queryOrders(const OrderQuery& query);
+    QueryResult queryTransactions(const LedgerQuery& query);
+    // Brings the lazily-synced indexes up to date. Until the next mutation,
+    // lookups and queries then only read, so they may run concurrently.
+    void syncIndexes();
+
+    // Versioned copy-on-write snapshots. The writer publishes at commit
+    // points; any thread may pin the latest version in O(1) and read it
+    // while the live state keeps changing. Chunks untouched since the last
+    // version are shared with it.
+    void publishSnapshot();
+    SnapshotPtr pinSnapshot() const;
+    static void saveSnapshot(const Snapshot& snapshot, const std::string& dataDir);
+
+    // Every mutation below publishes ChangeEvents here once it succeeded.
+    // Subscribe from the writer thread; nothing is built while nobody is.
+    ChangeFeed& changes();
+
+    // Estimated bytes and object counts per collection (see MemoryReport).
+    // Walks every entity, so it costs about as much as a full scan.
+    MemoryReport memoryUsage() const;
+
+    // Cold archive of old finalized orders (see OrderArchive), read from
+    // dataDir/archive by loadAll. Reports add its summaries to the live orders.
+    const OrderArchive& archive() const;
+    // Moves finalized orders dated before `cutoff` (YYYY-MM-DD) into a new
+    // archive segment and drops them from orders(); saveAll makes the
+    // removal stick. Meant for maintenance runs: no change events are
+    // published. Returns how many orders moved.
+    size_t archiveOrders(const std::string& dataDir, const std::string& cutoff);
+
+    // Mutations that keep derived structures in sync
+    Product& addProduct(int id, const std::string& name, double price, double cost, int qty);
+    void updateProduct(Product& product, const std::string& name, double price, double cost, int qty);
+    void adjustStock(Product& product, int delta);
+    // Throws InvalidInputException while a live order still holds the
+    // product: order items point into the product storage.
+    void removeProduct(int productId);
+    bool productReferenced(int productId) const;
+    // Applies (productId, qty) restocks all-or-nothing and books one
+    // aggregated expense. Returns the total cost.
+    double restockBatch(const std::vector<std::pair<int, int>>& lines, const std::string& date);
+    void recordExpense(double amount, const std::string& desc, const std::string& date = "");
+    void addCustomer(Customer* customer);   // takes ownership
+
+    Order& createOrder(int orderId, Customer* customer, const std::string& date);
+    // Adding or removing items reserves or frees stock for the order.
+    void addOrderItem(Order& order, Product* product, int qty);
+    void removeOrderItem(Order& order, Product* product);
+    void finalizeOrder(Order& order);
+    // Same outcome as calling finalizeOrder on each ID in turn and skipping
+    // the ones that throw: earlier orders in the list get stock first. Stock
+    // is checked for the whole batch up front, then applied as one delta per
+    // product, and the revenue entries are appended in bulk.
+    BatchFinalizeResult finalizeBatch(const std::vector<int>& orderIds);
+    // Upgrades regular customers to premium and repoints their orders to the
+    // new objects in a single pass. Returns how many were upgraded.
+    size_t upgradeCustomers(const std::vector<int>& customerIds, double loyaltyPercent);
 
 private:
     std::vector<Product> m_products;
     std::vector<Customer*> m_customers;  // polymorphic ownership (manual delete in destructor)
     std::vector<Order> m_orders;
     Finance m_finance;
+    SalesVelocity m_salesVelocity;  // derived from finalized orders
+    OrderIndex m_orderIndex;        // columns + ID/date indexes over m_orders
+    LedgerIndex m_ledgerIndex;      // columns + date index over the ledger
+    StockIndex m_stockIndex;        // products ordered by stock level
+    ReservationLedger m_reservations;  // stock held by open orders
+    std::unordered_map<int, size_t> m_productSlot;  // productId -> position in m_products
+    std::unordered_map<int, size_t> m_customerSlot; // customerId -> position in m_customers
+    DataEpochs m_epochs;
+    OrderArchive m_archive;
+
+    SnapshotPtr m_snapshot;                 // latest published version
+    std::vector<size_t> m_dirtyOrderRows;   // order rows edited since then
+    std::vector<size_t> m_dirtyCustomerRows;
+    std::vector<size_t> m_dirtyProductRows;
+    bool m_snapshotStale = true;            // rows shifted or reloaded: copy everything
+    ChangeFeed m_changes;
 
     static std::string joinPath(const std::string& dir, const std::string& file);
     void clearCustomers();
+    size_t rowOf(const Order& order) const;
+    void touchOrderRow(size_t row);
+    void touchCustomer(const Customer* customer);
+    void touchProduct(const Product& product);
+    void reindexProducts();
+    void reindexCustomers();
+    long customerRow(int customerId);
+    void relinkOrderProducts(const Product* oldBase, size_t oldCount, long erasedIndex);
+    void emitProduct(const Product& product);
+    void emitStock(int productId, int delta, bool derived);
+    void emitLedger(const Finance::Transaction& entry, bool derived);
+    void emitOrderItem(ChangeType type, const Order& order, int productId, int qty);
+    void emitFinalize(const Order& order, const Finance::Transaction& revenue);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef DATEUTIL_H
+#define DATEUTIL_H
+
+#include <string>
+
+// Helpers for the ISO "YYYY-MM-DD" dates stored in orders and the ledger.
+// Day numbers count days since 1970-01-01 so date arithmetic is plain int math.
+class DateUtil {
+public:
+    // Exactly "YYYY-MM-DD" naming a real calendar day. Returns false for
+    // anything else, including placeholders such as "N/A".
+    static bool toDayNumber(const std::string& iso, int& day);
+    static std::string fromDayNumber(int day);
+    static int todayDayNumber();
+    // Local wall-clock time as "YYYY-MM-DD HH:MM:SS", for logs
+    static std::string localTimestamp();
+};
+
+#endif
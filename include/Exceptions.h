@@ -34,4 +34,14 @@ public:
     }
 };
 
+class ReplicationException : public std::exception {
+private:
+    std::string message;
+public:
+    ReplicationException(const std::string& msg = "Replica diverged from primary") : message(msg) {}
+    const char* what() const noexcept override {
+        return message.c_str();
+    }
+};
+
 #endif
\ No newline at end of file
@@ -1,13 +1,32 @@
 #ifndef FILEMANAGER_H
 #define FILEMANAGER_H
 
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "Product.h"
 #include "Customer.h"
 #include "Order.h"
 #include "Finance.h"
+#include "Snapshot.h"
+
+// orders.txt rows before product and customer IDs are resolved
+struct ParsedOrders {
+    struct Row {
+        int orderId;
+        int customerId;      // -1 for guest orders
+        std::string date;
+        double total;
+        bool finalized;
+        size_t firstItem;    // this row's items are items[firstItem, firstItem + itemCount)
+        size_t itemCount;
+    };
+    std::vector<Row> rows;
+    std::vector<std::pair<int, int>> items;   // (productId, qty)
+};
 
 class FileManager {
 public:
@@ -29,13 +48,34 @@ public:
     static Finance loadFinance(const std::string& filepath);
     static void saveFinance(const Finance& finance, const std::string& filepath);
 
-private:
-    // Helpers
-    static std::vector<std::string> split(const std::string& s, char delim);
-    static std::string trim(const std::string& s);
+    // The loaders above in their steps: read a whole file, parse its text,
+    // and (orders only) resolve product and customer IDs through hash maps.
+    // readFile throws FileOperationException naming `kind` ("products", ...).
+    static std::string readFile(const std::string& filepath, const char* kind);
+    static std::vector<Product> parseProducts(std::string_view text);
+    static std::vector<Customer*> parseCustomers(std::string_view text);
+    static Finance parseFinance(std::string_view text);
+    static ParsedOrders parseOrders(std::string_view text);
+    static std::vector<Order> resolveOrders(ParsedOrders& parsed,
+                                            std::vector<Product>& products,
+                                            std::vector<Customer*>& customers);
 
-    static Product* findProductById(std::vector<Product>& products, int id);
-    static Customer* findCustomerById(std::vector<Customer*>& customers, int id);
+    // Same formats, written from a pinned snapshot
+    static void saveProducts(const ChunkedRows<ProductRow>& products, const std::string& filepath);
+    static void saveCustomers(const ChunkedRows<CustomerRow>& customers, const std::string& filepath);
+    static void saveOrders(const ChunkedRows<OrderRow>& orders, const std::string& filepath);
+    static void saveFinance(const Snapshot& snapshot, const std::string& filepath);
+
+private:
+    // Parsing helpers. Fields are views into the line being parsed; the
+    // field lists live in a scratch arena that the loaders reset every few
+    // hundred lines, so parsing a line allocates nothing on the heap.
+    static std::pmr::vector<std::string_view> split(std::string_view s, char delim,
+                                                    std::pmr::memory_resource* scratch);
+    static std::string_view trim(std::string_view s);
+    // Same acceptance rules and exceptions as std::stoi / std::stod
+    static int toInt(std::string_view field);
+    static double toDouble(std::string_view field);
 };
 
 #endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define FINANCE_H
 
 #include <string>
+#include <utility>
 #include <vector>
 
 class Finance {
@@ -11,6 +12,7 @@ public:
         double amount;
         std::string date;
         std::string description;
+        int orderId = -1;   // the order a revenue entry came from, else -1
     };
 
     Finance();
@@ -20,14 +22,53 @@ public:
     const std::vector<Transaction>& getTransactions() const;
 
     void recordExpense(double amount, const std::string& desc, const std::string& date = "");
-    void recordRevenue(double amount, const std::string& desc, const std::string& date = "");
+    void recordRevenue(double amount, const std::string& desc, const std::string& date = "", int orderId = -1);
+    // Appends many revenue entries at once (each entry's type is ignored).
+    // All amounts are checked before anything is recorded.
+    void recordRevenueBatch(const std::vector<Transaction>& entries);
     double calculateProfit() const;
     void generateReport() const;
 
+    // Totals over dated entries in [from, to] (YYYY-MM-DD, inclusive; blank
+    // leaves that end open). Entries dated "N/A" only count in all-time totals.
+    double getRevenueBetween(const std::string& from, const std::string& to) const;
+    double getExpensesBetween(const std::string& from, const std::string& to) const;
+    double calculateProfitBetween(const std::string& from, const std::string& to) const;
+    // Dated entries outside the indexed span, which range sums scan one by one
+    size_t outlierCount() const;
+
 private:
     double totalRevenue;
     double totalExpenses;
     std::vector<Transaction> transactions;
+
+    // Per-day cumulative checkpoints as Fenwick trees over day numbers
+    // [baseDay, baseDay + size). Appends and range sums are O(log days).
+    // The dated entries in the trees span at most kMaxTreeDays, so one
+    // far-off or mistyped date cannot allocate a huge tree: an entry that
+    // would stretch the span further is kept in a short outlier list
+    // instead, which range sums scan. The span is anchored on the first
+    // dated entry; once outliers outnumber the tree entries (a mistyped
+    // first date), the trees are rebuilt over the busiest span.
+    static constexpr int kMaxTreeDays = 36600;   // about a century
+    int baseDay;
+    int firstTreeDay;
+    int lastTreeDay;
+    size_t treeEntries;
+    size_t outlierLimit;   // outliers tolerated before another rebuild
+    std::vector<double> revenueTree;
+    std::vector<double> expenseTree;
+    std::vector<std::pair<int, double>> revenueOutliers;   // (day, amount)
+    std::vector<std::pair<int, double>> expenseOutliers;
+
+    void addToLedgerTree(std::vector<double>& tree, std::vector<std::pair<int, double>>& outliers,
+                         const std::string& date, double amount);
+    void ensureDayCovered(int day);
+    void rebuildLedgerTrees();
+    double rangeSum(const std::vector<double>& tree, const std::vector<std::pair<int, double>>& outliers,
+                    const std::string& from, const std::string& to) const;
+    static void treeAdd(std::vector<double>& tree, size_t pos, double amount);
+    static double treePrefix(const std::vector<double>& tree, size_t count);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,60 @@
+#ifndef FOLLOWER_H
+#define FOLLOWER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ChangeLog.h"
+#include "DataManager.h"
+
+// Replays a primary's change log (--cdc-log) into a local DataManager.
+//
+// When a primary starts its log it first saves its loaded state, archive
+// segments included, to basePath(log). A follower copies that base into its
+// own data directory and loads it from there, then applies each
+// non-derived event through the same DataManager mutation it came from,
+// so stock, ledger and customer histories are recomputed, not copied.
+// If the primary restarts (new log, new base), the follower reloads.
+class Follower {
+public:
+    Follower(DataManager& dm, std::string logPath, std::string dataDir);
+
+    static std::string basePath(const std::string& logPath);
+
+    // True when the log exists (the base is complete before it does).
+    bool logReady() const;
+    // Replaces dataDir's files with the base, loads them into the
+    // DataManager and starts reading the log.
+    void open();
+    bool isOpen() const;
+    // True when the primary restarted and open() must be called again.
+    bool needsResync() const;
+
+    // Reads up to `max` complete records; does not touch the DataManager.
+    size_t fetch(std::vector<ChangeEvent>& out, size_t max = 1024);
+    // Applies fetched events in order and returns how many changed state.
+    // Throws ReplicationException on a gap or an event that fails here.
+    size_t apply(const std::vector<ChangeEvent>& events);
+
+    uint64_t appliedSeq() const;   // sequence number of the last event applied
+    std::string status() const;    // e.g. "replica seq=42 log=/tmp/bms.cdc"
+
+    // Async-signal-safe; ends Application::runFollower's tail loop.
+    static void requestStop();
+    static bool stopRequested();
+
+private:
+    DataManager& dm;
+    std::string logPath;
+    std::string dataDir;
+    std::unique_ptr<ChangeLogReader> reader;
+    std::atomic<uint64_t> lastSeq;
+
+    void applyOne(const ChangeEvent& event);
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef INVOICEEXPORT_H
+#define INVOICEEXPORT_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Order.h"
+
+class DataManager;
+
+struct InvoiceExportStats {
+    size_t invoices = 0;
+    size_t bytes = 0;
+    unsigned workers = 0;
+};
+
+// Month-end invoice archive. Invoices are rendered with
+// Order::renderInvoice into per-worker buffers, in parallel once there are
+// enough of them, and come out in the order given. Archived orders keep no
+// items, so only live orders can be exported.
+class InvoiceExport {
+public:
+    // Finalized orders dated within [from, to] (inclusive, YYYY-MM-DD; blank
+    // leaves that end open), by order ID. Throws InvalidInputException for a
+    // malformed date.
+    static std::vector<const Order*> finalizedOrders(DataManager& dm, const std::string& from,
+                                                     const std::string& to);
+
+    // One file per invoice, DIR/invoice-<orderId>.txt. Creates DIR.
+    static InvoiceExportStats toDirectory(const std::vector<const Order*>& orders, const std::string& dir);
+
+    // All invoices in one file, plus PATH.idx listing each invoice's
+    // OrderId,Offset,Length in bytes. Creates the parent directory. Both
+    // files are written under a temporary name and renamed when complete.
+    static InvoiceExportStats toBundle(const std::vector<const Order*>& orders, const std::string& path);
+};
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef LATENCYSTATS_H
+#define LATENCYSTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <iosfwd>
+#include <string>
+
+// Latency of the operations cashiers wait on, kept for the whole process
+// and shown under About / Stats. Application::shutdown appends them to
+// <dataDir>/latency.csv.
+enum class LatencyOp : uint8_t {
+    ProductLookup,
+    AddItem,
+    Finalize,
+    PrintInvoice,
+    Save,
+    Count
+};
+
+const char* latencyOpName(LatencyOp op);
+
+// HDR-style log-linear histogram of nanosecond values. Values below 64 get
+// their own bucket; above that, each power of two is split into 32 buckets,
+// so a bucket's width is at most 1/32 of its lower bound (about 3%).
+// Values above 2^47 ns (39 hours) share the last bucket. Recording is a few
+// relaxed atomic adds and never blocks, so any thread can record while
+// another reads.
+class LatencyHistogram {
+public:
+    static const unsigned kSubBucketBits = 5;
+    static const unsigned kSubBuckets = 1u << kSubBucketBits;
+    static const unsigned kMaxExponent = 47;
+    static const size_t kBuckets = (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+
+    void record(int64_t ns);
+
+    uint64_t count() const;
+    int64_t max() const;
+    double mean() const;
+    // Upper bound of the bucket holding the q-quantile (0 < q <= 1), capped
+    // at the largest value seen. 0 when empty.
+    int64_t percentile(double q) const;
+
+    static size_t bucketOf(int64_t ns);
+    static int64_t bucketUpperBound(size_t bucket);
+
+private:
+    std::atomic<uint64_t> buckets[kBuckets] = {};
+    std::atomic<uint64_t> total{0};
+    std::atomic<int64_t> sum{0};
+    std::atomic<int64_t> largest{0};
+};
+
+class LatencyStats {
+public:
+    static LatencyHistogram& histogram(LatencyOp op);
+
+    // One row per operation: count, mean, p50, p99, p99.9, max
+    static void print(std::ostream& out);
+    // Appends one CSV row per operation that ran, stamped with the current
+    // local time; writes a header when the file is new. Throws
+    // FileOperationException.
+    static void appendCsv(const std::string& path);
+};
+
+// Records the time from construction to destruction under `op`. Operations
+// that end in an exception are not recorded.
+class LatencyTimer {
+public:
+    explicit LatencyTimer(LatencyOp op)
+        : op(op), exceptions(std::uncaught_exceptions()), start(std::chrono::steady_clock::now()) {}
+    ~LatencyTimer() {
+        if (std::uncaught_exceptions() > exceptions) return;
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        LatencyStats::histogram(op).record(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+    LatencyTimer(const LatencyTimer&) = delete;
+    LatencyTimer& operator=(const LatencyTimer&) = delete;
+
+private:
+    LatencyOp op;
+    int exceptions;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef MEMORYSTATS_H
+#define MEMORYSTATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Estimated footprint of one in-memory collection. `bytes` counts the
+// objects themselves, what they own on the heap (string payloads past the
+// small-string buffer, nested vectors) and unused vector capacity; `slack`
+// is the unused-capacity part of it.
+struct MemoryUsage {
+    std::string name;
+    size_t objects = 0;
+    size_t bytes = 0;
+    size_t slack = 0;
+};
+
+struct MemoryReport {
+    std::vector<MemoryUsage> collections;
+
+    size_t totalBytes() const;
+    size_t totalSlack() const;
+    void print(std::ostream& out) const;
+};
+
+// Sizing helpers for the accounting walk
+namespace memsize {
+// Heap bytes behind a string (0 while it fits the small-string buffer)
+size_t heap(const std::string& s);
+
+template<typename T>
+size_t heap(const std::vector<T>& v) { return v.capacity() * sizeof(T); }
+
+template<typename T>
+size_t slack(const std::vector<T>& v) { return (v.capacity() - v.size()) * sizeof(T); }
+
+// Bucket array plus one node (next pointer, cached hash, value) per entry
+template<typename K, typename V>
+size_t heap(const std::unordered_map<K, V>& m) {
+    return m.bucket_count() * sizeof(void*) + m.size() * (2 * sizeof(void*) + sizeof(std::pair<const K, V>));
+}
+} // namespace memsize
+
+// Optional live-heap attribution. Built with BMS_TRACK_ALLOCATIONS, the
+// global operator new/delete pair is replaced: every block carries a small
+// header with its size and the subsystem that was current on the allocating
+// thread, and per-subsystem counters are updated with relaxed atomics. The
+// cost is one thread-local read and two uncontended adds per call, plus
+// 16 bytes per block. Without the flag, scopes compile to a byte store and
+// heapUsage() reports tracking as off.
+enum class MemSubsystem : uint8_t {
+    Other,
+    Products,
+    Customers,
+    Orders,
+    Ledger,
+    Indexes,
+    Snapshots,
+    Count
+};
+
+const char* memSubsystemName(MemSubsystem subsystem);
+
+// Attributes allocations on this thread to `subsystem` until destroyed.
+class MemoryScope {
+public:
+    explicit MemoryScope(MemSubsystem subsystem);
+    ~MemoryScope();
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemSubsystem previous;
+};
+
+struct HeapUsage {
+    bool tracking = false;
+    size_t liveBytes[static_cast<size_t>(MemSubsystem::Count)] = {};
+    size_t liveBlocks[static_cast<size_t>(MemSubsystem::Count)] = {};
+    uint64_t allocations[static_cast<size_t>(MemSubsystem::Count)] = {};   // since start
+
+    void print(std::ostream& out) const;
+};
+
+HeapUsage heapUsage();
+
+#endif
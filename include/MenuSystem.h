@@ -1,11 +1,20 @@
 #ifndef MENUSYSTEM_H
 #define MENUSYSTEM_H
 
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
 #include "DataManager.h"
+#include "ReportCache.h"
+#include "TableRenderer.h"
 
 class MenuSystem {
 private:
     DataManager& dm;
+    std::string dataDir;
+    ReportCache reportCache;
 
     // Helpers
     static void clearInput();
@@ -16,6 +25,12 @@ private:
     static int getIntInput(const std::string& prompt, int min, int max);
     static double getDoubleInput(const std::string& prompt, double min, double max);
     static std::string getStringInput(const std::string& prompt);
+    static bool readOptionalInt(const char* prompt, int& out);       // blank -> false
+    static bool readOptionalDouble(const char* prompt, double& out); // blank -> false
+
+    // List screens show this many rows, then ask for the next page
+    static const size_t kListPageRows = 50;
+    static void pageTable(const TableRenderer& table, size_t rowCount, const TableRenderer::RowFn& row);
 
     // Menus
     void inventoryMenu();
@@ -23,6 +38,7 @@ private:
     void orderMenu();
     void financeMenu();
     void reportsMenu();
+    void aboutMenu();
 
     // Inventory actions
     void addProduct();
@@ -33,7 +49,8 @@ private:
     void removeProduct();
     void listProducts();
     void lowStockAlert();
-    void inventoryValuationReport();
+    void replenishmentProposal();
+    void inventoryValuationReport(std::ostream& out);
 
     // Customer actions
     void addRegularCustomer();
@@ -41,14 +58,18 @@ private:
     void listCustomers();
     void viewCustomerDetails();
     void upgradeCustomerToPremium();
-    void topCustomersReport();
+    void topCustomersReport(std::ostream& out);
 
     // Order actions
     void createOrder();
     void listOrders();
     void viewOrderDetails();
     void addItemToOrder();
+    void removeItemFromOrder();
     void finalizeOrder();
+    void finalizePendingOrders();
+    void searchOrders();
+    void exportInvoices();
 
     // Finance actions
     void showRevenueSummary();
@@ -56,14 +77,43 @@ private:
     void showProfitLossReport();
     void showFinanceSummary();
     void listTransactions();
-    void bestSellingProductsReport();
-    void riskInventoryReport();
-    void monthlySalesReport();
-    void smartRiskReport();
+    void searchTransactions();
+    void bestSellingProductsReport(std::ostream& out);
+    void riskInventoryReport(std::ostream& out);
+    void monthlySalesReport(std::ostream& out);
+    void smartRiskReport(std::ostream& out);
+    void velocityRiskReport();
+    void renderVelocityRisk(std::ostream& out, int asOfDay, int window);
+    void approximateAnalyticsReport();
+    void rfmSegmentationReport();
+
+    // Report caching: renders through `render` unless a fresh entry exists
+    void showReport(const std::string& key, unsigned deps,
+                    const std::function<void(std::ostream&)>& render);
+    void reportCacheStats();
+
+    // The non-interactive reports, by cache key
+    struct NamedReport {
+        const char* name;
+        void (MenuSystem::*render)(std::ostream&);
+    };
+    static const std::vector<NamedReport>& namedReports();
+
+    // About / Stats
+    void memoryUsageReport();
+    // Product by a typed-in ID, timed as LatencyOp::ProductLookup
+    Product* lookupProduct(int productId);
 
 public:
-    explicit MenuSystem(DataManager& dm);
-    void mainLoop();
+    explicit MenuSystem(DataManager& dm, std::string dataDir = "data");
+    // `onFirstMenu` runs once, right after the main menu is first shown
+    void mainLoop(const std::function<void()>& onFirstMenu = nullptr);
+
+    // Renders a non-interactive report ("best-selling", "risk-inventory",
+    // "top-customers", "inventory-valuation", "monthly-sales", "smart-risk")
+    // without the cache. Returns false for an unknown name.
+    bool renderReport(const std::string& name, std::ostream& out);
+    static std::vector<std::string> reportNames();
 };
 
 #endif
\ No newline at end of file
@@ -1,9 +1,11 @@
 #ifndef ORDER_H
 #define ORDER_H
 
+#include <atomic>
 #include <vector>
 #include <string>
 #include <utility>   // for std::pair
+#include <functional>
 
 #include "Product.h"
 #include "Customer.h"
@@ -18,20 +20,36 @@ private:
     std::vector<std::pair<Product*, int>> items;
     std::string date;
     double totalAmount;
-    bool isFinalized;
+    std::atomic<bool> isFinalized;   // read before finalize() takes its lock
 
 public:
     // Constructor
     Order(int orderId, Customer* customer, const std::string& date);
+    Order(const Order& other);
+    Order(Order&& other) noexcept;
+    Order& operator=(const Order& other);
+    Order& operator=(Order&& other) noexcept;
 
     // Core operations
     void addItem(Product* product, int quantity);
     void addLoadedItem(Product* product, int quantity); // Used only by persistence loader
+    void reserveItems(size_t count);                    // Used only by persistence loader
     void removeItem(Product* product);
     double calculateTotal();                  // Calculates subtotal (no discount)
-    void finalize(Finance& finance);          // Applies discount + updates stock + records revenue
+    // Applies discount + updates stock + records revenue. Stock is taken
+    // all-or-nothing, and different orders may finalize from different threads.
+    // If several threads finalize the same order, exactly one succeeds; the
+    // others throw InvalidInputException and put their stock back.
+    void finalize(Finance& finance);
+    // The two halves of finalize() without stock or ledger, for callers that
+    // apply those in bulk: finalTotal() runs the same checks and returns the
+    // discounted total; markFinalized() records it and locks the order.
+    double finalTotal() const;
+    void markFinalized(double total);
     void setFinalized(bool v);
     void printInvoice() const;
+    // Appends the text printInvoice() shows; safe to call from several threads
+    void renderInvoice(std::string& out) const;
 
     // Getters
     int getOrderId() const;
@@ -42,6 +60,9 @@ public:
     bool getIsFinalized() const;
     // Setters
     void setTotalAmount(double amount);
+    void setCustomer(Customer* c);      // rebinding after a customer object is replaced
+    // Re-targets item pointers after the product storage moved or shifted.
+    void relinkProducts(const std::function<Product*(Product*)>& remap);
 
     // Optional helper
     void display() const;
@@ -0,0 +1,83 @@
+#ifndef ORDERARCHIVE_H
+#define ORDERARCHIVE_H
+
+#include <climits>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Order.h"
+
+struct ArchivedOrder {
+    int orderId;
+    int customerId;   // -1 for guest orders
+    std::string date;
+    double total;
+    std::vector<std::pair<int, int>> items;   // (productId, qty)
+};
+
+struct ArchivedCustomerTotals {
+    int orders = 0;
+    double spent = 0.0;
+    int lastDay = INT_MIN;   // day number of the latest archived order
+};
+
+// Cold tier for finalized orders that will not change again:
+//
+//   <dataDir>/archive/segment-<n>.arc   one per archive run, never rewritten
+//
+// A segment starts with summaries of its orders: units per product, orders,
+// spend and last purchase per customer, revenue per month, and the archived
+// order IDs. The orders follow in a compact binary form: sorted IDs and
+// dates as varint deltas, amounts in cents, items as varint pairs. Loading
+// reads only the summaries; the orders themselves are decoded on request.
+//
+// Amounts are kept in whole cents, which is finer than orders.txt keeps them.
+class OrderArchive {
+public:
+    // Reads the summaries of every segment under dataDir/archive. A missing
+    // archive directory is an empty archive.
+    void load(const std::string& dataDir);
+    void clear();
+
+    // Writes the orders (finalized, with parseable dates) as a new segment
+    // under dataDir/archive and adds them to the summaries. The segment is
+    // written to a temporary name and renamed into place.
+    void append(const std::string& dataDir, const std::vector<const Order*>& orders);
+
+    bool contains(int orderId) const;
+    bool findOrder(int orderId, ArchivedOrder& out) const;   // decodes its segment
+    std::vector<ArchivedOrder> readOrders() const;           // every segment, in ID order per segment
+
+    size_t orderCount() const;
+    size_t segmentCount() const;
+    double revenue() const;
+    int lastDay() const;   // latest archived order date, INT_MIN when empty
+
+    const std::unordered_map<int, long long>& unitsByProduct() const;
+    const std::unordered_map<int, ArchivedCustomerTotals>& customerTotals() const;
+    const std::map<std::string, double>& revenueByMonth() const;   // "YYYY-MM"
+
+private:
+    struct Segment {
+        std::string path;
+        int firstId;
+        int lastId;
+    };
+
+    std::vector<Segment> m_segments;
+    std::vector<int> m_orderIds;   // sorted
+    long long m_revenueCents = 0;
+    int m_lastDay = INT_MIN;
+    std::unordered_map<int, long long> m_units;
+    std::unordered_map<int, ArchivedCustomerTotals> m_customers;
+    std::map<std::string, double> m_months;
+
+    void readSegment(const std::string& path);
+    static std::vector<ArchivedOrder> decodeOrders(const std::string& path);
+};
+
+#endif
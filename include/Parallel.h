@@ -0,0 +1,41 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Number of workers worth starting for `count` items, keeping at least
+// `minPerWorker` items per worker so tiny inputs stay single-threaded.
+inline unsigned parallelWorkerCount(size_t count, size_t minPerWorker = 4096) {
+    unsigned hw = std::thread::hardware_concurrency();
+    if (hw == 0) hw = 1;
+    const size_t byWork = std::max<size_t>(1, count / std::max<size_t>(1, minPerWorker));
+    return static_cast<unsigned>(std::min<size_t>(hw, byWork));
+}
+
+// Splits [0, count) into `workers` contiguous ranges and runs
+// fn(begin, end, workerIndex) for each one, on its own thread.
+template<typename Fn>
+void parallelFor(size_t count, unsigned workers, Fn fn) {
+    if (workers <= 1 || count == 0) {
+        fn(size_t{0}, count, 0u);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+
+    const size_t chunk = (count + workers - 1) / workers;
+    for (unsigned w = 1; w < workers; ++w) {
+        const size_t begin = std::min(count, w * chunk);
+        const size_t end = std::min(count, begin + chunk);
+        threads.emplace_back([=, &fn]() { fn(begin, end, w); });
+    }
+    fn(size_t{0}, std::min(count, chunk), 0u);
+
+    for (auto& t : threads) t.join();
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef PRODUCT_H
 #define PRODUCT_H
 
+#include <atomic>
 #include <string>
 #include <iostream>
 #include <vector>
@@ -9,6 +10,10 @@ class Product {
 public:
     Product();
     Product(int id, const std::string &name, double price, double cost, int quantity);
+    Product(const Product& other);
+    Product(Product&& other) noexcept;   // keeps vector growth from copying names
+    Product& operator=(const Product& other);
+    Product& operator=(Product&& other) noexcept;
 
     int getId() const;
     const std::string &getName() const;
@@ -25,6 +30,10 @@ public:
     void setQuantity(int quantity);
 
     void updateStock(int qty);
+    // Lock-free stock reservation: tryReserve takes qty out with a CAS loop
+    // (false, untouched, if fewer are on hand); releaseReserved puts it back.
+    bool tryReserve(int qty);
+    void releaseReserved(int qty);
     double calculateProfit() const;
     std::string toString() const;
 
@@ -41,7 +50,7 @@ private:
     std::string name;
     double price;
     double cost;
-    int quantity;
+    std::atomic<int> quantity;   // the only field changed while orders finalize in parallel
 };
 
 #endif
@@ -0,0 +1,111 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <climits>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Order.h"
+#include "Customer.h"
+#include "Finance.h"
+
+// ---------------- Order queries ----------------
+
+enum class CustomerTier { Any, Regular, Premium };
+enum class OrderSortKey { Id, Date, Total, Customer };
+
+// Every field defaults to "no constraint".
+struct OrderQuery {
+    int orderId = -1;
+    std::string fromDate;          // inclusive, YYYY-MM-DD
+    std::string toDate;            // inclusive, YYYY-MM-DD
+    int customerId = -1;
+    CustomerTier tier = CustomerTier::Any;
+    int productId = -1;
+    double minTotal = -1.0;        // ignored when negative
+    double maxTotal = -1.0;        // ignored when negative
+    int finalized = -1;            // -1 any, 0 pending, 1 finalized
+
+    OrderSortKey sortBy = OrderSortKey::Id;
+    bool descending = false;
+    size_t offset = 0;
+    size_t limit = 0;              // 0 = no limit
+};
+
+struct QueryResult {
+    std::vector<size_t> rows;      // positions in the source vector, in result order
+    size_t matched = 0;            // matches before offset/limit
+    std::string accessPath;        // "id-index", "date-index" or "full-scan"
+};
+
+// Columnar copy of the order list (one compact array per field) plus an
+// ID index and a date index. Rows are positions in DataManager::orders().
+// Appended orders are picked up by sync(); in-place edits (items added,
+// finalization) must be reported through refreshRow().
+class OrderIndex {
+public:
+    void rebuild(const std::vector<Order>& orders);
+    void sync(const std::vector<Order>& orders);
+    void refreshRow(const std::vector<Order>& orders, size_t row);
+
+    long findRow(int orderId) const;   // -1 if missing
+    size_t size() const;
+    size_t memoryBytes() const;        // heap held by the columns and indexes
+
+    QueryResult run(const OrderQuery& q, const std::vector<Customer*>& customers) const;
+
+private:
+    std::vector<int> m_id;
+    std::vector<int> m_customer;
+    std::vector<int> m_day;            // INT_MIN when the date does not parse
+    std::vector<double> m_total;
+    std::vector<uint8_t> m_finalized;
+    std::vector<uint32_t> m_itemStart; // slice of m_itemProducts per row
+    std::vector<uint32_t> m_itemCount;
+    std::vector<int> m_itemProducts;
+    size_t m_deadItems = 0;            // stale slices left behind by edits
+
+    std::unordered_map<int, size_t> m_byId;
+    std::vector<size_t> m_byDay;       // rows ordered by (day, row)
+
+    void appendRow(const Order& o);
+    void writeItems(const Order& o, size_t row);
+    void compactItems();
+    void indexDay(size_t row);
+};
+
+// ---------------- Ledger queries ----------------
+
+enum class LedgerSortKey { Position, Date, Amount };
+
+struct LedgerQuery {
+    std::string fromDate;
+    std::string toDate;
+    std::string type;              // "Revenue", "Expense" or blank for both
+    double minAmount = -1.0;
+    double maxAmount = -1.0;
+
+    LedgerSortKey sortBy = LedgerSortKey::Position;
+    bool descending = false;
+    size_t offset = 0;
+    size_t limit = 0;
+};
+
+// The ledger is append-only, so sync() only ever needs to index the tail.
+class LedgerIndex {
+public:
+    void clear();
+    void sync(const Finance& finance);
+    QueryResult run(const LedgerQuery& q) const;
+    size_t memoryBytes() const;
+
+private:
+    std::vector<int> m_day;
+    std::vector<double> m_amount;
+    std::vector<uint8_t> m_revenue;
+    std::vector<size_t> m_byDay;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef REPLENISHMENT_H
+#define REPLENISHMENT_H
+
+#include <string>
+#include <vector>
+
+#include "DataManager.h"
+
+struct ReplenishmentPolicy {
+    int leadTimeDays = 7;     // supplier delivery time
+    int safetyDays = 3;       // buffer on top of lead-time demand
+    int reviewDays = 14;      // demand to cover until the next review
+    int velocityWindow = 30;  // days of history behind the daily velocity
+};
+
+struct ReorderLine {
+    int productId;
+    int onHand;
+    double dailyVelocity;
+    int reorderPoint;
+    int orderQty;
+    double lineCost;
+};
+
+struct PurchaseProposal {
+    std::string date;
+    std::vector<ReorderLine> lines;
+    double totalCost = 0.0;
+};
+
+// Reorder point = velocity * (lead time + safety days).
+// Order-up-to level = velocity * (lead time + safety + review days).
+class ReplenishmentPlanner {
+public:
+    // Recomputes every product's reorder point into dm.stockIndex(), then
+    // proposes orders for the products that reached it.
+    static PurchaseProposal plan(DataManager& dm, const ReplenishmentPolicy& policy, int asOfDay);
+
+    // One restock pass and a single aggregated ledger entry.
+    static double apply(DataManager& dm, const PurchaseProposal& proposal);
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef REPORTCACHE_H
+#define REPORTCACHE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// Mutation counters bumped by DataManager, one per collection.
+struct DataEpochs {
+    uint64_t products = 0;
+    uint64_t customers = 0;
+    uint64_t orders = 0;
+    uint64_t ledger = 0;
+};
+
+// Which epochs a cached report depends on.
+enum ReportDependency : unsigned {
+    DependsOnProducts  = 1u << 0,
+    DependsOnCustomers = 1u << 1,
+    DependsOnOrders    = 1u << 2,
+    DependsOnLedger    = 1u << 3
+};
+
+// Rendered report text keyed by report name + parameters. An entry stays
+// valid while every epoch it depends on is unchanged.
+class ReportCache {
+public:
+    explicit ReportCache(size_t maxEntries = 64);
+
+    // nullptr on a miss (absent or stale entry)
+    const std::string* lookup(const std::string& key, const DataEpochs& now);
+    void store(const std::string& key, unsigned deps, const DataEpochs& now, std::string text);
+    void clear();
+
+    uint64_t hits() const;
+    uint64_t misses() const;
+    size_t size() const;
+
+private:
+    struct Entry {
+        unsigned deps;
+        DataEpochs epochs;
+        std::string text;
+    };
+
+    size_t maxEntries;
+    std::unordered_map<std::string, Entry> entries;
+    uint64_t hitCount = 0;
+    uint64_t missCount = 0;
+
+    static bool isFresh(const Entry& e, const DataEpochs& now);
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef RESERVATIONS_H
+#define RESERVATIONS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Stock held by open (unfinalized) orders. available = on-hand - reserved.
+//
+// Each (order, product) line holds one reservation that expires `ttl`
+// seconds after it was last touched. Expiry is driven by a timer wheel with
+// one-second slots: a reservation is filed under the slot of its deadline,
+// and advance() only visits the slots that have come due. Released or
+// refreshed lines leave a stale wheel entry behind, which is recognised by
+// its generation and dropped when its slot comes up, so reserve/release stay
+// O(1). Reservations are not persisted; orders loaded from disk hold none.
+class ReservationLedger {
+public:
+    struct Expired {
+        int orderId;
+        int productId;
+        int qty;
+    };
+
+    explicit ReservationLedger(int ttlSeconds = 15 * 60, size_t wheelSlots = 1024);
+
+    void setTtl(int seconds);
+    int ttl() const;
+
+    // Adds qty to the order's hold on productId and restarts its TTL.
+    void reserve(int orderId, int productId, int qty, int64_t now);
+    // Drops the order's hold on productId; returns the quantity released.
+    int release(int orderId, int productId);
+    // Drops every hold of the order (finalized or abandoned).
+    int releaseOrder(int orderId);
+
+    // Expires everything due at `now` (seconds on a monotonic clock).
+    std::vector<Expired> advance(int64_t now);
+
+    int reserved(int productId) const;
+    int reservedFor(int orderId, int productId) const;
+    size_t size() const;
+    void clear();
+
+private:
+    struct Hold {
+        int qty;
+        int64_t expiresAt;
+        uint64_t generation;
+    };
+    struct WheelEntry {
+        int orderId;
+        int productId;
+        uint64_t generation;
+    };
+
+    int m_ttl;
+    std::vector<std::vector<WheelEntry>> m_wheel;
+    int64_t m_lastTick;          // last slot processed by advance()
+    uint64_t m_nextGeneration;
+
+    std::unordered_map<int, std::unordered_map<int, Hold>> m_holds;  // orderId -> productId -> hold
+    std::unordered_map<int, int> m_reserved;                         // productId -> total held
+    size_t m_count;
+
+    void schedule(int orderId, int productId, const Hold& hold);
+    void unreserve(int productId, int qty);
+};
+
+#endif
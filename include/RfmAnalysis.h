@@ -0,0 +1,42 @@
+#ifndef RFMANALYSIS_H
+#define RFMANALYSIS_H
+
+#include <string>
+#include <vector>
+
+#include "Customer.h"
+#include "Order.h"
+#include "OrderArchive.h"
+
+// Recency / Frequency / Monetary segmentation over finalized orders.
+struct RfmRow {
+    int customerId;
+    int recencyDays;     // days since last purchase as of the report date
+    int frequency;       // finalized orders
+    double monetary;     // total spent
+    int r, f, m;         // quintile scores 1..5 (0 when the customer never bought)
+    const char* segment;
+};
+
+struct RfmCutoffs {
+    // 20/40/60/80th percentile values among customers with purchases
+    double recency[4];
+    double frequency[4];
+    double monetary[4];
+};
+
+class RfmAnalysis {
+public:
+    // One row per customer, in dm.customers() order. Aggregation runs in
+    // parallel over orders; each dimension's cutoffs are selected in parallel.
+    // Archived totals are added when the whole archive predates asOfDay.
+    static std::vector<RfmRow> compute(const std::vector<Customer*>& customers,
+                                       const std::vector<Order>& orders,
+                                       int asOfDay,
+                                       RfmCutoffs* cutoffsOut = nullptr,
+                                       const OrderArchive* archive = nullptr);
+
+    static const char* segmentFor(int r, int f, int m);
+};
+
+#endif
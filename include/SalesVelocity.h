@@ -0,0 +1,58 @@
+#ifndef SALESVELOCITY_H
+#define SALESVELOCITY_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Order.h"
+
+// Per-product daily sales buckets stored as prefix sums, so "units sold
+// between two days" is two array reads instead of a scan over every order.
+// A product's buckets span at most kMaxSeriesDays. A sale that would
+// stretch them further, such as one with a mistyped year, goes to a short
+// outlier list that range queries scan. When outliers outnumber the
+// bucketed sales, the buckets move to the busiest span.
+class SalesVelocity {
+public:
+    void clear();
+
+    // Bulk build from finalized orders (used after loading history).
+    void rebuild(const std::vector<Order>& orders);
+
+    // Incremental update for a freshly finalized order.
+    void recordOrder(const Order& order);
+    void recordSale(int productId, int day, int qty);
+
+    // Units sold in the inclusive day range [fromDay, toDay]. O(1).
+    long long unitsSold(int productId, int fromDay, int toDay) const;
+    // Units sold in the `days` days ending at asOfDay (inclusive).
+    long long unitsInLastDays(int productId, int asOfDay, int days) const;
+    // Average units per day over the same window.
+    double dailyVelocity(int productId, int asOfDay, int days) const;
+
+private:
+    static constexpr int kMaxSeriesDays = 3660;   // about ten years
+
+    struct Series {
+        int firstDay = 0;
+        // prefix[i] = units sold in [firstDay, firstDay + i]
+        std::vector<long long> prefix;
+        int minDay = 0;          // earliest and latest bucketed sale
+        int maxDay = 0;
+        size_t sales = 0;        // bucketed sales
+        std::vector<std::pair<int, long long>> outliers;   // (day, units)
+        size_t outlierLimit = 0; // outliers tolerated before another rebuild
+    };
+
+    std::unordered_map<int, Series> m_series;
+
+    static long long cumulative(const Series& s, int day);
+    // Rebuilds `s` from (day, units) points sorted by day, bucketing the
+    // busiest kMaxSeriesDays span
+    static void build(Series& s, const std::vector<std::pair<int, long long>>& points);
+    static void reanchor(Series& s);
+};
+
+#endif
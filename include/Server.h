@@ -0,0 +1,138 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DataManager.h"
+#include "BatchRunner.h"
+
+struct ServerOptions {
+    std::string endpoint;        // "unix:/path/to.sock" or "tcp:PORT" (127.0.0.1 only)
+    unsigned workers = 0;        // 0 = one per hardware thread
+    size_t commitEvery = 1000;   // save after this many writes (0 = only on shutdown)
+};
+
+// Lets a replica (see Follower) be served read-only until it is promoted.
+struct ReplicaHooks {
+    std::function<std::string()> status;   // one line for the `role` request
+    std::function<void()> promote;         // stop following; called without the data lock
+};
+
+// Line-based request/response server over DataManager (POSIX only).
+//
+// Each request is one line. Each response is a status line, "OK <n>" followed
+// by n payload lines, or "ERR <message>". Requests on one connection are
+// answered in order; different connections are served in parallel.
+//
+//   reads:  ping | product <id> | customer <id> | order <id>
+//           query-orders [key=value ...]          (see BatchRunner)
+//           report finance [from] [to] | report low-stock <threshold>
+//           report top-products [n]               (from a snapshot, lock-free)
+//           role                                  (primary, or replica status)
+//   writes: create-order | add-item | remove-item | finalize | finalize-batch | restock | expense
+//           commit                                (waits until saved)
+//           promote                               (replica only: start accepting writes)
+//
+// A single I/O thread polls all sockets and hands complete lines to a worker
+// pool. Reads run concurrently under a shared lock; writes take it
+// exclusively, so they are serialized. Every write publishes a new
+// DataManager snapshot; saves and snapshot reports work from a pinned
+// version on their own thread, so they never hold up order entry.
+class Server {
+public:
+    Server(DataManager& dm, std::string dataDir, ServerOptions options);
+    ~Server();
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    // Blocks until requestStop() is called.
+    void run();
+
+    // Async-signal-safe; stops whichever server is running.
+    static void requestStop();
+
+    // Runs `mutate` like a write request: exclusively, then publishes a
+    // snapshot and counts `mutate`'s return value towards commitEvery. For
+    // writers that do not come through a socket, such as replication.
+    void applyWrite(const std::function<size_t()>& mutate);
+    // Saves the current version and waits for it. Returns false on failure,
+    // and without saving once the change log has stopped.
+    bool commit();
+
+    // Rejects write requests until a `promote` request runs hooks.promote.
+    void attachReplica(ReplicaHooks hooks);
+
+    size_t requestsServed() const;
+
+private:
+    struct Job {
+        uint64_t connection;
+        std::string line;
+    };
+    struct Completion {
+        uint64_t connection;
+        std::string response;
+    };
+
+    DataManager& dm;
+    std::string dataDir;
+    ServerOptions options;
+    BatchRunner runner;
+
+    std::shared_mutex dataMutex;     // readers shared, writers exclusive
+    size_t pendingWrites;            // guarded by dataMutex (exclusive)
+
+    ReplicaHooks replica;
+    std::atomic<bool> readOnly;
+    std::mutex promoteMutex;         // one promotion at a time
+
+    std::mutex jobMutex;
+    std::condition_variable jobReady;
+    std::deque<Job> jobs;
+    bool stopping;
+
+    std::mutex doneMutex;
+    std::vector<Completion> done;
+
+    std::vector<std::thread> workers;
+
+    // Background saver: always writes the newest queued snapshot
+    std::thread saver;
+    std::mutex saveMutex;
+    std::condition_variable saveCv;
+    SnapshotPtr saveQueued;
+    uint64_t savedVersion;           // newest version a save was attempted for
+    bool lastSaveOk;
+    bool saverStop;
+    std::atomic<size_t> served;
+
+    int listenFd;
+    int wakeFds[2];
+    std::string unixPath;
+
+    void openListener();
+    void closeAll();
+    void workerLoop();
+    void saverLoop();
+    void queueSave(SnapshotPtr snapshot);
+    bool waitSaved(uint64_t version);
+    void submit(uint64_t connection, std::string line);
+
+    std::string handle(const std::string& line);
+    void handleRead(const std::string& cmd, std::istream& args, const std::string& line,
+                    std::ostream& out);
+    void topProducts(const Snapshot& snapshot, std::istream& args, std::ostream& out);
+};
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef SHARDROUTER_H
+#define SHARDROUTER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "BatchRunner.h"
+#include "DataManager.h"
+
+// Which shard owns a customer (and with it the customer's orders).
+// Stored as `shards.txt` in the shard root:
+//
+//   hash <n>                        customerId mod n
+//   range <n> <max0> ... <max n-2>  shard i holds IDs up to max i; the last
+//                                   shard holds everything above
+class ShardMap {
+public:
+    static ShardMap byHash(size_t shards);
+    static ShardMap byRange(std::vector<int> upperBounds);   // n-1 ascending bounds
+    // Ranges with about the same number of the given customers in each
+    static ShardMap balancedRanges(std::vector<int> customerIds, size_t shards);
+
+    static ShardMap load(const std::string& filepath);
+    void save(const std::string& filepath) const;
+
+    size_t shardOf(int customerId) const;
+    size_t size() const;
+
+private:
+    size_t count = 1;
+    bool ranged = false;
+    std::vector<int> upperBounds;
+};
+
+// One partition: its own DataManager and data directory, driven by one
+// worker thread. Everything that touches the DataManager runs as a task on
+// that thread, in submission order, so shards never need a data lock.
+class Shard {
+public:
+    explicit Shard(std::string dataDir);
+    ~Shard();   // runs the queued tasks, then stops
+
+    Shard(const Shard&) = delete;
+    Shard& operator=(const Shard&) = delete;
+
+    const std::string& dataDir() const;
+
+    template<typename Fn>
+    auto submit(Fn fn) -> std::future<decltype(fn(std::declval<DataManager&>(), std::declval<BatchRunner&>()))> {
+        using Result = decltype(fn(std::declval<DataManager&>(), std::declval<BatchRunner&>()));
+        auto task = std::make_shared<std::packaged_task<Result()>>(
+            [this, fn = std::move(fn)]() mutable { return fn(dm, runner); });
+        std::future<Result> result = task->get_future();
+        post([task] { (*task)(); });
+        return result;
+    }
+
+private:
+    std::string dir;
+    DataManager dm;
+    BatchRunner runner;
+
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::deque<std::function<void()>> queue;
+    bool stopping;
+    std::thread worker;
+
+    void post(std::function<void()> task);
+    void loop();
+};
+
+// Runs batch commands (see BatchRunner) over a set of shards:
+//
+//   root/shards.txt     the ShardMap
+//   root/shard-<i>/     a regular data directory per shard
+//
+// Customers and their orders and revenue live on exactly one shard; every
+// shard holds a full copy of the products. Order commands go to the owning
+// shard and run there in parallel with the other shards. The router-wide
+// stock count is the authority: a restock or finalization changes it and
+// leaves the change in every other shard's stock mailbox. A shard applies
+// its mailbox before it finalizes, so its copy matches the count at that
+// moment, and the copies all agree once the queues drain. Expenses,
+// including the cost of restocks, are booked on shard 0. Queries and
+// reports (`report finance|top-products|top-customers`) gather from all
+// shards in parallel.
+//
+// Commands for one customer keep their order; commands for different
+// shards may complete in any order relative to each other.
+class ShardRouter {
+public:
+    explicit ShardRouter(std::string root, size_t commitEvery = 1000);
+    ~ShardRouter();
+
+    ShardRouter(const ShardRouter&) = delete;
+    ShardRouter& operator=(const ShardRouter&) = delete;
+
+    // Writes `source` as a shard root laid out by `map`.
+    static void split(DataManager& source, const std::string& root, const ShardMap& map);
+
+    BatchStats run(std::istream& in, std::ostream& out, std::ostream& err);
+    // Waits for everything in flight, then saves every shard in parallel.
+    void commit();
+
+    size_t shardCount() const;
+
+private:
+    struct InFlight {
+        size_t line;
+        std::future<std::string> output;
+        bool mutates;
+        int createdOrder;   // router entry to undo if the create fails
+    };
+
+    std::string root;
+    size_t commitEvery;
+    ShardMap map;
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    std::unordered_map<int, size_t> orderShard;   // router thread only
+
+    // Router-wide stock count. A shard's copy plus the deltas waiting in
+    // its mailbox always equals it.
+    std::mutex stockMutex;
+    std::unordered_map<int, int> stock;
+    std::vector<std::vector<std::pair<int, int>>> pendingStock;   // per shard
+
+    std::deque<InFlight> inFlight;
+    BatchStats stats;
+    size_t pending;
+
+    std::future<std::string> dispatch(const std::string& line, bool& mutates, int& createdOrder);
+    void retire(std::ostream& out, std::ostream& err);
+    void drain(std::ostream& out, std::ostream& err);
+    size_t ownerOf(int orderId) const;
+
+    // Both require stockMutex to be held
+    void postStock(size_t shard, const std::vector<std::pair<int, int>>& deltas);
+    void applyPendingStock(size_t shard, DataManager& dm);
+
+    // Runs on the owning shard's thread
+    void finalizeOn(size_t shard, DataManager& dm, int orderId);
+    std::future<std::string> finalizeBatch(const std::vector<int>& ids);
+    std::future<std::string> restock(int productId, int qty, const std::string& date);
+    std::future<std::string> queryOrders(std::istream& args);
+    std::future<std::string> report(std::istream& args);
+};
+
+#endif
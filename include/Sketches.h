@@ -0,0 +1,129 @@
+#ifndef SKETCHES_H
+#define SKETCHES_H
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Order.h"
+
+// Fixed-memory probabilistic summaries for very large order histories.
+// Every sketch here is mergeable. HyperLogLog and Count-Min merges are
+// exact: building per thread (or per data directory) and merging gives the
+// same registers and counters as one sequential build. HeavyHitters is not
+// (see below).
+
+// Distinct counting. Standard error is 1.04 / sqrt(2^precision):
+// precision 12 -> 4 KiB, ~1.6%; precision 8 -> 256 B, ~6.5%.
+class HyperLogLog {
+public:
+    explicit HyperLogLog(int precision = 12);
+
+    void add(uint64_t hash);
+    void addId(int64_t id);
+    void merge(const HyperLogLog& other);
+
+    double estimate() const;
+    double standardError() const;
+    size_t memoryBytes() const;
+
+    static uint64_t hashId(uint64_t x);
+
+private:
+    int precision;
+    std::vector<uint8_t> registers;
+};
+
+// Frequency estimation. With width w and depth d, an estimate never
+// undercounts and overcounts by at most (e / w) * totalCount with
+// probability 1 - e^-d (defaults: ~0.13% of total, 99.3%).
+class CountMinSketch {
+public:
+    CountMinSketch(size_t width = 2048, size_t depth = 5);
+
+    void add(uint64_t key, int64_t count = 1);
+    int64_t estimate(uint64_t key) const;
+    void merge(const CountMinSketch& other);
+
+    int64_t totalCount() const;
+    double epsilon() const;
+    double delta() const;
+    size_t memoryBytes() const;
+
+private:
+    size_t width;
+    size_t depth;
+    int64_t total;
+    std::vector<int64_t> counters; // depth rows of width counters
+
+    size_t slot(size_t row, uint64_t key) const;
+};
+
+// Top-k keys by Count-Min estimate. Candidates are kept in an ordered
+// set keyed by estimate, which serves as an updatable min-heap.
+//
+// A key whose true count exceeds (1/k + epsilon) * totalCount is among the
+// candidates whenever the Count-Min bound holds, whether built in one pass
+// or merged: it exceeds that share in at least one part, where it cannot
+// fall out of the heap.
+// Below that threshold a merge only re-ranks the union of the parts'
+// candidates, so it can miss a key a single pass would have kept (one
+// that was never in any part's top k). Reported counts carry the
+// Count-Min overcount bound of the merged sketch.
+class HeavyHitters {
+public:
+    explicit HeavyHitters(size_t k = 10, size_t width = 2048, size_t depth = 5);
+
+    void add(int key, int64_t count);
+    void merge(const HeavyHitters& other);
+
+    // (key, estimated count), highest first
+    std::vector<std::pair<int, int64_t>> top() const;
+    const CountMinSketch& sketch() const;
+    size_t memoryBytes() const;
+
+private:
+    size_t k;
+    CountMinSketch cms;
+    std::unordered_map<int, int64_t> candidates;
+    std::set<std::pair<int64_t, int>> heap;
+
+    void offer(int key, int64_t estimate);
+};
+
+// Approximate analytics over finalized orders: distinct customers per
+// month and per product, plus heavy-hitter products by units sold.
+// Per-product buyer sketches are capped at kMaxProductSketches (256 B
+// each, 4 MiB in all); products first seen after the cap is reached are
+// not tracked and distinctBuyers() reports them as -1.
+class OrderSketches {
+public:
+    static constexpr int kMonthPrecision = 12;
+    static constexpr int kProductPrecision = 8;
+    static constexpr size_t kMaxProductSketches = 16384;
+
+    explicit OrderSketches(size_t topK = 10);
+
+    void addOrder(const Order& order);
+    void merge(const OrderSketches& other);
+
+    // Builds with one sketch set per worker thread, then merges them.
+    static OrderSketches build(const std::vector<Order>& orders, size_t topK = 10);
+
+    const std::map<std::string, HyperLogLog>& monthlyCustomers() const;
+    const HeavyHitters& heavyHitters() const;
+    // -1 when the product is not tracked (never bought, or over the cap)
+    double distinctBuyers(int productId) const;
+    size_t memoryBytes() const;
+
+private:
+    std::map<std::string, HyperLogLog> m_monthly;           // YYYY-MM -> customers
+    std::unordered_map<int, HyperLogLog> m_productBuyers;   // productId -> customers
+    HeavyHitters m_heavy;
+};
+
+#endif
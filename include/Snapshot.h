@@ -0,0 +1,110 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Finance.h"
+#include "ReportCache.h"
+
+// Plain-value copies of the live objects, so a snapshot never points back
+// into DataManager's mutable storage.
+struct ProductRow {
+    int id;
+    std::string name;
+    double price;
+    double cost;
+    int quantity;
+};
+
+struct CustomerRow {
+    int id;
+    std::string name;
+    bool premium;
+    double loyaltyPercent;
+    std::vector<int> orderIds;
+};
+
+struct OrderRow {
+    int orderId;
+    int customerId;                            // -1 if none
+    std::string date;
+    double total;
+    bool finalized;
+    std::vector<std::pair<int, int>> items;    // (productId, qty)
+};
+
+using LedgerRow = Finance::Transaction;
+
+// Immutable row list stored as fixed-size chunks. A new version copies the
+// chunk pointers and rebuilds only the chunks that changed, so consecutive
+// versions share everything else.
+template<typename Row>
+class ChunkedRows {
+public:
+    static constexpr size_t kChunkRows = 256;
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const Row& operator[](size_t i) const { return (*m_chunks[i / kChunkRows])[i % kChunkRows]; }
+
+    template<typename Fn>
+    void forEach(Fn fn) const {
+        for (const auto& chunk : m_chunks) {
+            for (const Row& row : *chunk) fn(row);
+        }
+    }
+
+    // Resizes to newSize rows, rebuilding (via makeRow(i)) every chunk that
+    // holds a row listed in dirtyRows, plus any chunk past the old end.
+    // rebuildAll forces a full copy (e.g. after rows were erased or shifted).
+    template<typename MakeRow>
+    void update(size_t newSize, const std::vector<size_t>& dirtyRows, bool rebuildAll, MakeRow makeRow) {
+        const size_t chunkCount = (newSize + kChunkRows - 1) / kChunkRows;
+        std::vector<bool> rebuild(chunkCount, rebuildAll || newSize < m_size);
+
+        for (size_t c = m_size / kChunkRows; c < chunkCount; ++c) rebuild[c] = true;
+        for (size_t row : dirtyRows) {
+            if (row < newSize) rebuild[row / kChunkRows] = true;
+        }
+
+        m_chunks.resize(chunkCount);
+        for (size_t c = 0; c < chunkCount; ++c) {
+            if (!rebuild[c]) continue;
+            const size_t end = std::min(newSize, (c + 1) * kChunkRows);
+            std::vector<Row> rows;
+            rows.reserve(end - c * kChunkRows);
+            for (size_t i = c * kChunkRows; i < end; ++i) rows.push_back(makeRow(i));
+            m_chunks[c] = std::make_shared<const std::vector<Row>>(std::move(rows));
+        }
+        m_size = newSize;
+    }
+
+private:
+    std::vector<std::shared_ptr<const std::vector<Row>>> m_chunks;
+    size_t m_size = 0;
+};
+
+// One committed version of the whole data set. Published by
+// DataManager::publishSnapshot() and never modified afterwards.
+struct Snapshot {
+    uint64_t version = 0;
+    DataEpochs epochs;                 // DataManager epochs this version reflects
+
+    ChunkedRows<ProductRow> products;
+    ChunkedRows<CustomerRow> customers;
+    ChunkedRows<OrderRow> orders;
+    ChunkedRows<LedgerRow> ledger;
+    double totalRevenue = 0.0;
+    double totalExpenses = 0.0;
+};
+
+// Holding one of these pins the version; it is freed with its last holder.
+using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef STARTUPPROFILE_H
+#define STARTUPPROFILE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Where cold-start time goes. DataManager::loadAll fills the first four
+// phases; the interactive front end adds Render (banner and first menu).
+enum class StartupPhase : uint8_t {
+    Read,       // opening and reading the data files
+    Parse,      // text to products, customers, ledger and order rows
+    Resolve,    // order rows to Orders with product and customer pointers
+    Index,      // archive summaries, indexes and derived structures
+    Render,     // banner and first menu
+    Count
+};
+
+const char* startupPhaseName(StartupPhase phase);
+
+// Milliseconds per phase, plus time-to-ready measured by the caller
+struct StartupProfile {
+    static const size_t kPhases = static_cast<size_t>(StartupPhase::Count);
+
+    double phaseMs[kPhases] = {};
+    double readyMs = 0.0;
+
+    double& operator[](StartupPhase phase) { return phaseMs[static_cast<size_t>(phase)]; }
+    double operator[](StartupPhase phase) const { return phaseMs[static_cast<size_t>(phase)]; }
+};
+
+// Adds the time from construction to destruction to one phase. A null
+// profile makes it a no-op.
+class StartupPhaseTimer {
+public:
+    StartupPhaseTimer(StartupProfile* profile, StartupPhase phase)
+        : profile(profile), phase(phase) {
+        if (profile) start = std::chrono::steady_clock::now();
+    }
+    ~StartupPhaseTimer() {
+        if (!profile) return;
+        (*profile)[phase] +=
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    StartupPhaseTimer(const StartupPhaseTimer&) = delete;
+    StartupPhaseTimer& operator=(const StartupPhaseTimer&) = delete;
+
+private:
+    StartupProfile* profile;
+    StartupPhase phase;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef STOCKINDEX_H
+#define STOCKINDEX_H
+
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Product.h"
+
+// Products ordered by stock level, so low-stock alerts walk only the
+// k matching entries instead of scanning the whole catalog. Products
+// with a reorder point are also ordered by (quantity - reorder point).
+class StockIndex {
+public:
+    void rebuild(const std::vector<Product>& products);
+    void update(const Product& product);   // after any quantity change
+    void remove(int productId);
+
+    void setReorderPoint(int productId, int reorderPoint);
+    void clearReorderPoints();
+    int reorderPoint(int productId) const; // -1 when none is set
+
+    // (productId, quantity) with quantity < threshold, lowest first
+    std::vector<std::pair<int, int>> below(int threshold) const;
+    // productIds at or below their reorder point, most urgent first
+    std::vector<int> atReorderPoint() const;
+
+private:
+    std::unordered_map<int, int> m_qty;
+    std::set<std::pair<int, int>> m_byQty;        // (quantity, productId)
+    std::unordered_map<int, int> m_reorderPoint;
+    std::set<std::pair<int, int>> m_byMargin;     // (quantity - reorderPoint, productId)
+};
+
+#endif
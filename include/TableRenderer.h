@@ -0,0 +1,64 @@
+#ifndef TABLERENDERER_H
+#define TABLERENDERER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "TextFormat.h"
+
+// Fixed-width text tables for the list screens. The header and rule are
+// formatted once; rows are formatted into one buffer by a callback and
+// written in large chunks, so a listing costs a handful of writes instead
+// of one formatted stream insertion per cell. Cells are formatted by
+// TextFormat.
+class TableRenderer {
+public:
+    using Align = TextFormat::Align;
+
+    struct Column {
+        const char* header;
+        unsigned width;
+        Align align;
+    };
+
+    // Appends the cells of one row, left to right
+    class Row {
+    public:
+        Row& text(std::string_view s);
+        Row& number(long long v);
+        Row& decimal(double v, int precision = 2);   // fixed notation
+
+    private:
+        friend class TableRenderer;
+        Row(const std::vector<Column>& columns, std::string& buffer)
+            : columns(columns), buffer(buffer) {}
+
+        const std::vector<Column>& columns;
+        std::string& buffer;
+        size_t column = 0;
+    };
+
+    // Fills row `index` of the table
+    using RowFn = std::function<void(size_t index, Row& row)>;
+
+    // `ruleWidth` dashes are printed under the header
+    TableRenderer(std::vector<Column> columns, size_t ruleWidth);
+
+    // Blank line, header and rule
+    void writeHeader(std::ostream& out) const;
+    // Rows [first, last)
+    void writeRows(std::ostream& out, size_t first, size_t last, const RowFn& row) const;
+
+private:
+    static const size_t kChunkBytes = 64 * 1024;
+
+    std::vector<Column> columns;
+    std::string header;
+};
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef TEXTFORMAT_H
+#define TEXTFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Appends fixed-width text fields to a string with std::to_chars instead of
+// stream manipulators. Fields pad with spaces like std::setw and are never
+// truncated.
+class TextFormat {
+public:
+    enum class Align : uint8_t { Left, Right };
+
+    static void pad(std::string& out, std::string_view s, size_t width = 0, Align align = Align::Left);
+    static void integer(std::string& out, long long v, size_t width = 0, Align align = Align::Left);
+    // Same digits as printf("%.*f")
+    static void fixed(std::string& out, double v, int precision = 2, size_t width = 0,
+                      Align align = Align::Left);
+};
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped trace spans for the hot paths (file loads and saves, loadAll and
+// saveAll, reports, Order::finalize), exported as Chrome trace-event JSON
+// that chrome://tracing and Perfetto open directly.
+//
+// Tracing is compiled in unless BMS_NO_TRACE is defined, and stays off until
+// Trace::start(). While off, a span or counter costs one relaxed atomic load
+// and a branch. While on, each finished span appends one event to a buffer
+// owned by its thread; the export merges them. Collection stops after
+// kMaxEvents events and the export records how many were dropped.
+//
+// Counters are process-wide totals. Their values are emitted as a counter
+// event each time an outermost span on any thread ends.
+enum class TraceCounter : uint8_t {
+    RowsParsed,
+    BytesWritten,
+    Lookups,
+    Count
+};
+
+class Trace {
+public:
+    static const size_t kMaxEvents = 1 << 20;
+
+    // Starts collecting; timestamps are relative to this call
+    static void start();
+    static bool enabled() {
+#ifdef BMS_NO_TRACE
+        return false;
+#else
+        return s_enabled.load(std::memory_order_relaxed);
+#endif
+    }
+
+    static void add(TraceCounter counter, int64_t delta) {
+        if (enabled()) addSlow(counter, delta);
+    }
+
+    // Writes every event collected so far. Throws FileOperationException.
+    static void writeChromeJson(const std::string& path);
+    static size_t eventCount();
+
+private:
+    friend class TraceSpan;
+    static std::atomic<bool> s_enabled;
+
+    static void addSlow(TraceCounter counter, int64_t delta);
+};
+
+// Records the time from construction to destruction as one complete event
+// named `name`, or `name:detail` (detail must outlive the span). Up to four
+// integer arguments can be attached while the span is open.
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name) {
+        if (Trace::enabled()) begin(name, nullptr);
+    }
+    TraceSpan(const char* name, const std::string& detail) {
+        if (Trace::enabled()) begin(name, &detail);
+    }
+    ~TraceSpan() {
+        if (active) end();
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    bool isActive() const { return active; }
+    void arg(const char* key, int64_t value) {
+        if (active && argCount < kMaxArgs) args[argCount++] = {key, value};
+    }
+
+private:
+    static const uint8_t kMaxArgs = 4;
+    struct Arg {
+        const char* key;
+        int64_t value;
+    };
+
+    bool active = false;
+    uint8_t argCount = 0;
+    const char* name = nullptr;
+    const std::string* detail = nullptr;
+    int64_t startNs = 0;
+    Arg args[kMaxArgs];
+
+    void begin(const char* spanName, const std::string* spanDetail);
+    void end();
+};
+
+#endif
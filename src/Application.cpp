@@ -1,10 +1,111 @@
 #include "Application.h"
+#include "BatchRunner.h"
+#include "DateUtil.h"
+#include "Exceptions.h"
+#include "Follower.h"
+#include "InvoiceExport.h"
+#include "LatencyStats.h"
+#include "ShardRouter.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <future>
+#include <iomanip>
 #include <iostream>
+#include <thread>
+
+namespace {
+// Tails the log until `stop` (or Follower::requestStop()), then applies
+// whatever is already in it. `write` runs a mutation with the locking the
+// caller needs; `save` persists the replica every `commitEvery` changes and
+// once a second while caught up.
+void followLog(Follower& follower, const std::atomic<bool>& stop, size_t commitEvery,
+               const std::function<void(const std::function<void()>&)>& write,
+               const std::function<void()>& save) {
+    using Clock = std::chrono::steady_clock;
+    std::vector<ChangeEvent> batch;
+    size_t unsaved = 0;
+    Clock::time_point lastSave = Clock::now();
+    auto saveNow = [&] {
+        save();
+        unsaved = 0;
+        lastSave = Clock::now();
+    };
+
+    for (;;) {
+        const bool stopping = stop || Follower::stopRequested();
+
+        if (!follower.isOpen() || follower.needsResync()) {
+            if (stopping) return;
+            if (!follower.logReady()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+            std::cerr << "Primary restarted; reloading its base.\n";
+            write([&] { follower.open(); });
+            saveNow();
+            continue;
+        }
+
+        batch.clear();
+        follower.fetch(batch);
+        if (!batch.empty()) {
+            size_t changed = 0;
+            write([&] { changed = follower.apply(batch); });
+            unsaved += changed;
+            if (commitEvery > 0 && unsaved >= commitEvery) saveNow();
+            continue;
+        }
+
+        // Caught up: persist at most once a second while changes trickle in
+        if (stopping) return;
+        if (unsaved > 0 && Clock::now() - lastSave >= std::chrono::seconds(1)) saveNow();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+}
+} // namespace
 
 Application::Application(std::string dataDir)
-    : dm(), menu(dm), dataDir(std::move(dataDir)), safeToSave(false) {}
+    : dm(), menu(dm, dataDir), dataDir(std::move(dataDir)), safeToSave(false),
+      constructedAt(std::chrono::steady_clock::now()) {}
+
+void Application::setChangeLog(const std::string& path) {
+    changeLogPath = path;
+}
 
-void Application::initialize() {
+bool Application::startChangeLog() {
+    if (changeLogPath.empty()) return true;
+    try {
+        // Followers start from this copy of the loaded state, archive
+        // segments included. It is complete before the new log exists, and
+        // the old log is gone before it changes.
+        namespace fs = std::filesystem;
+        const std::string base = Follower::basePath(changeLogPath);
+        const std::string staging = base + ".tmp";
+        fs::remove(changeLogPath);
+        fs::remove_all(staging);
+        fs::create_directories(staging);
+        dm.saveAll(staging);
+        const fs::path archive = fs::path(dataDir) / "archive";
+        if (fs::is_directory(archive)) {
+            fs::copy(archive, fs::path(staging) / "archive", fs::copy_options::recursive);
+        }
+        fs::remove_all(base);
+        fs::rename(staging, base);
+
+        changeLog = std::make_unique<ChangeLogWriter>(dm.changes(), changeLogPath);
+    } catch (const std::exception& e) {
+        std::cerr << "Could not start change log (" << e.what() << ").\n";
+        return false;
+    }
+    return true;
+}
+
+bool Application::initialize() {
+    const auto bannerStart = std::chrono::steady_clock::now();
     std::cout << R"(
 
           ██████╗  █████╗ ███████╗███████╗███╗   ███╗███████╗███╗   ██╗████████╗
@@ -28,23 +129,124 @@ void Application::initialize() {
 )";
     std::cout << "                             \033[36mDeveloped by Basement Dwellers Team\033[0m\n";
     std::cout << "                        \033[33mCSE 4301 - Object Oriented Programming Project\033[0m\n\n";
+    startup[StartupPhase::Render] +=
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - bannerStart).count();
 
     try {
-        dm.loadAll(dataDir);
+        dm.loadAll(dataDir, &startup);
         safeToSave = true; // Only unlocks if loading finishes without exceptions
         std::cout << "Loaded data from: " << dataDir << "\n";
     } catch (const std::exception& e) {
         std::cout << "\nCRITICAL WARNING: Could not load data (" << e.what() << ").\n";
         std::cout << "Starting with empty data. Changes will NOT be saved to prevent data loss.\n\n";
         safeToSave = false;
+        return true;
+    }
+
+    if (!startChangeLog()) {
+        std::cout << "Not starting: the change log could not be opened, so edits would not reach followers.\n";
+        safeToSave = false;
+        return false;
     }
+    return true;
 }
 
 void Application::run() {
-    menu.mainLoop();
+    // Ready once the main menu is first on screen
+    const auto menuStart = std::chrono::steady_clock::now();
+    menu.mainLoop([this, menuStart] {
+        startup[StartupPhase::Render] +=
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - menuStart).count();
+        if (safeToSave) finishStartup(true);
+    });
+}
+
+void Application::finishStartup(bool interactive) {
+    startup.readyMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - constructedAt).count();
+
+    std::ofstream log(dataDir + "/startup.log", std::ios::app);
+    if (!log) return;
+    log << DateUtil::localTimestamp() << " mode=" << (interactive ? "interactive" : "headless")
+        << std::fixed << std::setprecision(1) << " ready_ms=" << startup.readyMs;
+    for (size_t i = 0; i < StartupProfile::kPhases; ++i) {
+        const auto phase = static_cast<StartupPhase>(i);
+        if (phase == StartupPhase::Render && !interactive) continue;
+        log << " " << startupPhaseName(phase) << "_ms=" << startup[phase];
+    }
+    log << " products=" << dm.products().size() << " customers=" << dm.customers().size()
+        << " orders=" << dm.orders().size() << " transactions=" << dm.finance().getTransactions().size()
+        << "\n";
+}
+
+int Application::profileStartup(size_t runs) {
+    using Clock = std::chrono::steady_clock;
+    std::vector<StartupProfile> samples;
+    samples.reserve(runs);
+    for (size_t i = 0; i < runs; ++i) {
+        StartupProfile sample;
+        {
+            DataManager fresh;
+            const auto start = Clock::now();
+            try {
+                fresh.loadAll(dataDir, &sample);
+            } catch (const std::exception& e) {
+                std::cerr << "Could not load data from " << dataDir << " (" << e.what() << ").\n";
+                return 1;
+            }
+            sample.readyMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            if (i == 0) {
+                std::cout << "Profiling " << dataDir << ": " << fresh.products().size() << " products, "
+                          << fresh.customers().size() << " customers, " << fresh.orders().size() << " orders, "
+                          << fresh.finance().getTransactions().size() << " transactions\n";
+            }
+        }   // teardown is not part of the sample
+        samples.push_back(sample);
+    }
+
+    // Nearest-rank percentiles over the runs
+    auto row = [&](const char* name, const std::function<double(const StartupProfile&)>& value) {
+        std::vector<double> v;
+        v.reserve(samples.size());
+        double sum = 0.0;
+        for (const auto& s : samples) {
+            v.push_back(value(s));
+            sum += v.back();
+        }
+        std::sort(v.begin(), v.end());
+        auto pct = [&v](double q) {
+            const size_t rank = static_cast<size_t>(std::ceil(q * static_cast<double>(v.size())));
+            return v[std::max<size_t>(rank, 1) - 1];
+        };
+        std::cout << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(11) << v.front() << std::setw(11) << pct(0.5) << std::setw(11) << pct(0.9)
+                  << std::setw(11) << sum / static_cast<double>(v.size()) << std::setw(11) << v.back() << "\n";
+    };
+
+    std::cout << "Load phases over " << runs << " run(s), ms (the first run may include cold file reads):\n"
+              << std::left << std::setw(10) << "Phase" << std::right << std::setw(11) << "Min"
+              << std::setw(11) << "p50" << std::setw(11) << "p90" << std::setw(11) << "Mean"
+              << std::setw(11) << "Max" << "\n";
+    for (size_t p = 0; p < StartupProfile::kPhases; ++p) {
+        const auto phase = static_cast<StartupPhase>(p);
+        if (phase == StartupPhase::Render) continue;   // no UI here
+        row(startupPhaseName(phase), [phase](const StartupProfile& s) { return s[phase]; });
+    }
+    row("total", [](const StartupProfile& s) { return s.readyMs; });
+    return 0;
 }
 
 void Application::shutdown() {
+    if (changeLog) {
+        changeLog->close();   // drains events still queued for the log
+        // Saving past a failed log would leave followers behind for good
+        if (changeLog->failed()) {
+            std::cout << "Change log " << changeLog->path() << " stopped; changes since then are not saved.\n";
+            safeToSave = false;
+        }
+        changeLog.reset();
+    }
+
     // Only save if it's safe!
     if (safeToSave) {
         try {
@@ -53,7 +255,205 @@ void Application::shutdown() {
         } catch (const std::exception& e) {
             std::cout << "Error: Could not save data (" << e.what() << ").\n";
         }
+        try {
+            LatencyStats::appendCsv(dataDir + "/latency.csv");
+        } catch (const std::exception& e) {
+            std::cout << "Error: Could not write latency stats (" << e.what() << ").\n";
+        }
     } else {
         std::cout << "Skipped saving to protect your original files from being overwritten.\n";
     }
-}
\ No newline at end of file
+}
+
+bool Application::loadForHeadless() {
+    try {
+        dm.loadAll(dataDir, &startup);
+    } catch (const std::exception& e) {
+        // Never run headless against partial data: its commits would overwrite the files.
+        std::cerr << "Could not load data from " << dataDir << " (" << e.what() << ").\n";
+        return false;
+    }
+    safeToSave = true;
+    finishStartup(false);
+    return startChangeLog();
+}
+
+namespace {
+std::istream* openBatchSource(const std::string& source, std::ifstream& file) {
+    if (source == "-") return &std::cin;
+    file.open(source);
+    if (!file) {
+        std::cerr << "Could not open batch file: " << source << "\n";
+        return nullptr;
+    }
+    return &file;
+}
+} // namespace
+
+int Application::runBatch(const std::string& source, size_t commitEvery) {
+    if (!loadForHeadless()) return 1;
+
+    std::ifstream file;
+    std::istream* in = openBatchSource(source, file);
+    if (!in) return 1;
+
+    BatchRunner runner(dm, dataDir, commitEvery);
+    const BatchStats stats = runner.run(*in, std::cout, std::cerr);
+
+    std::cerr << "Batch complete: " << stats.ok << " ok, " << stats.failed << " failed, "
+              << stats.commits << " commit(s) to " << dataDir << "\n";
+    return stats.failed == 0 ? 0 : 1;
+}
+
+int Application::splitShards(const std::string& root, size_t shards, bool byRange) {
+    if (!loadForHeadless()) return 1;
+
+    try {
+        std::vector<int> customerIds;
+        for (const Customer* c : dm.customers()) customerIds.push_back(c->getId());
+        const ShardMap map = byRange ? ShardMap::balancedRanges(customerIds, shards) : ShardMap::byHash(shards);
+        ShardRouter::split(dm, root, map);
+    } catch (const std::exception& e) {
+        std::cerr << "Could not split into shards (" << e.what() << ").\n";
+        return 1;
+    }
+    std::cerr << "Split " << dataDir << " into " << shards << " shard(s) under " << root << "\n";
+    return 0;
+}
+
+int Application::archiveOrders(const std::string& cutoff) {
+    if (!loadForHeadless()) return 1;
+
+    try {
+        const size_t moved = dm.archiveOrders(dataDir, cutoff);
+        if (moved > 0) dm.saveAll(dataDir);
+        std::cerr << "Archived " << moved << " order(s) dated before " << cutoff << "; "
+                  << dm.archive().orderCount() << " archived in " << dm.archive().segmentCount()
+                  << " segment(s), " << dm.orders().size() << " live.\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Could not archive orders (" << e.what() << ").\n";
+        return 1;
+    }
+    return 0;
+}
+
+int Application::exportInvoices(const std::string& out, bool bundle, const std::string& from,
+                                const std::string& to) {
+    if (!loadForHeadless()) return 1;
+
+    try {
+        const auto orders = InvoiceExport::finalizedOrders(dm, from, to);
+        const InvoiceExportStats stats = bundle ? InvoiceExport::toBundle(orders, out)
+                                                : InvoiceExport::toDirectory(orders, out);
+        std::cerr << "Exported " << stats.invoices << " invoice(s), " << stats.bytes << " bytes, to " << out
+                  << (bundle ? " and " + out + ".idx" : std::string()) << " on " << stats.workers
+                  << " thread(s).\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Could not export invoices (" << e.what() << ").\n";
+        return 1;
+    }
+    return 0;
+}
+
+int Application::runShardedBatch(const std::string& root, const std::string& source, size_t commitEvery) {
+    std::ifstream file;
+    std::istream* in = openBatchSource(source, file);
+    if (!in) return 1;
+
+    std::unique_ptr<ShardRouter> router;
+    try {
+        router = std::make_unique<ShardRouter>(root, commitEvery);
+    } catch (const std::exception& e) {
+        // As with one data directory: never run against partial data
+        std::cerr << "Could not load shards from " << root << " (" << e.what() << ").\n";
+        return 1;
+    }
+    const BatchStats stats = router->run(*in, std::cout, std::cerr);
+
+    std::cerr << "Batch complete: " << stats.ok << " ok, " << stats.failed << " failed, "
+              << stats.commits << " commit(s) to " << router->shardCount() << " shard(s) under " << root << "\n";
+    return stats.failed == 0 ? 0 : 1;
+}
+
+int Application::runServer(const ServerOptions& options) {
+    if (!loadForHeadless()) return 1;
+
+    Server server(dm, dataDir, options);
+    server.run();
+    return 0;
+}
+
+int Application::runFollower(const std::string& logPath, const ServerOptions& serve, size_t commitEvery) {
+    Follower follower(dm, logPath, dataDir);
+    while (!follower.logReady()) {
+        if (Follower::stopRequested()) return 1;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    try {
+        follower.open();
+    } catch (const std::exception& e) {
+        std::cerr << "Could not load the primary's base (" << e.what() << ").\n";
+        return 1;
+    }
+    safeToSave = true;
+    std::cerr << "Following " << logPath << " into " << dataDir << "\n";
+
+    std::atomic<bool> stopTail{false};
+    auto report = [&](const std::exception& e) {
+        std::cerr << "Replication stopped after seq " << follower.appliedSeq() << ": " << e.what() << "\n";
+    };
+
+    if (serve.endpoint.empty()) {
+        try {
+            followLog(follower, stopTail, commitEvery, [](const std::function<void()>& mutate) { mutate(); },
+                      [&] { dm.saveAll(dataDir); });
+        } catch (const std::exception& e) {
+            report(e);
+            return 1;
+        }
+        return 0;
+    }
+
+    // The server counts client writes only; the tail loop saves replicated ones.
+    Server server(dm, dataDir, serve);
+    std::promise<void> tailDone;
+    std::shared_future<void> tailFinished = tailDone.get_future().share();
+    int code = 0;
+
+    std::thread tail([&] {
+        try {
+            followLog(follower, stopTail, commitEvery,
+                      [&](const std::function<void()>& mutate) {
+                          server.applyWrite([&] {
+                              mutate();
+                              return size_t{0};
+                          });
+                      },
+                      [&] { server.commit(); });
+        } catch (const std::exception& e) {
+            report(e);
+            code = 1;
+            Server::requestStop();
+        }
+        tailDone.set_value();
+    });
+
+    ReplicaHooks hooks;
+    hooks.status = [&] { return follower.status(); };
+    hooks.promote = [&] {
+        stopTail = true;
+        tailFinished.wait();   // everything already logged is applied first
+        if (code != 0) throw ReplicationException("Replication failed; not promoting.");
+        server.applyWrite([&] {
+            if (!startChangeLog()) throw FileOperationException("Could not start the change log.");
+            return size_t{0};
+        });
+        std::cerr << "Promoted to primary after seq " << follower.appliedSeq() << "\n";
+    };
+    server.attachReplica(std::move(hooks));
+
+    server.run();
+    stopTail = true;
+    tail.join();
+    return code;
+}
@@ -0,0 +1,225 @@
+#include "BatchRunner.h"
+#include "Exceptions.h"
+#include "TextFormat.h"
+
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace {
+template<typename T>
+T nextArg(std::istream& args, const char* name) {
+    T value;
+    if (!(args >> value)) {
+        throw InvalidInputException(std::string("Missing or invalid argument: ") + name);
+    }
+    return value;
+}
+
+void expectEnd(std::istream& args) {
+    std::string extra;
+    if (args >> extra) throw InvalidInputException("Unexpected argument: " + extra);
+}
+} // namespace
+
+BatchRunner::BatchRunner(DataManager& dm, std::string dataDir, size_t commitEvery)
+    : dm(dm), dataDir(std::move(dataDir)), commitEvery(commitEvery), pending(0) {}
+
+void BatchRunner::commit() {
+    dm.saveAll(dataDir);
+    pending = 0;
+    stats.commits++;
+}
+
+BatchStats BatchRunner::run(std::istream& in, std::ostream& out, std::ostream& err) {
+    stats = BatchStats{};
+    pending = 0;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        stats.lines++;
+
+        const size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+
+        try {
+            if (execute(line, out)) {
+                pending++;
+                if (commitEvery > 0 && pending >= commitEvery) commit();
+            }
+            stats.ok++;
+        } catch (const std::exception& e) {
+            stats.failed++;
+            err << "line " << stats.lines << ": " << e.what() << "\n";
+        }
+    }
+
+    if (pending > 0) commit();
+    return stats;
+}
+
+bool BatchRunner::execute(const std::string& line, std::ostream& out) {
+    std::istringstream args(line);
+    std::string cmd;
+    args >> cmd;
+
+    if (cmd == "create-order") {
+        const int orderId = nextArg<int>(args, "orderId");
+        const int customerId = nextArg<int>(args, "customerId");
+        const std::string date = nextArg<std::string>(args, "date");
+        expectEnd(args);
+
+        Customer* c = dm.findCustomer(customerId);
+        if (!c) throw InvalidInputException("Customer ID not found: " + std::to_string(customerId));
+        dm.createOrder(orderId, c, date);
+        return true;
+    }
+
+    if (cmd == "add-item") {
+        const int orderId = nextArg<int>(args, "orderId");
+        const int productId = nextArg<int>(args, "productId");
+        const int qty = nextArg<int>(args, "qty");
+        expectEnd(args);
+
+        Order* o = dm.findOrder(orderId);
+        if (!o) throw InvalidInputException("Order not found: " + std::to_string(orderId));
+        Product* p = dm.findProduct(productId);
+        if (!p) throw InvalidInputException("Product not found: " + std::to_string(productId));
+        dm.addOrderItem(*o, p, qty);
+        return true;
+    }
+
+    if (cmd == "remove-item") {
+        const int orderId = nextArg<int>(args, "orderId");
+        const int productId = nextArg<int>(args, "productId");
+        expectEnd(args);
+
+        Order* o = dm.findOrder(orderId);
+        if (!o) throw InvalidInputException("Order not found: " + std::to_string(orderId));
+        Product* p = dm.findProduct(productId);
+        if (!p) throw InvalidInputException("Product not found: " + std::to_string(productId));
+        dm.removeOrderItem(*o, p);
+        return true;
+    }
+
+    if (cmd == "finalize") {
+        const int orderId = nextArg<int>(args, "orderId");
+        expectEnd(args);
+
+        Order* o = dm.findOrder(orderId);
+        if (!o) throw InvalidInputException("Order not found: " + std::to_string(orderId));
+        dm.finalizeOrder(*o);
+        return true;
+    }
+
+    if (cmd == "finalize-batch") {
+        std::vector<int> ids;
+        int id;
+        while (args >> id) ids.push_back(id);
+        if (!args.eof()) throw InvalidInputException("Invalid order ID in finalize-batch.");
+        if (ids.empty()) throw InvalidInputException("Missing argument: orderId");
+
+        const BatchFinalizeResult result = dm.finalizeBatch(ids);
+        for (const auto& failure : result.failed) {
+            out << failure.first << "," << failure.second << "\n";
+        }
+        return !result.finalized.empty();
+    }
+
+    if (cmd == "restock") {
+        const int productId = nextArg<int>(args, "productId");
+        const int qty = nextArg<int>(args, "qty");
+        std::string date = "N/A";
+        args >> date;
+        expectEnd(args);
+
+        Product* p = dm.findProduct(productId);
+        if (!p) throw InvalidInputException("Product not found: " + std::to_string(productId));
+        if (qty <= 0) throw InvalidInputException("Restock quantity must be positive.");
+
+        dm.adjustStock(*p, qty);
+        dm.recordExpense(p->getCost() * qty, "Restock product #" + std::to_string(productId), date);
+        return true;
+    }
+
+    if (cmd == "expense") {
+        const double amount = nextArg<double>(args, "amount");
+        const std::string date = nextArg<std::string>(args, "date");
+        std::string desc;
+        std::getline(args >> std::ws, desc);
+        if (desc.empty()) throw InvalidInputException("Missing argument: description");
+
+        dm.recordExpense(amount, desc, date);
+        return true;
+    }
+
+    if (cmd == "query-orders") {
+        const OrderQuery q = parseOrderQuery(args);
+        const QueryResult result = dm.queryOrders(q);
+        for (size_t row : result.rows) printOrderRow(dm.orders()[row], out);
+        return false;
+    }
+
+    if (cmd == "commit") {
+        expectEnd(args);
+        commit();
+        return false;
+    }
+
+    throw InvalidInputException("Unknown command: " + cmd);
+}
+
+OrderQuery BatchRunner::parseOrderQuery(std::istream& args) {
+    OrderQuery q;
+
+    std::string kv;
+    while (args >> kv) {
+        const size_t eq = kv.find('=');
+        if (eq == std::string::npos) throw InvalidInputException("Expected key=value, got: " + kv);
+        const std::string key = kv.substr(0, eq);
+        const std::string value = kv.substr(eq + 1);
+
+        try {
+            if (key == "id") q.orderId = std::stoi(value);
+            else if (key == "from") q.fromDate = value;
+            else if (key == "to") q.toDate = value;
+            else if (key == "customer") q.customerId = std::stoi(value);
+            else if (key == "product") q.productId = std::stoi(value);
+            else if (key == "min") q.minTotal = std::stod(value);
+            else if (key == "max") q.maxTotal = std::stod(value);
+            else if (key == "finalized") q.finalized = std::stoi(value);
+            else if (key == "desc") q.descending = value == "1";
+            else if (key == "offset") q.offset = static_cast<size_t>(std::stoul(value));
+            else if (key == "limit") q.limit = static_cast<size_t>(std::stoul(value));
+            else if (key == "tier") {
+                if (value == "regular") q.tier = CustomerTier::Regular;
+                else if (value == "premium") q.tier = CustomerTier::Premium;
+                else throw InvalidInputException("Unknown tier: " + value);
+            } else if (key == "sort") {
+                if (value == "id") q.sortBy = OrderSortKey::Id;
+                else if (value == "date") q.sortBy = OrderSortKey::Date;
+                else if (value == "total") q.sortBy = OrderSortKey::Total;
+                else if (value == "customer") q.sortBy = OrderSortKey::Customer;
+                else throw InvalidInputException("Unknown sort key: " + value);
+            } else {
+                throw InvalidInputException("Unknown query key: " + key);
+            }
+        } catch (const std::logic_error&) {
+            throw InvalidInputException("Invalid value for " + key + ": " + value);
+        }
+    }
+
+    return q;
+}
+
+void BatchRunner::printOrderRow(const Order& o, std::ostream& out) {
+    std::string total;
+    TextFormat::fixed(total, o.getTotalAmount());
+    out << o.getOrderId() << ","
+        << (o.getCustomer() ? o.getCustomer()->getId() : -1) << ","
+        << o.getDate() << ","
+        << total << ","
+        << (o.getIsFinalized() ? "true" : "false") << "\n";
+}
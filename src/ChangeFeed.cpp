@@ -0,0 +1,99 @@
+#include "ChangeFeed.h"
+
+#include <algorithm>
+#include <thread>
+
+const char* changeTypeName(ChangeType type) {
+    switch (type) {
+        case ChangeType::ProductUpsert:   return "product-upsert";
+        case ChangeType::ProductRemove:   return "product-remove";
+        case ChangeType::StockDelta:      return "stock-delta";
+        case ChangeType::CustomerUpsert:  return "customer-upsert";
+        case ChangeType::CustomerUpgrade: return "customer-upgrade";
+        case ChangeType::OrderCreate:     return "order-create";
+        case ChangeType::OrderItem:       return "order-item";
+        case ChangeType::OrderItemRemove: return "order-item-remove";
+        case ChangeType::OrderFinalize:   return "order-finalize";
+        case ChangeType::LedgerAppend:    return "ledger-append";
+    }
+    return "unknown";
+}
+
+ChangeSubscription::ChangeSubscription(size_t capacity, bool lossless)
+    : m_ring(capacity), m_lossless(lossless) {}
+
+bool ChangeSubscription::poll(ChangeEvent& out) {
+    return m_ring.tryPop(out);
+}
+
+size_t ChangeSubscription::drain(std::vector<ChangeEvent>& out, size_t max) {
+    size_t n = 0;
+    ChangeEvent event;
+    while (n < max && m_ring.tryPop(event)) {
+        out.push_back(std::move(event));
+        n++;
+    }
+    return n;
+}
+
+uint64_t ChangeSubscription::dropped() const {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+void ChangeSubscription::fail(const std::string& reason) {
+    {
+        std::lock_guard<std::mutex> lock(m_failureMutex);
+        if (m_failed.load()) return;
+        m_failure = reason;
+    }
+    m_failed.store(true);
+}
+
+bool ChangeSubscription::failed() const {
+    return m_failed.load();
+}
+
+std::shared_ptr<ChangeSubscription> ChangeFeed::subscribe(size_t capacity, bool lossless) {
+    auto subscription = std::make_shared<ChangeSubscription>(capacity, lossless);
+    m_subscribers.push_back(subscription);
+    return subscription;
+}
+
+void ChangeFeed::unsubscribe(const std::shared_ptr<ChangeSubscription>& subscription) {
+    m_subscribers.erase(std::remove(m_subscribers.begin(), m_subscribers.end(), subscription),
+                        m_subscribers.end());
+}
+
+bool ChangeFeed::active() const {
+    return !m_subscribers.empty();
+}
+
+void ChangeFeed::publish(ChangeEvent event) {
+    event.seq = ++m_seq;
+
+    for (size_t i = 0; i < m_subscribers.size(); ++i) {
+        ChangeSubscription& sub = *m_subscribers[i];
+        if (sub.m_failed.load()) continue;
+        // The last subscriber may take the event itself; the rest get copies
+        ChangeEvent copy = (i + 1 == m_subscribers.size()) ? std::move(event) : event;
+
+        if (sub.m_lossless) {
+            while (!sub.m_ring.tryPush(std::move(copy)) && !sub.m_failed.load()) std::this_thread::yield();
+        } else if (!sub.m_ring.tryPush(std::move(copy))) {
+            sub.m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+uint64_t ChangeFeed::lastSeq() const {
+    return m_seq;
+}
+
+std::string ChangeFeed::failure() const {
+    for (const auto& sub : m_subscribers) {
+        if (!sub->m_lossless || !sub->failed()) continue;
+        std::lock_guard<std::mutex> lock(sub->m_failureMutex);
+        return sub->m_failure;
+    }
+    return "";
+}
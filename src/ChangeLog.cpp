@@ -0,0 +1,187 @@
+#include "ChangeLog.h"
+#include "Exceptions.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace {
+const char kMagic[8] = {'B', 'M', 'S', 'C', 'D', 'C', '1', '\n'};
+
+template<typename T>
+void put(std::string& buf, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    buf.append(bytes, sizeof(T));
+}
+
+void putString(std::string& buf, const std::string& s) {
+    put<uint32_t>(buf, static_cast<uint32_t>(s.size()));
+    buf += s;
+}
+
+template<typename T>
+bool get(const std::string& buf, size_t& pos, T& value) {
+    if (pos + sizeof(T) > buf.size()) return false;
+    std::memcpy(&value, buf.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+uint64_t fileId(const std::string& path) {
+#ifndef _WIN32
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return 0;
+    return static_cast<uint64_t>(st.st_ino);
+#else
+    (void)path;
+    return 1;
+#endif
+}
+
+bool getString(const std::string& buf, size_t& pos, std::string& s) {
+    uint32_t n;
+    if (!get(buf, pos, n) || pos + n > buf.size()) return false;
+    s.assign(buf, pos, n);
+    pos += n;
+    return true;
+}
+} // namespace
+
+std::string encodeChangeEvent(const ChangeEvent& e) {
+    std::string payload;
+    payload.reserve(48 + e.name.size() + e.date.size());
+    put<uint64_t>(payload, e.seq);
+    put<uint8_t>(payload, static_cast<uint8_t>(e.type));
+    put<uint8_t>(payload, e.derived ? 1 : 0);
+    put<int32_t>(payload, e.id);
+    put<int32_t>(payload, e.ref);
+    put<int32_t>(payload, e.qty);
+    put<double>(payload, e.amount);
+    put<double>(payload, e.cost);
+    putString(payload, e.name);
+    putString(payload, e.date);
+
+    std::string record;
+    record.reserve(4 + payload.size());
+    put<uint32_t>(record, static_cast<uint32_t>(payload.size()));
+    record += payload;
+    return record;
+}
+
+// ---------------- Writer ----------------
+
+ChangeLogWriter::ChangeLogWriter(ChangeFeed& feed, const std::string& path)
+    : m_feed(feed), m_path(path), m_out(path, std::ios::binary | std::ios::trunc) {
+    if (!m_out.is_open()) throw FileOperationException("Failed to open change log: " + path);
+    m_out.write(kMagic, sizeof(kMagic));
+    m_out.flush();
+    if (!m_out) throw FileOperationException("Failed to write change log: " + path);
+
+    m_subscription = m_feed.subscribe(8192, true);
+    m_thread = std::thread([this] { run(); });
+}
+
+ChangeLogWriter::~ChangeLogWriter() {
+    close();
+}
+
+void ChangeLogWriter::close() {
+    m_feed.unsubscribe(m_subscription);
+    m_stop = true;
+    if (m_thread.joinable()) m_thread.join();
+}
+
+const std::string& ChangeLogWriter::path() const {
+    return m_path;
+}
+
+uint64_t ChangeLogWriter::written() const {
+    return m_written.load();
+}
+
+bool ChangeLogWriter::failed() const {
+    return m_subscription->failed();
+}
+
+void ChangeLogWriter::run() {
+    std::vector<ChangeEvent> batch;
+    std::string buf;
+
+    for (;;) {
+        // Read the flag first so nothing published before stop is missed
+        const bool stopping = m_stop.load();
+
+        batch.clear();
+        m_subscription->drain(batch, 1024);
+        if (batch.empty()) {
+            if (stopping) return;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            continue;
+        }
+
+        buf.clear();
+        for (const auto& e : batch) buf += encodeChangeEvent(e);
+        m_out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        m_out.flush();
+        if (!m_out) {
+            // Followers cannot skip a record, so nothing after this batch
+            // may be logged either
+            const std::string reason = "write to " + m_path + " failed after " +
+                                       std::to_string(m_written.load()) + " record(s)";
+            std::cerr << "Change log stopped: " << reason << ". No further changes will be saved.\n";
+            m_subscription->fail(reason);
+            return;
+        }
+        m_written += batch.size();
+    }
+}
+
+// ---------------- Reader ----------------
+
+ChangeLogReader::ChangeLogReader(const std::string& path)
+    : m_in(path, std::ios::binary), m_path(path), m_pos(0), m_fileId(fileId(path)) {
+    if (!m_in.is_open()) throw FileOperationException("Failed to open change log: " + path);
+}
+
+bool ChangeLogReader::replaced() const {
+    return fileId(m_path) != m_fileId;
+}
+
+bool ChangeLogReader::next(ChangeEvent& event) {
+    m_in.clear();
+    m_in.seekg(m_pos);
+
+    if (m_pos == 0) {
+        char magic[sizeof(kMagic)];
+        if (!m_in.read(magic, sizeof(magic))) return false;
+        if (std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+            throw FileOperationException("Not a change log: " + m_path);
+        }
+        m_pos = sizeof(kMagic);
+    }
+
+    uint32_t length;
+    if (!m_in.read(reinterpret_cast<char*>(&length), sizeof(length))) return false;
+    std::string payload(length, '\0');
+    if (!m_in.read(&payload[0], length)) return false;   // record still being written
+
+    size_t pos = 0;
+    uint8_t type, derived;
+    if (!get(payload, pos, event.seq) || !get(payload, pos, type) || !get(payload, pos, derived) ||
+        !get(payload, pos, event.id) || !get(payload, pos, event.ref) || !get(payload, pos, event.qty) ||
+        !get(payload, pos, event.amount) || !get(payload, pos, event.cost) ||
+        !getString(payload, pos, event.name) || !getString(payload, pos, event.date)) {
+        throw FileOperationException("Corrupt change log record in " + m_path);
+    }
+    event.type = static_cast<ChangeType>(type);
+    event.derived = derived != 0;
+
+    m_pos += static_cast<std::streamoff>(sizeof(length) + length);
+    return true;
+}
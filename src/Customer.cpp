@@ -23,6 +23,10 @@ void Customer::addOrderToHistory(int orderId) {
     orderHistory.push_back(orderId);
 }
 
+void Customer::reserveHistory(size_t count) {
+    orderHistory.reserve(count);
+}
+
 void Customer::upgradeToPremium(Customer*& customer, double loyaltyPercent) {
     if (!customer) {
         throw invalid_argument("Customer pointer is null.");
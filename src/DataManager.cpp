@@ -1,9 +1,28 @@
 #include "DataManager.h"
 #include "FileManager.h"
+#include "DateUtil.h"
+#include "Exceptions.h"
+#include "PremiumCustomer.h"
+#include "RegularCustomer.h"
+#include "Trace.h"
+#include "LatencyStats.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 using namespace std;
 
+namespace {
+int64_t monotonicSeconds() {
+    return chrono::duration_cast<chrono::seconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+}
+} // namespace
+
 DataManager::~DataManager() {
     clearCustomers();
 }
@@ -11,6 +30,7 @@ DataManager::~DataManager() {
 void DataManager::clearCustomers() {
     for (auto* c : m_customers) delete c;
     m_customers.clear();
+    m_customerSlot.clear();
 }
 
 string DataManager::joinPath(const string& dir, const string& file) {
@@ -19,28 +39,104 @@ string DataManager::joinPath(const string& dir, const string& file) {
     return dir + "/" + file;
 }
 
-void DataManager::loadAll(const string& dataDir) {
+void DataManager::loadAll(const string& dataDir, StartupProfile* profile) {
+    TraceSpan span("DataManager::loadAll");
     // Clear previous in-memory state
     clearCustomers();
     m_products.clear();
     m_orders.clear();
     m_finance = Finance();
+    m_salesVelocity.clear();
+    m_orderIndex.rebuild(m_orders);
+    m_ledgerIndex.clear();
+    m_stockIndex.clearReorderPoints();
+    m_reservations.clear();
+    m_productSlot.clear();
+    m_archive.clear();
+    m_dirtyOrderRows.clear();
+    m_dirtyCustomerRows.clear();
+    m_dirtyProductRows.clear();
+    m_snapshotStale = true;
 
     const string productsFile  = joinPath(dataDir, "products.txt");
     const string customersFile = joinPath(dataDir, "customers.txt");
     const string ordersFile    = joinPath(dataDir, "orders.txt");
     const string financeFile   = joinPath(dataDir, "finance.txt");
 
-    // Load in dependency order:
-    m_products  = FileManager::loadProducts(productsFile);
-    m_customers = FileManager::loadCustomers(customersFile);
-    m_finance   = FileManager::loadFinance(financeFile);
+    // Load in dependency order. Each file is read whole, parsed, and its
+    // text dropped before the next one is read.
+    auto readText = [profile](const string& path, const char* kind) {
+        StartupPhaseTimer timer(profile, StartupPhase::Read);
+        return FileManager::readFile(path, kind);
+    };
+    {
+        const string text = readText(productsFile, "products");
+        StartupPhaseTimer timer(profile, StartupPhase::Parse);
+        MemoryScope scope(MemSubsystem::Products);
+        m_products = FileManager::parseProducts(text);
+    }
+    {
+        const string text = readText(customersFile, "customers");
+        StartupPhaseTimer timer(profile, StartupPhase::Parse);
+        MemoryScope scope(MemSubsystem::Customers);
+        m_customers = FileManager::parseCustomers(text);
+    }
+    {
+        const string text = readText(financeFile, "finance");
+        StartupPhaseTimer timer(profile, StartupPhase::Parse);
+        MemoryScope scope(MemSubsystem::Ledger);
+        m_finance = FileManager::parseFinance(text);
+    }
+    {
+        // Orders need products + customers to resolve pointers
+        ParsedOrders parsed;
+        {
+            const string text = readText(ordersFile, "orders");
+            StartupPhaseTimer timer(profile, StartupPhase::Parse);
+            parsed = FileManager::parseOrders(text);
+        }
+        StartupPhaseTimer timer(profile, StartupPhase::Resolve);
+        MemoryScope scope(MemSubsystem::Orders);
+        m_orders = FileManager::resolveOrders(parsed, m_products, m_customers);
+    }
+
+    StartupPhaseTimer timer(profile, StartupPhase::Index);
+
+    // An archive run that stopped before orders.txt was saved leaves orders
+    // in both tiers; the archived copy wins
+    m_archive.load(dataDir);
+    if (m_archive.orderCount() > 0) {
+        m_orders.erase(remove_if(m_orders.begin(), m_orders.end(),
+                                 [this](const Order& o) { return m_archive.contains(o.getOrderId()); }),
+                       m_orders.end());
+    }
+
+    // Derived structures
+    MemoryScope scope(MemSubsystem::Indexes);
+    m_salesVelocity.rebuild(m_orders);
+    m_orderIndex.rebuild(m_orders);
+    m_ledgerIndex.sync(m_finance);
+    reindexProducts();
+    reindexCustomers();
+    m_stockIndex.rebuild(m_products);
 
-    // Orders need products + customers to resolve pointers
-    m_orders = FileManager::loadOrders(ordersFile, m_products, m_customers);
+    m_epochs.products++;
+    m_epochs.customers++;
+    m_epochs.orders++;
+    m_epochs.ledger++;
+
+    span.arg("products", static_cast<int64_t>(m_products.size()));
+    span.arg("customers", static_cast<int64_t>(m_customers.size()));
+    span.arg("orders", static_cast<int64_t>(m_orders.size()));
 }
 
 void DataManager::saveAll(const string& dataDir) const {
+    LatencyTimer timer(LatencyOp::Save);
+    TraceSpan span("DataManager::saveAll");
+    const string logFailure = m_changes.failure();
+    if (!logFailure.empty()) {
+        throw FileOperationException("Change log stopped (" + logFailure + "); not saving.");
+    }
     const string productsFile  = joinPath(dataDir, "products.txt");
     const string customersFile = joinPath(dataDir, "customers.txt");
     const string ordersFile    = joinPath(dataDir, "orders.txt");
@@ -52,6 +148,701 @@ void DataManager::saveAll(const string& dataDir) const {
     FileManager::saveFinance(m_finance, financeFile);
 }
 
+void DataManager::publishSnapshot() {
+    MemoryScope scope(MemSubsystem::Snapshots);
+    auto next = make_shared<Snapshot>();
+    if (m_snapshot) *next = *m_snapshot;   // starts out sharing every chunk
+    const bool all = m_snapshotStale || !m_snapshot;
+    const DataEpochs prev = next->epochs;
+
+    // Products, customers and orders: only chunks with edited or appended
+    // rows are copied
+    if (all || prev.products != m_epochs.products) {
+        next->products.update(m_products.size(), m_dirtyProductRows, all, [this](size_t i) {
+            const Product& p = m_products[i];
+            return ProductRow{p.getId(), p.getName(), p.getPrice(), p.getCost(), p.getQuantity()};
+        });
+    }
+    if (all || prev.customers != m_epochs.customers) {
+        next->customers.update(m_customers.size(), m_dirtyCustomerRows, all, [this](size_t i) {
+            const Customer* c = m_customers[i];
+            const auto* premium = dynamic_cast<const PremiumCustomer*>(c);
+            return CustomerRow{c->getId(), c->getName(), premium != nullptr,
+                               premium ? premium->getLoyaltyPercentage() : 0.0,
+                               c->getOrderHistory()};
+        });
+    }
+
+    if (all || prev.orders != m_epochs.orders) {
+        next->orders.update(m_orders.size(), m_dirtyOrderRows, all, [this](size_t i) {
+            const Order& o = m_orders[i];
+            OrderRow row{o.getOrderId(), o.getCustomer() ? o.getCustomer()->getId() : -1,
+                         o.getDate(), o.getTotalAmount(), o.getIsFinalized(), {}};
+            row.items.reserve(o.getItems().size());
+            for (const auto& [p, qty] : o.getItems()) row.items.emplace_back(p ? p->getId() : -1, qty);
+            return row;
+        });
+    }
+
+    // The ledger is append-only: only the tail chunk and new ones are copied
+    if (all || prev.ledger != m_epochs.ledger) {
+        const auto& tx = m_finance.getTransactions();
+        next->ledger.update(tx.size(), {}, all, [&tx](size_t i) { return tx[i]; });
+        next->totalRevenue = m_finance.getTotalRevenue();
+        next->totalExpenses = m_finance.getTotalExpenses();
+    }
+
+    next->epochs = m_epochs;
+    next->version = m_snapshot ? m_snapshot->version + 1 : 1;
+    m_dirtyOrderRows.clear();
+    m_dirtyCustomerRows.clear();
+    m_dirtyProductRows.clear();
+    m_snapshotStale = false;
+
+    atomic_store(&m_snapshot, SnapshotPtr(move(next)));
+}
+
+SnapshotPtr DataManager::pinSnapshot() const {
+    return atomic_load(&m_snapshot);
+}
+
+void DataManager::saveSnapshot(const Snapshot& snapshot, const string& dataDir) {
+    FileManager::saveProducts(snapshot.products, joinPath(dataDir, "products.txt"));
+    FileManager::saveCustomers(snapshot.customers, joinPath(dataDir, "customers.txt"));
+    FileManager::saveOrders(snapshot.orders, joinPath(dataDir, "orders.txt"));
+    FileManager::saveFinance(snapshot, joinPath(dataDir, "finance.txt"));
+}
+
+size_t DataManager::rowOf(const Order& order) const {
+    const Order* base = m_orders.data();
+    if (&order < base || &order >= base + m_orders.size()) {
+        throw InvalidInputException("Order is not managed by this DataManager.");
+    }
+    return static_cast<size_t>(&order - base);
+}
+
+void DataManager::touchOrderRow(size_t row) {
+    m_orderIndex.refreshRow(m_orders, row);
+    m_dirtyOrderRows.push_back(row);
+}
+
+void DataManager::touchCustomer(const Customer* customer) {
+    if (!customer) return;
+    const long row = customerRow(customer->getId());
+    if (row >= 0 && m_customers[static_cast<size_t>(row)] == customer) {
+        m_dirtyCustomerRows.push_back(static_cast<size_t>(row));
+    }
+}
+
+void DataManager::touchProduct(const Product& product) {
+    m_dirtyProductRows.push_back(static_cast<size_t>(&product - m_products.data()));
+}
+
+void DataManager::reindexProducts() {
+    m_productSlot.clear();
+    m_productSlot.reserve(m_products.size());
+    for (size_t i = 0; i < m_products.size(); ++i) {
+        m_productSlot.emplace(m_products[i].getId(), i);
+    }
+}
+
+void DataManager::reindexCustomers() {
+    m_customerSlot.clear();
+    m_customerSlot.reserve(m_customers.size());
+    for (size_t i = 0; i < m_customers.size(); ++i) {
+        if (m_customers[i]) m_customerSlot.emplace(m_customers[i]->getId(), i);
+    }
+}
+
+void DataManager::relinkOrderProducts(const Product* oldBase, size_t oldCount, long erasedIndex) {
+    // Orders hold Product* into m_products; after a reallocation or an erase
+    // map each pointer back to its old slot and then to the new address.
+    const uintptr_t base = reinterpret_cast<uintptr_t>(oldBase);
+    const uintptr_t end = base + oldCount * sizeof(Product);
+    Product* newBase = m_products.data();
+
+    for (auto& o : m_orders) {
+        o.relinkProducts([&](Product* p) -> Product* {
+            const uintptr_t addr = reinterpret_cast<uintptr_t>(p);
+            if (addr < base || addr >= end) return p;
+
+            long slot = static_cast<long>((addr - base) / sizeof(Product));
+            // removeProduct refuses while orders hold the erased product, so
+            // this never happens; never retarget such an item to a neighbour
+            if (slot == erasedIndex) return nullptr;
+            if (erasedIndex >= 0 && slot > erasedIndex) slot--;
+            return newBase + slot;
+        });
+    }
+}
+
+Product* DataManager::findProduct(int productId) {
+    Trace::add(TraceCounter::Lookups, 1);
+    auto it = m_productSlot.find(productId);
+    return it == m_productSlot.end() ? nullptr : &m_products[it->second];
+}
+
+Customer* DataManager::findCustomer(int customerId) {
+    Trace::add(TraceCounter::Lookups, 1);
+    const long row = customerRow(customerId);
+    return row < 0 ? nullptr : m_customers[static_cast<size_t>(row)];
+}
+
+long DataManager::customerRow(int customerId) {
+    auto it = m_customerSlot.find(customerId);
+    if (it == m_customerSlot.end()) return -1;
+
+    // customers() hands out the vector itself: confirm the slot, and rebuild
+    // the index if the vector was edited behind it
+    auto valid = [&] {
+        return it->second < m_customers.size() && m_customers[it->second] &&
+               m_customers[it->second]->getId() == customerId;
+    };
+    if (!valid()) {
+        reindexCustomers();
+        it = m_customerSlot.find(customerId);
+        if (it == m_customerSlot.end() || !valid()) return -1;
+    }
+    return static_cast<long>(it->second);
+}
+
+Order* DataManager::findOrder(int orderId) {
+    Trace::add(TraceCounter::Lookups, 1);
+    m_orderIndex.sync(m_orders);
+    long row = m_orderIndex.findRow(orderId);
+    return row < 0 ? nullptr : &m_orders[static_cast<size_t>(row)];
+}
+
+QueryResult DataManager::queryOrders(const OrderQuery& query) {
+    m_orderIndex.sync(m_orders);
+    return m_orderIndex.run(query, m_customers);
+}
+
+QueryResult DataManager::queryTransactions(const LedgerQuery& query) {
+    m_ledgerIndex.sync(m_finance);
+    return m_ledgerIndex.run(query);
+}
+
+const ReservationLedger& DataManager::reservations() const {
+    return m_reservations;
+}
+
+int DataManager::available(const Product& product) const {
+    return max(0, product.getQuantity() - m_reservations.reserved(product.getId()));
+}
+
+size_t DataManager::expireReservations() {
+    return m_reservations.advance(monotonicSeconds()).size();
+}
+
+void DataManager::setReservationTtl(int seconds) {
+    m_reservations.setTtl(seconds);
+}
+
+void DataManager::clearReservations() {
+    m_reservations.clear();
+}
+
+void DataManager::syncIndexes() {
+    MemoryScope scope(MemSubsystem::Indexes);
+    m_orderIndex.sync(m_orders);
+    m_ledgerIndex.sync(m_finance);
+}
+
+Order& DataManager::createOrder(int orderId, Customer* customer, const string& date) {
+    MemoryScope scope(MemSubsystem::Orders);
+    if (findOrder(orderId) || m_archive.contains(orderId)) {
+        throw InvalidInputException("Order ID already exists: " + to_string(orderId));
+    }
+    m_orders.emplace_back(orderId, customer, date);
+    m_orderIndex.sync(m_orders);
+    m_epochs.orders++;
+
+    if (m_changes.active()) {
+        ChangeEvent e;
+        e.type = ChangeType::OrderCreate;
+        e.id = orderId;
+        e.ref = customer ? customer->getId() : -1;
+        e.date = date;
+        m_changes.publish(std::move(e));
+    }
+    return m_orders.back();
+}
+
+void DataManager::addOrderItem(Order& order, Product* product, int qty) {
+    MemoryScope scope(MemSubsystem::Orders);
+    expireReservations();
+    // Plain stock shortages are reported by Order::addItem
+    if (product && !order.getIsFinalized() && qty > available(*product) &&
+        qty <= product->getQuantity()) {
+        throw InsufficientStockException("Only " + to_string(available(*product)) + " of " +
+                                         product->getName() + " available (rest is reserved).");
+    }
+
+    order.addItem(product, qty);
+    order.calculateTotal();   // the index and snapshot carry the running subtotal
+    m_reservations.reserve(order.getOrderId(), product->getId(), qty, monotonicSeconds());
+    touchOrderRow(rowOf(order));
+    m_epochs.orders++;
+    emitOrderItem(ChangeType::OrderItem, order, product->getId(), qty);
+}
+
+void DataManager::removeOrderItem(Order& order, Product* product) {
+    order.removeItem(product);
+    order.calculateTotal();
+    if (product) m_reservations.release(order.getOrderId(), product->getId());
+    touchOrderRow(rowOf(order));
+    m_epochs.orders++;
+    if (product) emitOrderItem(ChangeType::OrderItemRemove, order, product->getId(), 0);
+}
+
+void DataManager::finalizeOrder(Order& order) {
+    MemoryScope scope(MemSubsystem::Orders);
+    // Lines whose hold lapsed must still fit in what others have not reserved
+    expireReservations();
+    if (!order.getIsFinalized()) {
+        for (const auto& it : order.getItems()) {
+            if (!it.first) continue;
+            const int held = m_reservations.reservedFor(order.getOrderId(), it.first->getId());
+            if (it.second - held > available(*it.first)) {
+                throw InsufficientStockException("Insufficient unreserved stock for product: " +
+                                                 it.first->getName());
+            }
+        }
+    }
+
+    order.finalize(m_finance);
+    m_reservations.releaseOrder(order.getOrderId());
+    touchCustomer(order.getCustomer());
+    m_salesVelocity.recordOrder(order);
+    touchOrderRow(rowOf(order));
+    for (const auto& it : order.getItems()) {
+        if (!it.first) continue;
+        m_stockIndex.update(*it.first);
+        touchProduct(*it.first);
+    }
+
+    if (m_changes.active()) {
+        emitFinalize(order, m_finance.getTransactions().back());
+        for (const auto& it : order.getItems()) emitStock(it.first->getId(), -it.second, true);
+    }
+
+    // Stock, ledger and customer history all move with a finalization
+    m_epochs.orders++;
+    m_epochs.products++;
+    m_epochs.ledger++;
+    m_epochs.customers++;
+}
+
+BatchFinalizeResult DataManager::finalizeBatch(const vector<int>& orderIds) {
+    MemoryScope scope(MemSubsystem::Orders);
+    BatchFinalizeResult result;
+    expireReservations();
+
+    // Pass 1: decide greedily, in request order, against running stock
+    struct Stock {
+        int onHand;
+        int unreserved;   // on hand minus every hold
+    };
+    unordered_map<int, Stock> stock;
+    unordered_set<int> taken;
+    vector<pair<Order*, double>> accepted;
+
+    for (int id : orderIds) {
+        Order* order = findOrder(id);
+        if (!order) {
+            result.failed.emplace_back(id, "Order not found.");
+            continue;
+        }
+        if (taken.count(id)) {
+            result.failed.emplace_back(id, "Order already finalized.");
+            continue;
+        }
+
+        double total;
+        try {
+            total = order->finalTotal();
+        } catch (const exception& e) {
+            result.failed.emplace_back(id, e.what());
+            continue;
+        }
+
+        // Merged per product so a duplicated line cannot slip through
+        unordered_map<Product*, int> need;
+        for (const auto& [p, qty] : order->getItems()) need[p] += qty;
+
+        string shortage;
+        for (const auto& [p, qty] : need) {
+            auto it = stock.find(p->getId());
+            if (it == stock.end()) {
+                it = stock.emplace(p->getId(), Stock{p->getQuantity(), available(*p)}).first;
+            }
+            const int held = m_reservations.reservedFor(id, p->getId());
+            if (qty > it->second.onHand) {
+                shortage = "Insufficient stock for product: " + p->getName();
+            } else if (qty - held > it->second.unreserved) {
+                shortage = "Insufficient unreserved stock for product: " + p->getName();
+            }
+            if (!shortage.empty()) break;
+        }
+        if (!shortage.empty()) {
+            result.failed.emplace_back(id, shortage);
+            continue;
+        }
+
+        for (const auto& [p, qty] : need) {
+            Stock& s = stock[p->getId()];
+            s.onHand -= qty;
+            s.unreserved -= qty - m_reservations.reservedFor(id, p->getId());
+        }
+        taken.insert(id);
+        accepted.emplace_back(order, total);
+    }
+
+    if (accepted.empty()) return result;
+
+    // Pass 2: one stock delta per product, one bulk ledger append
+    unordered_map<int, int> delta;
+    for (const auto& [order, total] : accepted) {
+        for (const auto& [p, qty] : order->getItems()) delta[p->getId()] += qty;
+    }
+    for (const auto& [pid, qty] : delta) {
+        Product* p = findProduct(pid);
+        p->updateStock(-qty);
+        m_stockIndex.update(*p);
+        touchProduct(*p);
+    }
+
+    vector<Finance::Transaction> entries;
+    entries.reserve(accepted.size());
+    for (const auto& [order, total] : accepted) {
+        entries.push_back({"Revenue", total, order->getDate(), "Order #" + to_string(order->getOrderId()),
+                           order->getOrderId()});
+    }
+    m_finance.recordRevenueBatch(entries);
+
+    for (size_t i = 0; i < accepted.size(); ++i) {
+        Order* order = accepted[i].first;
+        const double total = accepted[i].second;
+        order->markFinalized(total);
+        m_reservations.releaseOrder(order->getOrderId());
+        m_salesVelocity.recordOrder(*order);
+        touchCustomer(order->getCustomer());
+        touchOrderRow(rowOf(*order));
+        result.finalized.push_back(order->getOrderId());
+        result.revenue += total;
+        if (m_changes.active()) emitFinalize(*order, entries[i]);
+    }
+    if (m_changes.active()) {
+        for (const auto& [pid, qty] : delta) emitStock(pid, -qty, true);
+    }
+
+    m_epochs.orders++;
+    m_epochs.products++;
+    m_epochs.ledger++;
+    m_epochs.customers++;
+    return result;
+}
+
+Product& DataManager::addProduct(int id, const string& name, double price, double cost, int qty) {
+    MemoryScope scope(MemSubsystem::Products);
+    if (findProduct(id)) {
+        throw InvalidInputException("Product ID already exists: " + to_string(id));
+    }
+
+    Product product(id, name, price, cost, qty);   // validates before touching storage
+
+    const Product* oldBase = m_products.data();
+    const size_t oldCount = m_products.size();
+    m_products.push_back(product);
+    if (m_products.data() != oldBase) relinkOrderProducts(oldBase, oldCount, -1);
+
+    m_productSlot.emplace(id, m_products.size() - 1);
+    m_stockIndex.update(m_products.back());
+    m_epochs.products++;
+    emitProduct(m_products.back());
+    return m_products.back();
+}
+
+void DataManager::updateProduct(Product& product, const string& name, double price, double cost, int qty) {
+    MemoryScope scope(MemSubsystem::Products);
+    Product updated = product;
+    updated.setName(name);
+    updated.setPrice(price);
+    updated.setCost(cost);
+    updated.setQuantity(qty);
+
+    product = updated;
+    m_stockIndex.update(product);
+    touchProduct(product);
+    m_epochs.products++;
+    emitProduct(product);
+}
+
+void DataManager::adjustStock(Product& product, int delta) {
+    product.updateStock(delta);
+    m_stockIndex.update(product);
+    touchProduct(product);
+    m_epochs.products++;
+    emitStock(product.getId(), delta, false);
+}
+
+bool DataManager::productReferenced(int productId) const {
+    for (const auto& o : m_orders) {
+        for (const auto& item : o.getItems()) {
+            if (item.first && item.first->getId() == productId) return true;
+        }
+    }
+    return false;
+}
+
+void DataManager::removeProduct(int productId) {
+    auto slot = m_productSlot.find(productId);
+    if (slot == m_productSlot.end()) {
+        throw InvalidInputException("Product ID not found.");
+    }
+    if (productReferenced(productId)) {
+        throw InvalidInputException("Cannot remove product: it is referenced by existing orders.");
+    }
+
+    const long index = static_cast<long>(slot->second);
+    const Product* oldBase = m_products.data();
+    const size_t oldCount = m_products.size();
+
+    m_products.erase(m_products.begin() + index);
+    relinkOrderProducts(oldBase, oldCount, index);
+
+    m_stockIndex.remove(productId);
+    reindexProducts();
+    m_snapshotStale = true;   // rows shifted and order items were relinked
+    m_epochs.products++;
+    m_epochs.orders++;   // item pointers were relinked
+
+    if (m_changes.active()) {
+        ChangeEvent e;
+        e.type = ChangeType::ProductRemove;
+        e.id = productId;
+        m_changes.publish(std::move(e));
+    }
+}
+
+double DataManager::restockBatch(const vector<pair<int, int>>& lines, const string& date) {
+    MemoryScope scope(MemSubsystem::Ledger);
+    // Validate everything first so the batch is all-or-nothing
+    double total = 0.0;
+    vector<Product*> targets;
+    targets.reserve(lines.size());
+    for (const auto& [pid, qty] : lines) {
+        Product* p = findProduct(pid);
+        if (!p) throw InvalidInputException("Product ID not found: " + to_string(pid));
+        if (qty <= 0) throw InvalidInputException("Restock quantity must be positive.");
+        targets.push_back(p);
+        total += p->getCost() * qty;
+    }
+    if (targets.empty()) return 0.0;
+
+    for (size_t i = 0; i < targets.size(); ++i) {
+        adjustStock(*targets[i], lines[i].second);
+    }
+
+    recordExpense(total, "Batch restock (" + to_string(targets.size()) + " products)", date);
+    return total;
+}
+
+void DataManager::recordExpense(double amount, const string& desc, const string& date) {
+    MemoryScope scope(MemSubsystem::Ledger);
+    m_finance.recordExpense(amount, desc, date);
+    m_epochs.ledger++;
+    emitLedger(m_finance.getTransactions().back(), false);
+}
+
+void DataManager::addCustomer(Customer* customer) {
+    MemoryScope scope(MemSubsystem::Customers);
+    if (!customer) throw InvalidInputException("Customer is null.");
+    if (findCustomer(customer->getId())) {
+        const int id = customer->getId();
+        delete customer;
+        throw InvalidInputException("Customer ID already exists: " + to_string(id));
+    }
+    m_customers.push_back(customer);
+    m_customerSlot[customer->getId()] = m_customers.size() - 1;
+    m_epochs.customers++;
+
+    if (m_changes.active()) {
+        const auto* premium = dynamic_cast<const PremiumCustomer*>(customer);
+        ChangeEvent e;
+        e.type = ChangeType::CustomerUpsert;
+        e.id = customer->getId();
+        e.name = customer->getName();
+        e.ref = premium ? 1 : 0;
+        e.amount = premium ? premium->getLoyaltyPercentage() : 0.0;
+        m_changes.publish(std::move(e));
+    }
+}
+
+size_t DataManager::upgradeCustomers(const vector<int>& customerIds, double loyaltyPercent) {
+    MemoryScope scope(MemSubsystem::Customers);
+    // Validate once up front so a bad value can't leave orders half-repointed
+    if (loyaltyPercent < 0.0 || loyaltyPercent >= 1.0) {
+        throw invalid_argument("Loyalty percent must be in [0.0, 1.0).");
+    }
+
+    unordered_set<int> wanted(customerIds.begin(), customerIds.end());
+    unordered_map<Customer*, Customer*> replaced;
+
+    for (auto*& c : m_customers) {
+        if (!c || !wanted.count(c->getId())) continue;
+        if (dynamic_cast<PremiumCustomer*>(c)) continue;
+
+        Customer* old = c;
+        c->upgradeToPremium(c, loyaltyPercent);   // deletes `old`
+        replaced.emplace(old, c);
+        m_dirtyCustomerRows.push_back(static_cast<size_t>(&c - m_customers.data()));
+
+        if (m_changes.active()) {
+            ChangeEvent e;
+            e.type = ChangeType::CustomerUpgrade;
+            e.id = c->getId();
+            e.amount = loyaltyPercent;
+            m_changes.publish(std::move(e));
+        }
+    }
+
+    // Orders hold raw customer pointers; point them at the new objects
+    if (!replaced.empty()) {
+        for (auto& o : m_orders) {
+            auto it = replaced.find(o.getCustomer());
+            if (it != replaced.end()) o.setCustomer(it->second);
+        }
+        m_epochs.customers++;
+    }
+    return replaced.size();
+}
+
+// ---------------- Change events ----------------
+
+void DataManager::emitProduct(const Product& p) {
+    if (!m_changes.active()) return;
+    ChangeEvent e;
+    e.type = ChangeType::ProductUpsert;
+    e.id = p.getId();
+    e.name = p.getName();
+    e.amount = p.getPrice();
+    e.cost = p.getCost();
+    e.qty = p.getQuantity();
+    m_changes.publish(std::move(e));
+}
+
+void DataManager::emitStock(int productId, int delta, bool derived) {
+    if (!m_changes.active()) return;
+    ChangeEvent e;
+    e.type = ChangeType::StockDelta;
+    e.derived = derived;
+    e.id = productId;
+    e.qty = delta;
+    m_changes.publish(std::move(e));
+}
+
+void DataManager::emitLedger(const Finance::Transaction& t, bool derived) {
+    if (!m_changes.active()) return;
+    ChangeEvent e;
+    e.type = ChangeType::LedgerAppend;
+    e.derived = derived;
+    e.ref = t.type == "Revenue" ? 1 : 0;
+    e.amount = t.amount;
+    e.name = t.description;
+    e.date = t.date;
+    m_changes.publish(std::move(e));
+}
+
+void DataManager::emitOrderItem(ChangeType type, const Order& order, int productId, int qty) {
+    if (!m_changes.active()) return;
+    ChangeEvent e;
+    e.type = type;
+    e.id = order.getOrderId();
+    e.ref = productId;
+    e.qty = qty;
+    m_changes.publish(std::move(e));
+}
+
+// A finalization, followed by its revenue entry as a derived event
+void DataManager::emitFinalize(const Order& order, const Finance::Transaction& revenue) {
+    ChangeEvent e;
+    e.type = ChangeType::OrderFinalize;
+    e.id = order.getOrderId();
+    e.amount = order.getTotalAmount();
+    m_changes.publish(std::move(e));
+    emitLedger(revenue, true);
+}
+
+ChangeFeed& DataManager::changes() { return m_changes; }
+
+const OrderArchive& DataManager::archive() const { return m_archive; }
+
+size_t DataManager::archiveOrders(const string& dataDir, const string& cutoff) {
+    int cutoffDay;
+    if (!DateUtil::toDayNumber(cutoff, cutoffDay)) {
+        throw InvalidInputException("Invalid cutoff date: " + cutoff);
+    }
+
+    vector<const Order*> cold;
+    for (const auto& o : m_orders) {
+        int day;
+        if (o.getIsFinalized() && DateUtil::toDayNumber(o.getDate(), day) && day < cutoffDay) cold.push_back(&o);
+    }
+    if (cold.empty()) return 0;
+
+    // The segment is on disk before anything leaves memory
+    m_archive.append(dataDir, cold);
+
+    m_orders.erase(remove_if(m_orders.begin(), m_orders.end(),
+                             [this](const Order& o) { return m_archive.contains(o.getOrderId()); }),
+                   m_orders.end());
+    m_salesVelocity.rebuild(m_orders);
+    m_orderIndex.rebuild(m_orders);
+    m_dirtyOrderRows.clear();
+    m_snapshotStale = true;
+    m_epochs.orders++;
+    return cold.size();
+}
+
+MemoryReport DataManager::memoryUsage() const {
+    MemoryUsage products{"Products", m_products.size(), memsize::heap(m_products), memsize::slack(m_products)};
+    for (const auto& p : m_products) products.bytes += memsize::heap(p.getName());
+
+    MemoryUsage customers{"Customers", m_customers.size(), memsize::heap(m_customers), memsize::slack(m_customers)};
+    MemoryUsage history{"Order history", 0, 0, 0};
+    for (const Customer* c : m_customers) {
+        customers.bytes += dynamic_cast<const PremiumCustomer*>(c) ? sizeof(PremiumCustomer) : sizeof(RegularCustomer);
+        customers.bytes += memsize::heap(c->getName());
+        history.objects += c->getOrderHistory().size();
+        history.bytes += memsize::heap(c->getOrderHistory());
+        history.slack += memsize::slack(c->getOrderHistory());
+    }
+
+    MemoryUsage orders{"Orders", m_orders.size(), memsize::heap(m_orders), memsize::slack(m_orders)};
+    MemoryUsage items{"Order items", 0, 0, 0};
+    for (const auto& o : m_orders) {
+        orders.bytes += memsize::heap(o.getDate());
+        items.objects += o.getItems().size();
+        items.bytes += memsize::heap(o.getItems());
+        items.slack += memsize::slack(o.getItems());
+    }
+
+    const auto& tx = m_finance.getTransactions();
+    MemoryUsage ledger{"Ledger", tx.size(), memsize::heap(tx), memsize::slack(tx)};
+    for (const auto& t : tx) {
+        ledger.bytes += memsize::heap(t.type) + memsize::heap(t.date) + memsize::heap(t.description);
+    }
+
+    MemoryUsage indexes{"Indexes", m_orderIndex.size() + m_productSlot.size(), 0, 0};
+    indexes.bytes = m_orderIndex.memoryBytes() + m_ledgerIndex.memoryBytes() + memsize::heap(m_productSlot);
+
+    MemoryReport report;
+    report.collections = {products, customers, history, orders, items, ledger, indexes};
+    return report;
+}
+
 // Accessors
 vector<Product>& DataManager::products() { return m_products; }
 vector<Customer*>& DataManager::customers() { return m_customers; }
@@ -61,4 +852,8 @@ Finance& DataManager::finance() { return m_finance; }
 const vector<Product>& DataManager::products() const { return m_products; }
 const vector<Customer*>& DataManager::customers() const { return m_customers; }
 const vector<Order>& DataManager::orders() const { return m_orders; }
-const Finance& DataManager::finance() const { return m_finance; }
\ No newline at end of file
+const Finance& DataManager::finance() const { return m_finance; }
+const SalesVelocity& DataManager::salesVelocity() const { return m_salesVelocity; }
+StockIndex& DataManager::stockIndex() { return m_stockIndex; }
+const DataEpochs& DataManager::epochs() const { return m_epochs; }
+const StockIndex& DataManager::stockIndex() const { return m_stockIndex; }
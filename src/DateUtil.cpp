@@ -0,0 +1,97 @@
+#include "DateUtil.h"
+
+#include <cctype>
+#include <cstdio>
+#include <ctime>
+
+namespace {
+// Howard Hinnant's days_from_civil / civil_from_days (proleptic Gregorian).
+int daysFromCivil(int y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int>(doe) - 719468;
+}
+
+void civilFromDays(int z, int& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    const int era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int>(yoe) + era * 400 + (m <= 2);
+}
+
+bool readDigits(const std::string& s, size_t pos, size_t len, int& out) {
+    out = 0;
+    for (size_t i = pos; i < pos + len; ++i) {
+        if (!std::isdigit(static_cast<unsigned char>(s[i]))) return false;
+        out = out * 10 + (s[i] - '0');
+    }
+    return true;
+}
+
+unsigned daysInMonth(int y, unsigned m) {
+    static const unsigned kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+    return m == 2 && leap ? 29 : kDays[m - 1];
+}
+} // namespace
+
+bool DateUtil::toDayNumber(const std::string& iso, int& day) {
+    if (iso.size() != 10 || iso[4] != '-' || iso[7] != '-') return false;
+
+    int y, m, d;
+    if (!readDigits(iso, 0, 4, y) || !readDigits(iso, 5, 2, m) || !readDigits(iso, 8, 2, d)) {
+        return false;
+    }
+    if (m < 1 || m > 12 || d < 1 || static_cast<unsigned>(d) > daysInMonth(y, static_cast<unsigned>(m))) {
+        return false;
+    }
+
+    day = daysFromCivil(y, static_cast<unsigned>(m), static_cast<unsigned>(d));
+    return true;
+}
+
+std::string DateUtil::fromDayNumber(int day) {
+    int y;
+    unsigned m, d;
+    civilFromDays(day, y, m, d);
+
+    // civilFromDays keeps m and d in range, but size for any int/unsigned so
+    // the compiler can prove nothing is truncated
+    char buffer[40];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02u-%02u", y, m, d);
+    return std::string(buffer);
+}
+
+int DateUtil::todayDayNumber() {
+    std::time_t now = std::time(nullptr);
+    std::tm localTm{};
+#ifdef _WIN32
+    localtime_s(&localTm, &now);
+#else
+    localtime_r(&now, &localTm);
+#endif
+    return daysFromCivil(localTm.tm_year + 1900,
+                         static_cast<unsigned>(localTm.tm_mon + 1),
+                         static_cast<unsigned>(localTm.tm_mday));
+}
+
+std::string DateUtil::localTimestamp() {
+    std::time_t now = std::time(nullptr);
+    std::tm localTm{};
+#ifdef _WIN32
+    localtime_s(&localTm, &now);
+#else
+    localtime_r(&now, &localTm);
+#endif
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &localTm);
+    return std::string(buffer);
+}
@@ -3,83 +3,238 @@
 #include "RegularCustomer.h"
 #include "PremiumCustomer.h"
 #include "Finance.h"
+#include "Trace.h"
 
+#include <algorithm>
 #include <fstream>
+#include <iterator>
+#include <unordered_map>
 #include <sstream>
 #include <stdexcept>
 #include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
 using namespace std;
 
 // ---------------- Helpers ----------------
 
-vector<string> FileManager::split(const string& s, char delim) {
-    vector<string> out;
-    stringstream ss(s);
-    string item;
-    while (getline(ss, item, delim)) out.push_back(item);
+namespace {
+// Lines per scratch reset: long enough to amortize release(), short enough
+// that the arena stays in the stack block for ordinary lines.
+const size_t kScratchLines = 256;
+
+// Scratch memory for one load: a stack block first, heap blocks if a line
+// needs more, all dropped together every kScratchLines lines.
+class LineScratch {
+public:
+    LineScratch() : arena(buffer, sizeof(buffer)) {}
+
+    std::pmr::memory_resource* resource() { return &arena; }
+
+    // Call at the top of each line, after the previous line's fields are gone.
+    void nextLine() {
+        if (++lines % kScratchLines == 0) arena.release();
+    }
+
+    size_t lineCount() const { return lines; }
+
+private:
+    alignas(std::max_align_t) std::byte buffer[8 * 1024];
+    std::pmr::monotonic_buffer_resource arena;
+    size_t lines = 0;
+};
+
+// Walks a file's text line by line the way getline walks the stream it was
+// read from: there is no empty line after a final newline
+class LineReader {
+public:
+    explicit LineReader(string_view text) : text(text) {}
+
+    bool next(string_view& line) {
+        if (pos >= text.size()) return false;
+        size_t end = text.find('\n', pos);
+        if (end == string_view::npos) end = text.size();
+        line = text.substr(pos, end - pos);
+        pos = end + 1;
+        return true;
+    }
+
+    void rewind() { pos = 0; }
+
+private:
+    string_view text;
+    size_t pos = 0;
+};
+
+// Upper bound on the rows in a file, for reserving before parsing
+size_t lineEstimate(string_view text) {
+    return static_cast<size_t>(count(text.begin(), text.end(), '\n')) + 1;
+}
+
+// Span arguments and counters for the loaders and savers
+void traceRows(TraceSpan& span, size_t rows) {
+    if (!span.isActive()) return;
+    span.arg("rows", static_cast<int64_t>(rows));
+    Trace::add(TraceCounter::RowsParsed, static_cast<int64_t>(rows));
+}
+
+void traceBytes(TraceSpan& span, ofstream& out) {
+    if (!span.isActive()) return;
+    const auto bytes = static_cast<int64_t>(out.tellp());
+    span.arg("bytes", bytes);
+    Trace::add(TraceCounter::BytesWritten, bytes);
+}
+
+// strtol/strtod need a terminated string; short fields are copied to the stack
+const char* terminated(string_view field, char (&buf)[64], string& overflow) {
+    if (field.size() < sizeof(buf)) {
+        memcpy(buf, field.data(), field.size());
+        buf[field.size()] = '\0';
+        return buf;
+    }
+    overflow.assign(field);
+    return overflow.c_str();
+}
+
+// The order behind a revenue entry in a finance file that predates the
+// OrderID column: "Order #<id>" as Order::finalize wrote it, optionally
+// followed by a comma and a note
+int legacyOrderId(string_view desc) {
+    const string_view prefix = "Order #";
+    if (desc.substr(0, prefix.size()) != prefix) return -1;
+    size_t i = prefix.size();
+    long long id = 0;
+    for (; i < desc.size() && desc[i] >= '0' && desc[i] <= '9'; ++i) {
+        id = id * 10 + (desc[i] - '0');
+        if (id > INT_MAX) return -1;
+    }
+    if (i == prefix.size() || (i < desc.size() && desc[i] != ',')) return -1;
+    return static_cast<int>(id);
+}
+} // namespace
+
+pmr::vector<string_view> FileManager::split(string_view s, char delim, pmr::memory_resource* scratch) {
+    // Same pieces as getline(stream, item, delim): no piece after a trailing delimiter
+    pmr::vector<string_view> out(scratch);
+    size_t pos = 0;
+    while (pos < s.size()) {
+        const size_t end = s.find(delim, pos);
+        if (end == string_view::npos) {
+            out.push_back(s.substr(pos));
+            break;
+        }
+        out.push_back(s.substr(pos, end - pos));
+        pos = end + 1;
+    }
     return out;
 }
 
-string FileManager::trim(const string& s) {
+string_view FileManager::trim(string_view s) {
     size_t b = 0, e = s.size();
     while (b < e && isspace(static_cast<unsigned char>(s[b]))) b++;
     while (e > b && isspace(static_cast<unsigned char>(s[e - 1]))) e--;
     return s.substr(b, e - b);
 }
 
-Product* FileManager::findProductById(vector<Product>& products, int id) {
-    for (auto& p : products) {
-        if (p.getId() == id) return &p;
-    }
-    return nullptr;
+int FileManager::toInt(string_view field) {
+    char buf[64];
+    string overflow;
+    const char* text = terminated(field, buf, overflow);
+
+    char* end;
+    errno = 0;
+    const long value = strtol(text, &end, 10);
+    if (end == text) throw invalid_argument("stoi");
+    if (errno == ERANGE || value < INT_MIN || value > INT_MAX) throw out_of_range("stoi");
+    return static_cast<int>(value);
 }
 
-Customer* FileManager::findCustomerById(vector<Customer*>& customers, int id) {
-    for (auto* c : customers) {
-        if (c && c->getId() == id) return c;
+double FileManager::toDouble(string_view field) {
+    char buf[64];
+    string overflow;
+    const char* text = terminated(field, buf, overflow);
+
+    char* end;
+    errno = 0;
+    const double value = strtod(text, &end);
+    if (end == text) throw invalid_argument("stod");
+    if (errno == ERANGE) throw out_of_range("stod");
+    return value;
+}
+
+string FileManager::readFile(const string& filepath, const char* kind) {
+    TraceSpan span("FileManager::readFile");
+    ifstream in(filepath, ios::binary);
+    if (!in.is_open()) throw FileOperationException(string("Failed to open ") + kind + " file: " + filepath);
+
+    string text;
+    in.seekg(0, ios::end);
+    const streamoff size = in.tellg();
+    if (size >= 0) {
+        // One allocation and one read for the whole file
+        text.resize(static_cast<size_t>(size));
+        in.seekg(0);
+        in.read(&text[0], size);
+        text.resize(static_cast<size_t>(in.gcount()));
+    } else {
+        // Not seekable
+        in.clear();
+        text.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
     }
-    return nullptr;
+    span.arg("bytes", static_cast<int64_t>(text.size()));
+    return text;
 }
 
 // ---------------- Products ----------------
 
 vector<Product> FileManager::loadProducts(const string& filepath) {
-    ifstream in(filepath);
-    if (!in.is_open()) throw FileOperationException("Failed to open products file: " + filepath);
+    return parseProducts(readFile(filepath, "products"));
+}
 
+vector<Product> FileManager::parseProducts(string_view text) {
+    TraceSpan span("FileManager::parseProducts");
     vector<Product> products;
-    string line;
+    LineReader lines(text);
+    string_view line;
 
     // optional header
-    if (getline(in, line)) {
-        if (line.find("ID") == string::npos) {
+    if (lines.next(line)) {
+        if (line.find("ID") == string_view::npos) {
             // first line is data, process it
-            in.seekg(0);
+            lines.rewind();
         }
     } else {
         return products; // empty file
     }
 
-    while (getline(in, line)) {
-        line = trim(line);
-        if (line.empty()) continue;
+    products.reserve(lineEstimate(text));
+    LineScratch scratch;
+    while (lines.next(line)) {
+        scratch.nextLine();
+        const string_view row = trim(line);
+        if (row.empty()) continue;
 
-        auto cols = split(line, ',');
-        if (cols.size() < 5) throw FileOperationException("Invalid products line: " + line);
+        auto cols = split(row, ',', scratch.resource());
+        if (cols.size() < 5) throw FileOperationException("Invalid products line: " + string(row));
 
-        int id = stoi(trim(cols[0]));
-        string name = trim(cols[1]);
-        double price = stod(trim(cols[2]));
-        double cost = stod(trim(cols[3]));
-        int qty = stoi(trim(cols[4]));
+        int id = toInt(trim(cols[0]));
+        string name(trim(cols[1]));
+        double price = toDouble(trim(cols[2]));
+        double cost = toDouble(trim(cols[3]));
+        int qty = toInt(trim(cols[4]));
 
         products.emplace_back(id, name, price, cost, qty);
     }
 
+    traceRows(span, scratch.lineCount());
     return products;
 }
 
 void FileManager::saveProducts(const vector<Product>& products, const string& filepath) {
+    TraceSpan span("FileManager::saveProducts");
     ofstream out(filepath);
     if (!out.is_open()) throw FileOperationException("Failed to write products file: " + filepath);
 
@@ -91,6 +246,7 @@ void FileManager::saveProducts(const vector<Product>& products, const string& fi
             << p.getCost() << ","
             << p.getQuantity() << "\n";
     }
+    traceBytes(span, out);
 }
 
 // ---------------- Customers ----------------
@@ -101,33 +257,38 @@ void FileManager::saveProducts(const vector<Product>& products, const string& fi
 // 102,Bob,Premium,10,3
 
 vector<Customer*> FileManager::loadCustomers(const string& filepath) {
-    ifstream in(filepath);
-    if (!in.is_open()) throw FileOperationException("Failed to open customers file: " + filepath);
+    return parseCustomers(readFile(filepath, "customers"));
+}
 
+vector<Customer*> FileManager::parseCustomers(string_view text) {
+    TraceSpan span("FileManager::parseCustomers");
     vector<Customer*> customers;
-    string line;
+    LineReader lines(text);
+    string_view line;
 
-    if (getline(in, line)) {
-        if (line.find("Type") == string::npos) {
-            in.clear();
-            in.seekg(0);
+    if (lines.next(line)) {
+        if (line.find("Type") == string_view::npos) {
+            lines.rewind();
         }
     } else {
         return customers;
     }
 
+    customers.reserve(lineEstimate(text));
+    LineScratch scratch;
     try {
-        while (getline(in, line)) {
-            line = trim(line);
-            if (line.empty()) continue;
+        while (lines.next(line)) {
+            scratch.nextLine();
+            const string_view row = trim(line);
+            if (row.empty()) continue;
 
-            auto cols = split(line, ',');
-            if (cols.size() < 4) throw FileOperationException("Invalid customers line: " + line);
+            auto cols = split(row, ',', scratch.resource());
+            if (cols.size() < 4) throw FileOperationException("Invalid customers line: " + string(row));
 
-            int id = stoi(trim(cols[0]));
-            string name = trim(cols[1]);
-            string type = trim(cols[2]);
-            double loyalty = stod(trim(cols[3]));
+            int id = toInt(trim(cols[0]));
+            string name(trim(cols[1]));
+            string_view type = trim(cols[2]);
+            double loyalty = toDouble(trim(cols[3]));
 
             Customer* c = nullptr;
             if (type == "Premium") {
@@ -135,15 +296,16 @@ vector<Customer*> FileManager::loadCustomers(const string& filepath) {
             } else if (type == "Regular") {
                 c = new RegularCustomer(id, name);
             } else {
-                throw FileOperationException("Unknown customer type: " + type);
+                throw FileOperationException("Unknown customer type: " + string(type));
             }
             if (cols.size() >= 5) {
-                string hist = trim(cols[4]);
+                string_view hist = trim(cols[4]);
                 if (!hist.empty()) {
-                    auto ids = split(hist, ';');
+                    auto ids = split(hist, ';', scratch.resource());
+                    c->reserveHistory(ids.size());
                     for (const auto& sId : ids) {
-                        string t = trim(sId);
-                        if (!t.empty()) c->addOrderToHistory(stoi(t));
+                        string_view t = trim(sId);
+                        if (!t.empty()) c->addOrderToHistory(toInt(t));
                     }
                 }
             }
@@ -155,10 +317,12 @@ vector<Customer*> FileManager::loadCustomers(const string& filepath) {
         throw;
     }
 
+    traceRows(span, scratch.lineCount());
     return customers;
 }
 
 void FileManager::saveCustomers(const vector<Customer*>& customers, const string& filepath) {
+    TraceSpan span("FileManager::saveCustomers");
     ofstream out(filepath);
     if (!out.is_open()) throw FileOperationException("Failed to write customers file: " + filepath);
 
@@ -188,98 +352,143 @@ void FileManager::saveCustomers(const vector<Customer*>& customers, const string
         }
         out << "\n";
     }
+    traceBytes(span, out);
 }
 
 // ---------------- Orders ----------------
 // Format:
 // OrderID,CustomerID,Date,TotalAmount,Finalized,Items
 // Items: product_id:qty;product_id:qty
-vector<Order>FileManager::loadOrders(const string& filepath,vector<Product> &products,vector<Customer*>& customers){
-    std::ifstream in(filepath);
-    if(!in.is_open()){
-        throw FileOperationException("Failed to open orders file: " + filepath);
-    }
-    vector<Order> orders;
-    string line;
+vector<Order> FileManager::loadOrders(const string& filepath, vector<Product>& products,
+                                      vector<Customer*>& customers) {
+    ParsedOrders parsed = parseOrders(readFile(filepath, "orders"));
+    return resolveOrders(parsed, products, customers);
+}
+
+ParsedOrders FileManager::parseOrders(string_view text) {
+    TraceSpan span("FileManager::parseOrders");
+    ParsedOrders parsed;
+    LineReader lines(text);
+    string_view line;
 
-    // Optional header: clear stream errors before seeking to prevent EOF bugs
-    if (std::getline(in, line)) {
-        if (line.find("OrderID") == std::string::npos) {
-            in.clear(); 
-            in.seekg(0);
+    // Optional header
+    if (lines.next(line)) {
+        if (line.find("OrderID") == string_view::npos) {
+            lines.rewind();
         }
     } else {
-        return orders;
+        return parsed;
     }
 
-    while(getline(in,line)){
-        line = trim(line);
-        if(line.empty()){
+    parsed.rows.reserve(lineEstimate(text));
+    LineScratch scratch;
+    while (lines.next(line)) {
+        scratch.nextLine();
+        const string_view row = trim(line);
+        if (row.empty()) {
             continue;
         }
-        if(line.find("OrderID") != string::npos){
+        if (row.find("OrderID") != string_view::npos) {
             continue;
         }
-        auto cols = split(line,',');
+        auto cols = split(row, ',', scratch.resource());
         // Change to < 5, because an empty trailing item list makes the size 5
-        if(cols.size() < 5){
-            throw FileOperationException("Invalid orders line: " + line);
-        }
-        int orderId = stoi(trim(cols[0]));
-        int customerId = stoi(trim(cols[1]));
-        string date = trim(cols[2]);
-        double historicalTotal = stod(trim(cols[3]));
-        string finalizedStr = trim(cols[4]);
-        string itemsStr = (cols.size() >= 6) ? trim(cols[5]) : "";
-
-        Customer* c = nullptr;
-        if(customerId!=-1){
-            c = findCustomerById(customers,customerId);
-            if(!c){
-                throw FileOperationException("Order references missing customerId: " + std::to_string(customerId));
-            }
-
+        if (cols.size() < 5) {
+            throw FileOperationException("Invalid orders line: " + string(row));
         }
 
-        Order o(orderId, c, date);
-        if(!itemsStr.empty()){
-            auto itemPairs = split(itemsStr, ';');
-            for(const auto& ip : itemPairs){
-                string trimmedIp = trim(ip);
+        ParsedOrders::Row r;
+        r.orderId = toInt(trim(cols[0]));
+        r.customerId = toInt(trim(cols[1]));
+        r.date = string(trim(cols[2]));
+        r.total = toDouble(trim(cols[3]));
+        const string_view finalizedStr = trim(cols[4]);
+        r.finalized = (finalizedStr == "true" || finalizedStr == "1" ||
+                       finalizedStr == "Yes"  || finalizedStr == "yes");
+        r.firstItem = parsed.items.size();
+
+        const string_view itemsStr = (cols.size() >= 6) ? trim(cols[5]) : string_view();
+        if (!itemsStr.empty()) {
+            auto itemPairs = split(itemsStr, ';', scratch.resource());
+            for (const auto& ip : itemPairs) {
+                string_view trimmedIp = trim(ip);
                 if (trimmedIp.empty()) continue;
-            
-                auto parts = split(trimmedIp, ':');
+
+                auto parts = split(trimmedIp, ':', scratch.resource());
                 if (parts.size() != 2) {
-                    throw FileOperationException("Invalid order item: " + trimmedIp);
+                    throw FileOperationException("Invalid order item: " + string(trimmedIp));
                 }
-                
-                int pid = stoi(trim(parts[0]));
-                int qty = stoi(trim(parts[1]));
-
-                Product* p = nullptr;
-                if (pid != -1) {
-                    p = findProductById(products, pid);
-                    if (!p) {
-                        throw FileOperationException("Order references missing productId: " + to_string(pid));
-                    }
+                parsed.items.emplace_back(toInt(trim(parts[0])), toInt(trim(parts[1])));
+            }
+        }
+        r.itemCount = parsed.items.size() - r.firstItem;
+        parsed.rows.push_back(std::move(r));
+    }
 
-                    // Rebuild historical items without validating against current stock.
-                    o.addLoadedItem(p, qty);
-                }
+    traceRows(span, scratch.lineCount());
+    return parsed;
+}
+
+vector<Order> FileManager::resolveOrders(ParsedOrders& parsed, vector<Product>& products,
+                                         vector<Customer*>& customers) {
+    TraceSpan span("FileManager::resolveOrders");
+
+    // First occurrence wins for duplicate IDs, as a front-to-back scan would
+    unordered_map<int, Product*> productById;
+    productById.reserve(products.size());
+    for (auto& p : products) productById.emplace(p.getId(), &p);
+
+    unordered_map<int, Customer*> customerById;
+    customerById.reserve(customers.size());
+    for (auto* c : customers) {
+        if (c) customerById.emplace(c->getId(), c);
+    }
+
+    vector<Order> orders;
+    orders.reserve(parsed.rows.size());
+    size_t lookups = 0;
+    for (auto& r : parsed.rows) {
+        Customer* c = nullptr;
+        if (r.customerId != -1) {
+            lookups++;
+            auto it = customerById.find(r.customerId);
+            if (it == customerById.end()) {
+                throw FileOperationException("Order references missing customerId: " + to_string(r.customerId));
             }
+            c = it->second;
         }
-        o.setTotalAmount(historicalTotal);
-        bool finalized = (finalizedStr == "true" || finalizedStr == "1" ||
-                          finalizedStr == "Yes"  || finalizedStr == "yes");
 
-        o.setFinalized(finalized);
+        Order o(r.orderId, c, r.date);
+        o.reserveItems(r.itemCount);
+        for (size_t i = r.firstItem; i < r.firstItem + r.itemCount; ++i) {
+            const int pid = parsed.items[i].first;
+            if (pid == -1) continue;
 
-        orders.push_back(o);
+            lookups++;
+            auto it = productById.find(pid);
+            if (it == productById.end()) {
+                throw FileOperationException("Order references missing productId: " + to_string(pid));
+            }
+            // Rebuild historical items without validating against current stock.
+            o.addLoadedItem(it->second, parsed.items[i].second);
+        }
+        // Open orders carry their running subtotal; older files saved 0
+        if (r.finalized) o.setTotalAmount(r.total);
+        else o.calculateTotal();
+        o.setFinalized(r.finalized);
 
+        orders.push_back(std::move(o));
+    }
+
+    if (span.isActive()) {
+        span.arg("lookups", static_cast<int64_t>(lookups));
+        Trace::add(TraceCounter::Lookups, static_cast<int64_t>(lookups));
     }
     return orders;
 }
+
 void FileManager::saveOrders(const vector<Order>& orders, const string& filepath) {
+    TraceSpan span("FileManager::saveOrders");
     ofstream out(filepath);
     if (!out.is_open()) throw FileOperationException("Failed to write orders file: " + filepath);
 
@@ -301,85 +510,180 @@ void FileManager::saveOrders(const vector<Order>& orders, const string& filepath
         }
         out << "\n";
     }
+    traceBytes(span, out);
 }
 
 // ---------------- Finance ----------------
 // Format:
 // TotalRevenue,TotalExpenses
 // revenue,expenses
-// TransactionType,Amount,Date,Description
+// TransactionType,Amount,Date,OrderID,Description
 // ...
+// OrderID is the order a revenue entry came from, or -1. Files written
+// before the column existed have no OrderID; their order revenue is
+// recognised by its "Order #<id>" description.
 
 Finance FileManager::loadFinance(const string& filepath) {
-    ifstream in(filepath);
-    if (!in.is_open()) {
-        throw FileOperationException("Failed to open finance file: " + filepath);
-    }
+    return parseFinance(readFile(filepath, "finance"));
+}
 
+Finance FileManager::parseFinance(string_view text) {
+    TraceSpan span("FileManager::parseFinance");
     Finance f;
-    string line;
+    LineReader lines(text);
+    string_view line;
 
     // 1) Header: "TotalRevenue,TotalExpenses"
-    if (!getline(in, line)) return f;
+    if (!lines.next(line)) return f;
 
     // 2) Totals line: "300,204800"
-    if (!getline(in, line)) return f;
+    if (!lines.next(line)) return f;
 
-    // 3) Transaction header: "TransactionType,Amount,Date,Description"
-    if (!getline(in, line)) return f;
+    // 3) Transaction header: "TransactionType,Amount,Date,OrderID,Description",
+    //    or the older one without OrderID
+    if (!lines.next(line)) return f;
+    const bool hasOrderId = trim(line).find(",OrderID,") != string_view::npos;
+    const size_t descColumn = hasOrderId ? 4 : 3;
 
     // 4) Transactions
-    while (getline(in, line)) {
-        line = trim(line);
-        if (line.empty()) continue;
-
-        auto cols = split(line, ',');
-        if (cols.size() < 4) {
-            throw FileOperationException("Invalid finance transaction line: " + line);
+    LineScratch scratch;
+    while (lines.next(line)) {
+        scratch.nextLine();
+        const string_view row = trim(line);
+        if (row.empty()) continue;
+
+        auto cols = split(row, ',', scratch.resource());
+        if (cols.size() < descColumn + 1) {
+            throw FileOperationException("Invalid finance transaction line: " + string(row));
         }
 
-        string type = trim(cols[0]);
-        string amountStr = trim(cols[1]);
-        string date = trim(cols[2]);
-        
-        string desc = cols[3];
-        for (size_t i = 4; i < cols.size(); ++i) {
-            desc += "," + cols[i];
-        }
-        desc = trim(desc);
+        string_view type = trim(cols[0]);
+        string_view amountStr = trim(cols[1]);
+        string date(trim(cols[2]));
+
+        // The description may itself contain commas: it runs to the end of the row
+        string desc(trim(row.substr(static_cast<size_t>(cols[descColumn].data() - row.data()))));
 
         if (desc.find("Loaded total") != string::npos) continue;
 
         double amount;
         try {
-            amount = stod(amountStr);
+            amount = toDouble(amountStr);
         } catch (...) {
-            throw FileOperationException("Invalid amount '" + amountStr + "' in line: " + line);
+            throw FileOperationException("Invalid amount '" + string(amountStr) + "' in line: " + string(row));
+        }
+
+        int orderId = -1;
+        if (hasOrderId) {
+            const string_view idStr = trim(cols[3]);
+            if (!idStr.empty()) {
+                try {
+                    orderId = toInt(idStr);
+                } catch (...) {
+                    throw FileOperationException("Invalid order ID '" + string(idStr) + "' in line: " + string(row));
+                }
+            }
+        } else if (type == "Revenue") {
+            orderId = legacyOrderId(desc);
         }
 
         if (type == "Revenue") {
-            f.recordRevenue(amount, desc, date);
+            f.recordRevenue(amount, desc, date, orderId);
         } else if (type == "Expense") {
             f.recordExpense(amount, desc, date);
         } else {
-            throw FileOperationException("Unknown transaction type: " + type);
+            throw FileOperationException("Unknown transaction type: " + string(type));
         }
     }
 
+    traceRows(span, scratch.lineCount());
     return f;
 }
 void FileManager::saveFinance(const Finance& finance, const string& filepath) {
+    TraceSpan span("FileManager::saveFinance");
     ofstream out(filepath);
     if (!out.is_open()) throw FileOperationException("Failed to write finance file: " + filepath);
 
     out << "TotalRevenue,TotalExpenses\n";
     out << finance.getTotalRevenue() << "," << finance.getTotalExpenses() << "\n";
-    out << "TransactionType,Amount,Date,Description\n";
+    out << "TransactionType,Amount,Date,OrderID,Description\n";
 
     for (const auto& t : finance.getTransactions()) {
         out << t.type << ","
             << t.amount << ","
             << t.date << ","
+            << t.orderId << ","
             << t.description << "\n";
     }
+    traceBytes(span, out);
+}
+
+// ---------------- Snapshots ----------------
+// Mirrors the live save functions above, field for field.
+
+void FileManager::saveProducts(const ChunkedRows<ProductRow>& products, const string& filepath) {
+    TraceSpan span("FileManager::saveProducts");
+    span.arg("snapshot", 1);
+    ofstream out(filepath);
+    if (!out.is_open()) throw FileOperationException("Failed to write products file: " + filepath);
+
+    out << "ID,Name,Price,Cost,Quantity\n";
+    products.forEach([&out](const ProductRow& p) {
+        out << p.id << "," << p.name << "," << p.price << "," << p.cost << "," << p.quantity << "\n";
+    });
+    traceBytes(span, out);
+}
+
+void FileManager::saveCustomers(const ChunkedRows<CustomerRow>& customers, const string& filepath) {
+    TraceSpan span("FileManager::saveCustomers");
+    span.arg("snapshot", 1);
+    ofstream out(filepath);
+    if (!out.is_open()) throw FileOperationException("Failed to write customers file: " + filepath);
+
+    out << "ID,Name,Type,LoyaltyPercentage,OrderIDs\n";
+    customers.forEach([&out](const CustomerRow& c) {
+        out << c.id << "," << c.name << "," << (c.premium ? "Premium" : "Regular") << ","
+            << c.loyaltyPercent << ",";
+        for (size_t i = 0; i < c.orderIds.size(); i++) {
+            out << c.orderIds[i];
+            if (i + 1 < c.orderIds.size()) out << ";";
+        }
+        out << "\n";
+    });
+    traceBytes(span, out);
+}
+
+void FileManager::saveOrders(const ChunkedRows<OrderRow>& orders, const string& filepath) {
+    TraceSpan span("FileManager::saveOrders");
+    span.arg("snapshot", 1);
+    ofstream out(filepath);
+    if (!out.is_open()) throw FileOperationException("Failed to write orders file: " + filepath);
+
+    out << "OrderID,CustomerID,Date,TotalAmount,Finalized,Items\n";
+    orders.forEach([&out](const OrderRow& o) {
+        out << o.orderId << "," << o.customerId << "," << o.date << "," << o.total << ","
+            << (o.finalized ? "true" : "false") << ",";
+        for (size_t i = 0; i < o.items.size(); i++) {
+            out << o.items[i].first << ":" << o.items[i].second;
+            if (i + 1 < o.items.size()) out << ";";
+        }
+        out << "\n";
+    });
+    traceBytes(span, out);
+}
+
+void FileManager::saveFinance(const Snapshot& snapshot, const string& filepath) {
+    TraceSpan span("FileManager::saveFinance");
+    span.arg("snapshot", 1);
+    ofstream out(filepath);
+    if (!out.is_open()) throw FileOperationException("Failed to write finance file: " + filepath);
+
+    out << "TotalRevenue,TotalExpenses\n";
+    out << snapshot.totalRevenue << "," << snapshot.totalExpenses << "\n";
+    out << "TransactionType,Amount,Date,OrderID,Description\n";
+
+    snapshot.ledger.forEach([&out](const LedgerRow& t) {
+        out << t.type << "," << t.amount << "," << t.date << "," << t.orderId << "," << t.description << "\n";
+    });
+    traceBytes(span, out);
 }
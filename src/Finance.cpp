@@ -1,10 +1,17 @@
 #include "Finance.h"
+#include "DateUtil.h"
+
+#include <algorithm>
+#include <climits>
 #include <iostream>
 #include <iomanip>
+#include <stdexcept>
 
 using namespace std;
 
-Finance::Finance() : totalRevenue(0.0), totalExpenses(0.0) {}
+Finance::Finance()
+    : totalRevenue(0.0), totalExpenses(0.0), baseDay(0), firstTreeDay(0), lastTreeDay(0), treeEntries(0),
+      outlierLimit(0) {}
 
 double Finance::getTotalRevenue() const {
     return totalRevenue;
@@ -24,20 +31,194 @@ void Finance::recordExpense(double amount, const string& desc, const string& dat
     }
     totalExpenses += amount;
     transactions.push_back({"Expense", amount, date.empty() ? "N/A" : date, desc});
+    addToLedgerTree(expenseTree, expenseOutliers, date, amount);
 }
 
-void Finance::recordRevenue(double amount, const string& desc, const string& date) {
+void Finance::recordRevenue(double amount, const string& desc, const string& date, int orderId) {
     if (amount < 0) {
         throw invalid_argument("Revenue amount cannot be negative.");
     }
     totalRevenue += amount;
-    transactions.push_back({"Revenue", amount, date.empty() ? "N/A" : date, desc});
+    transactions.push_back({"Revenue", amount, date.empty() ? "N/A" : date, desc, orderId});
+    addToLedgerTree(revenueTree, revenueOutliers, date, amount);
+}
+
+void Finance::recordRevenueBatch(const vector<Transaction>& entries) {
+    for (const auto& e : entries) {
+        if (e.amount < 0) {
+            throw invalid_argument("Revenue amount cannot be negative.");
+        }
+    }
+
+    transactions.reserve(transactions.size() + entries.size());
+    for (const auto& e : entries) {
+        totalRevenue += e.amount;
+        transactions.push_back({"Revenue", e.amount, e.date.empty() ? "N/A" : e.date, e.description, e.orderId});
+        addToLedgerTree(revenueTree, revenueOutliers, e.date, e.amount);
+    }
 }
 
 double Finance::calculateProfit() const {
     return totalRevenue - totalExpenses;
 }
 
+// ---------------- Date-range checkpoints ----------------
+
+void Finance::treeAdd(vector<double>& tree, size_t pos, double amount) {
+    for (size_t i = pos + 1; i <= tree.size(); i += i & (~i + 1)) tree[i - 1] += amount;
+}
+
+double Finance::treePrefix(const vector<double>& tree, size_t count) {
+    double sum = 0.0;
+    for (size_t i = count; i > 0; i -= i & (~i + 1)) sum += tree[i - 1];
+    return sum;
+}
+
+void Finance::ensureDayCovered(int day) {
+    const int size = static_cast<int>(revenueTree.size());
+    if (size > 0 && day >= baseDay && day < baseDay + size) return;
+
+    // Grow to cover `day`, at least doubling (up to kMaxTreeDays), with the
+    // slack on the side that grew
+    int newBase = size > 0 ? min(baseDay, day) : day;
+    int newEnd = size > 0 ? max(baseDay + size, day + 1) : day + 1;
+    const int span = max({newEnd - newBase, min(2 * size, kMaxTreeDays), 64});
+    if (size > 0 && day < baseDay) newBase = newEnd - span;
+    else newEnd = newBase + span;
+
+    auto regrow = [&](vector<double>& tree) {
+        vector<double> grown(static_cast<size_t>(newEnd - newBase), 0.0);
+        for (int i = 0; i < size; ++i) {
+            const double v = treePrefix(tree, static_cast<size_t>(i) + 1) - treePrefix(tree, static_cast<size_t>(i));
+            if (v != 0.0) grown[static_cast<size_t>(baseDay + i - newBase)] = v;
+        }
+        // Linear-time Fenwick construction from point values
+        for (size_t i = 1; i <= grown.size(); ++i) {
+            const size_t parent = i + (i & (~i + 1));
+            if (parent <= grown.size()) grown[parent - 1] += grown[i - 1];
+        }
+        tree.swap(grown);
+    };
+
+    regrow(revenueTree);
+    regrow(expenseTree);
+    baseDay = newBase;
+}
+
+void Finance::addToLedgerTree(vector<double>& tree, vector<pair<int, double>>& outliers,
+                              const string& date, double amount) {
+    int day;
+    if (!DateUtil::toDayNumber(date, day)) return;
+
+    const bool empty = revenueTree.empty();
+    const long long first = empty ? day : min(firstTreeDay, day);
+    const long long last = empty ? day : max(lastTreeDay, day);
+    if (last - first + 1 > kMaxTreeDays) {
+        outliers.emplace_back(day, amount);
+        if (revenueOutliers.size() + expenseOutliers.size() > max(treeEntries, outlierLimit)) {
+            rebuildLedgerTrees();
+        }
+        return;
+    }
+
+    ensureDayCovered(day);
+    firstTreeDay = static_cast<int>(first);
+    lastTreeDay = static_cast<int>(last);
+    treeAdd(tree, static_cast<size_t>(day - baseDay), amount);
+    treeEntries++;
+}
+
+void Finance::rebuildLedgerTrees() {
+    struct Dated {
+        int day;
+        bool revenue;
+        double amount;
+    };
+    vector<Dated> dated;
+    dated.reserve(transactions.size());
+    for (const auto& t : transactions) {
+        int day;
+        if (DateUtil::toDayNumber(t.date, day)) dated.push_back({day, t.type == "Revenue", t.amount});
+    }
+    sort(dated.begin(), dated.end(), [](const Dated& a, const Dated& b) { return a.day < b.day; });
+
+    // The kMaxTreeDays span holding the most entries
+    size_t bestFirst = 0, bestCount = 0;
+    for (size_t lo = 0, hi = 0; hi < dated.size(); ++hi) {
+        while (static_cast<long long>(dated[hi].day) - dated[lo].day + 1 > kMaxTreeDays) lo++;
+        if (hi - lo + 1 > bestCount) {
+            bestCount = hi - lo + 1;
+            bestFirst = lo;
+        }
+    }
+
+    revenueTree.clear();
+    expenseTree.clear();
+    revenueOutliers.clear();
+    expenseOutliers.clear();
+    treeEntries = 0;
+    if (bestCount > 0) {
+        firstTreeDay = dated[bestFirst].day;
+        lastTreeDay = dated[bestFirst + bestCount - 1].day;
+        ensureDayCovered(firstTreeDay);
+        ensureDayCovered(lastTreeDay);
+    }
+    for (size_t i = 0; i < dated.size(); ++i) {
+        const Dated& d = dated[i];
+        if (i >= bestFirst && i < bestFirst + bestCount) {
+            treeAdd(d.revenue ? revenueTree : expenseTree, static_cast<size_t>(d.day - baseDay), d.amount);
+            treeEntries++;
+        } else {
+            (d.revenue ? revenueOutliers : expenseOutliers).emplace_back(d.day, d.amount);
+        }
+    }
+    // Rebuild again only once the outliers have doubled, so the cost stays
+    // amortized even when no span holds most of the entries
+    outlierLimit = 2 * (revenueOutliers.size() + expenseOutliers.size());
+}
+
+double Finance::rangeSum(const vector<double>& tree, const vector<pair<int, double>>& outliers,
+                         const string& from, const string& to) const {
+    int fromDay = INT_MIN, toDay = INT_MAX;
+    if (!from.empty() && !DateUtil::toDayNumber(from, fromDay)) {
+        throw invalid_argument("Invalid date: " + from);
+    }
+    if (!to.empty() && !DateUtil::toDayNumber(to, toDay)) {
+        throw invalid_argument("Invalid date: " + to);
+    }
+    if (toDay < fromDay) return 0.0;
+
+    double sum = 0.0;
+    for (const auto& [day, amount] : outliers) {
+        if (day >= fromDay && day <= toDay) sum += amount;
+    }
+    if (tree.empty()) return sum;
+
+    // Clamp to the covered window, then two prefix lookups
+    const long long size = static_cast<long long>(tree.size());
+    const long long lo = max<long long>(0, static_cast<long long>(fromDay) - baseDay);
+    const long long hi = min<long long>(size, static_cast<long long>(toDay) - baseDay + 1);
+    if (hi <= lo) return sum;
+
+    return sum + treePrefix(tree, static_cast<size_t>(hi)) - treePrefix(tree, static_cast<size_t>(lo));
+}
+
+size_t Finance::outlierCount() const {
+    return revenueOutliers.size() + expenseOutliers.size();
+}
+
+double Finance::getRevenueBetween(const string& from, const string& to) const {
+    return rangeSum(revenueTree, revenueOutliers, from, to);
+}
+
+double Finance::getExpensesBetween(const string& from, const string& to) const {
+    return rangeSum(expenseTree, expenseOutliers, from, to);
+}
+
+double Finance::calculateProfitBetween(const string& from, const string& to) const {
+    return getRevenueBetween(from, to) - getExpensesBetween(from, to);
+}
+
 void Finance::generateReport() const {
     cout << fixed << setprecision(2);
     cout << "=== Financial Report ===" << endl;
@@ -0,0 +1,180 @@
+#include "Follower.h"
+#include "Exceptions.h"
+#include "PremiumCustomer.h"
+#include "RegularCustomer.h"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+namespace {
+std::atomic<bool> g_followerStop{false};
+
+// Makes `to` hold the base's files and directories (the archive). Archive
+// segments are read lazily, so they must not stay behind in a base the
+// primary may replace.
+void mirrorBase(const std::string& from, const std::string& to) {
+    namespace fs = std::filesystem;
+    fs::create_directories(to);
+    for (const auto& entry : fs::directory_iterator(from)) {
+        const fs::path target = fs::path(to) / entry.path().filename();
+        if (entry.is_directory()) {
+            fs::remove_all(target);
+            fs::copy(entry.path(), target, fs::copy_options::recursive);
+        } else {
+            fs::copy_file(entry.path(), target, fs::copy_options::overwrite_existing);
+        }
+    }
+}
+} // namespace
+
+Follower::Follower(DataManager& dm, std::string logPath, std::string dataDir)
+    : dm(dm), logPath(std::move(logPath)), dataDir(std::move(dataDir)), lastSeq(0) {}
+
+std::string Follower::basePath(const std::string& logPath) {
+    return logPath + ".base";
+}
+
+bool Follower::logReady() const {
+    return std::ifstream(logPath).good();
+}
+
+void Follower::open() {
+    // Open the log before loading, so a primary restart during the load
+    // shows up as a replaced log instead of a base/log mismatch.
+    auto next = std::make_unique<ChangeLogReader>(logPath);
+    mirrorBase(basePath(logPath), dataDir);
+    dm.loadAll(dataDir);
+    if (next->replaced()) throw FileOperationException("Change log was replaced while loading its base.");
+
+    reader = std::move(next);
+    lastSeq = 0;
+}
+
+bool Follower::isOpen() const {
+    return reader != nullptr;
+}
+
+bool Follower::needsResync() const {
+    return reader && reader->replaced();
+}
+
+size_t Follower::fetch(std::vector<ChangeEvent>& out, size_t max) {
+    if (!reader) return 0;
+    size_t n = 0;
+    ChangeEvent event;
+    while (n < max && reader->next(event)) {
+        out.push_back(std::move(event));
+        n++;
+    }
+    return n;
+}
+
+size_t Follower::apply(const std::vector<ChangeEvent>& events) {
+    size_t changed = 0;
+    for (const auto& event : events) {
+        if (event.seq != lastSeq + 1) {
+            throw ReplicationException("Change log gap: expected seq " + std::to_string(lastSeq + 1) +
+                                       ", got " + std::to_string(event.seq) + ".");
+        }
+        if (!event.derived) {
+            try {
+                applyOne(event);
+            } catch (const ReplicationException&) {
+                throw;
+            } catch (const std::exception& e) {
+                throw ReplicationException("Replica diverged at seq " + std::to_string(event.seq) + " (" +
+                                           changeTypeName(event.type) + "): " + e.what());
+            }
+            changed++;
+        }
+        lastSeq = event.seq;
+    }
+    return changed;
+}
+
+void Follower::applyOne(const ChangeEvent& e) {
+    auto product = [&](int id) {
+        Product* p = dm.findProduct(id);
+        if (!p) throw ReplicationException("Product not found on replica: " + std::to_string(id));
+        return p;
+    };
+    auto order = [&](int id) -> Order& {
+        Order* o = dm.findOrder(id);
+        if (!o) throw ReplicationException("Order not found on replica: " + std::to_string(id));
+        return *o;
+    };
+    auto customer = [&](int id) {
+        Customer* c = dm.findCustomer(id);
+        if (!c) throw ReplicationException("Customer not found on replica: " + std::to_string(id));
+        return c;
+    };
+
+    switch (e.type) {
+        case ChangeType::ProductUpsert:
+            if (Product* p = dm.findProduct(e.id)) {
+                dm.updateProduct(*p, e.name, e.amount, e.cost, e.qty);
+            } else {
+                dm.addProduct(e.id, e.name, e.amount, e.cost, e.qty);
+            }
+            break;
+        case ChangeType::ProductRemove:
+            dm.removeProduct(e.id);
+            break;
+        case ChangeType::StockDelta:
+            dm.adjustStock(*product(e.id), e.qty);
+            break;
+        case ChangeType::CustomerUpsert:
+            if (e.ref) {
+                dm.addCustomer(new PremiumCustomer(e.id, e.name, e.amount));
+            } else {
+                dm.addCustomer(new RegularCustomer(e.id, e.name));
+            }
+            break;
+        case ChangeType::CustomerUpgrade:
+            dm.upgradeCustomers({e.id}, e.amount);
+            break;
+        case ChangeType::OrderCreate:
+            dm.createOrder(e.id, e.ref >= 0 ? customer(e.ref) : nullptr, e.date);
+            break;
+        case ChangeType::OrderItem:
+            dm.addOrderItem(order(e.id), product(e.ref), e.qty);
+            // Holds expire on the primary's clock, which a replica cannot
+            // see; the primary already checked them, so keep none here.
+            dm.clearReservations();
+            break;
+        case ChangeType::OrderItemRemove:
+            dm.removeOrderItem(order(e.id), product(e.ref));
+            break;
+        case ChangeType::OrderFinalize: {
+            Order& o = order(e.id);
+            dm.finalizeOrder(o);
+            // The base went through the text files, so allow rounding noise
+            if (std::abs(o.getTotalAmount() - e.amount) > 0.005) {
+                throw ReplicationException("Order #" + std::to_string(e.id) + " total differs from primary.");
+            }
+            break;
+        }
+        case ChangeType::LedgerAppend:
+            // Revenue only ever arrives derived from a finalization
+            dm.recordExpense(e.amount, e.name, e.date);
+            break;
+    }
+}
+
+uint64_t Follower::appliedSeq() const {
+    return lastSeq.load();
+}
+
+std::string Follower::status() const {
+    return "replica seq=" + std::to_string(appliedSeq()) + " log=" + logPath;
+}
+
+void Follower::requestStop() {
+    g_followerStop = true;
+}
+
+bool Follower::stopRequested() {
+    return g_followerStop.load();
+}
@@ -0,0 +1,196 @@
+#include "InvoiceExport.h"
+#include "DataManager.h"
+#include "Exceptions.h"
+#include "Parallel.h"
+#include "TextFormat.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+// Invoices per worker before another thread is worth starting
+const size_t kMinInvoicesPerWorker = 256;
+// Invoices rendered per round of a bundle export, bounding its memory
+const size_t kBundleBatch = 16384;
+
+void writeWhole(std::ofstream& out, const std::string& text, const std::string& path) {
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    if (!out) throw FileOperationException("Failed to write invoice file: " + path);
+}
+
+// Closing flushes what is still buffered, so a full disk may only show here
+void closeWhole(std::ofstream& out, const std::string& path) {
+    out.close();
+    if (out.fail()) throw FileOperationException("Failed to write invoice file: " + path);
+}
+
+void traceExport(TraceSpan& span, const InvoiceExportStats& stats) {
+    if (!span.isActive()) return;
+    span.arg("invoices", static_cast<int64_t>(stats.invoices));
+    span.arg("bytes", static_cast<int64_t>(stats.bytes));
+    span.arg("workers", static_cast<int64_t>(stats.workers));
+    Trace::add(TraceCounter::BytesWritten, static_cast<int64_t>(stats.bytes));
+}
+
+// One worker's share of a bundle round: its invoices back to back, and
+// where each one ends
+struct RenderedChunk {
+    std::string text;
+    std::vector<size_t> ends;
+};
+} // namespace
+
+std::vector<const Order*> InvoiceExport::finalizedOrders(DataManager& dm, const std::string& from,
+                                                         const std::string& to) {
+    OrderQuery q;
+    q.fromDate = from;
+    q.toDate = to;
+    q.finalized = 1;
+    const QueryResult result = dm.queryOrders(q);
+
+    std::vector<const Order*> orders;
+    orders.reserve(result.rows.size());
+    for (size_t row : result.rows) orders.push_back(&dm.orders()[row]);
+    return orders;
+}
+
+InvoiceExportStats InvoiceExport::toDirectory(const std::vector<const Order*>& orders, const std::string& dir) {
+    TraceSpan span("invoices.export", dir);
+
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec) throw FileOperationException("Failed to create invoice directory: " + dir);
+
+    InvoiceExportStats stats;
+    stats.invoices = orders.size();
+    stats.workers = parallelWorkerCount(orders.size(), kMinInvoicesPerWorker);
+
+    std::vector<size_t> bytes(stats.workers, 0);
+    std::vector<std::exception_ptr> errors(stats.workers);
+    parallelFor(orders.size(), stats.workers, [&](size_t begin, size_t end, unsigned w) {
+        try {
+            std::string text;
+            std::string name;
+            for (size_t i = begin; i < end && !errors[w]; ++i) {
+                text.clear();
+                orders[i]->renderInvoice(text);
+
+                name = "invoice-";
+                TextFormat::integer(name, orders[i]->getOrderId());
+                name += ".txt";
+                const std::string path = (fs::path(dir) / name).string();
+                std::ofstream out(path, std::ios::binary | std::ios::trunc);
+                if (!out.is_open()) throw FileOperationException("Failed to write invoice file: " + path);
+                writeWhole(out, text, path);
+                closeWhole(out, path);
+                bytes[w] += text.size();
+            }
+        } catch (...) {
+            errors[w] = std::current_exception();
+        }
+    });
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+
+    for (size_t b : bytes) stats.bytes += b;
+    traceExport(span, stats);
+    return stats;
+}
+
+InvoiceExportStats InvoiceExport::toBundle(const std::vector<const Order*>& orders, const std::string& path) {
+    TraceSpan span("invoices.export", path);
+
+    const fs::path parent = fs::path(path).parent_path();
+    if (!parent.empty()) {
+        std::error_code ec;
+        fs::create_directories(parent, ec);
+        if (ec) throw FileOperationException("Failed to create invoice directory: " + parent.string());
+    }
+
+    const std::string indexPath = path + ".idx";
+    const std::string tmp = path + ".tmp";
+    const std::string indexTmp = indexPath + ".tmp";
+    std::ofstream out;
+    std::ofstream index;
+    bool created = false, indexCreated = false;
+
+    InvoiceExportStats stats;
+    stats.invoices = orders.size();
+    stats.workers = 1;
+
+    try {
+        out.open(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) throw FileOperationException("Failed to write invoice file: " + tmp);
+        created = true;
+        index.open(indexTmp, std::ios::binary | std::ios::trunc);
+        if (!index.is_open()) throw FileOperationException("Failed to write invoice index: " + indexTmp);
+        indexCreated = true;
+
+        std::vector<RenderedChunk> chunks;
+        std::string indexText = "OrderId,Offset,Length\n";
+        for (size_t first = 0; first < orders.size(); first += kBundleBatch) {
+            const size_t count = std::min(kBundleBatch, orders.size() - first);
+            const unsigned workers = parallelWorkerCount(count, kMinInvoicesPerWorker);
+            if (workers > stats.workers) stats.workers = workers;
+            if (chunks.size() < workers) chunks.resize(workers);
+
+            // parallelFor hands worker w the w-th contiguous range, so the
+            // chunks in worker order are the invoices in input order
+            parallelFor(count, workers, [&](size_t begin, size_t end, unsigned w) {
+                RenderedChunk& chunk = chunks[w];
+                chunk.text.clear();
+                chunk.ends.clear();
+                for (size_t i = begin; i < end; ++i) {
+                    orders[first + i]->renderInvoice(chunk.text);
+                    chunk.ends.push_back(chunk.text.size());
+                }
+            });
+
+            size_t i = first;
+            for (unsigned w = 0; w < workers; ++w) {
+                const RenderedChunk& chunk = chunks[w];
+                size_t start = 0;
+                for (size_t end : chunk.ends) {
+                    TextFormat::integer(indexText, orders[i++]->getOrderId());
+                    indexText += ',';
+                    TextFormat::integer(indexText, static_cast<long long>(stats.bytes + start));
+                    indexText += ',';
+                    TextFormat::integer(indexText, static_cast<long long>(end - start));
+                    indexText += '\n';
+                    start = end;
+                }
+                writeWhole(out, chunk.text, tmp);
+                stats.bytes += chunk.text.size();
+            }
+            writeWhole(index, indexText, indexTmp);
+            indexText.clear();
+        }
+        if (orders.empty()) writeWhole(index, indexText, indexTmp);
+
+        closeWhole(out, tmp);
+        closeWhole(index, indexTmp);
+
+        std::error_code ec;
+        fs::rename(tmp, path, ec);
+        if (ec) throw FileOperationException("Failed to publish invoice file: " + path);
+        fs::rename(indexTmp, indexPath, ec);
+        if (ec) throw FileOperationException("Failed to publish invoice index: " + indexPath);
+    } catch (...) {
+        // Leave nothing half written behind (a renamed file is already gone)
+        out.close();
+        index.close();
+        std::error_code ignored;
+        if (created) fs::remove(tmp, ignored);
+        if (indexCreated) fs::remove(indexTmp, ignored);
+        throw;
+    }
+
+    traceExport(span, stats);
+    return stats;
+}
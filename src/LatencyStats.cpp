@@ -0,0 +1,137 @@
+#include "LatencyStats.h"
+#include "DateUtil.h"
+#include "Exceptions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+namespace {
+const size_t kOps = static_cast<size_t>(LatencyOp::Count);
+
+LatencyHistogram g_histograms[kOps];
+
+int floorLog2(uint64_t v) {
+    int e = 0;
+    while (v >>= 1) e++;
+    return e;
+}
+
+double micros(int64_t ns) {
+    return static_cast<double>(ns) / 1000.0;
+}
+} // namespace
+
+const char* latencyOpName(LatencyOp op) {
+    switch (op) {
+        case LatencyOp::ProductLookup: return "Product lookup";
+        case LatencyOp::AddItem: return "Add item";
+        case LatencyOp::Finalize: return "Finalize";
+        case LatencyOp::PrintInvoice: return "Print invoice";
+        case LatencyOp::Save: return "Save";
+        case LatencyOp::Count: break;
+    }
+    return "?";
+}
+
+// ---------------- LatencyHistogram ----------------
+
+size_t LatencyHistogram::bucketOf(int64_t ns) {
+    if (ns < static_cast<int64_t>(2 * kSubBuckets)) return ns < 0 ? 0 : static_cast<size_t>(ns);
+    const int exponent = floorLog2(static_cast<uint64_t>(ns));
+    if (exponent > static_cast<int>(kMaxExponent)) return kBuckets - 1;
+    const int shift = exponent - static_cast<int>(kSubBucketBits);
+    return static_cast<size_t>(shift + 1) * kSubBuckets + ((static_cast<uint64_t>(ns) >> shift) - kSubBuckets);
+}
+
+int64_t LatencyHistogram::bucketUpperBound(size_t bucket) {
+    if (bucket < 2 * kSubBuckets) return static_cast<int64_t>(bucket);
+    const unsigned shift = static_cast<unsigned>(bucket / kSubBuckets) - 1;
+    const int64_t low = static_cast<int64_t>(bucket % kSubBuckets + kSubBuckets) << shift;
+    return low + (int64_t{1} << shift) - 1;
+}
+
+void LatencyHistogram::record(int64_t ns) {
+    if (ns < 0) ns = 0;
+    buckets[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(ns, std::memory_order_relaxed);
+
+    int64_t seen = largest.load(std::memory_order_relaxed);
+    while (ns > seen && !largest.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LatencyHistogram::count() const {
+    return total.load(std::memory_order_relaxed);
+}
+
+int64_t LatencyHistogram::max() const {
+    return largest.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const {
+    const uint64_t n = count();
+    return n ? static_cast<double>(sum.load(std::memory_order_relaxed)) / static_cast<double>(n) : 0.0;
+}
+
+int64_t LatencyHistogram::percentile(double q) const {
+    // Buckets are read one by one while other threads may record: the total
+    // is taken from the buckets themselves so the walk always ends
+    uint64_t counts[kBuckets];
+    uint64_t n = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        counts[i] = buckets[i].load(std::memory_order_relaxed);
+        n += counts[i];
+    }
+    if (n == 0) return 0;
+
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(n))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += counts[i];
+        if (seen >= rank) return std::min(bucketUpperBound(i), max());
+    }
+    return max();
+}
+
+// ---------------- LatencyStats ----------------
+
+LatencyHistogram& LatencyStats::histogram(LatencyOp op) {
+    return g_histograms[static_cast<size_t>(op)];
+}
+
+void LatencyStats::print(std::ostream& out) {
+    out << std::left << std::setw(16) << "Operation" << std::right
+        << std::setw(10) << "Count" << std::setw(12) << "Mean us" << std::setw(12) << "p50 us"
+        << std::setw(12) << "p99 us" << std::setw(12) << "p99.9 us" << std::setw(12) << "Max us" << "\n";
+    out << std::fixed << std::setprecision(1);
+    for (size_t i = 0; i < kOps; ++i) {
+        const LatencyHistogram& h = g_histograms[i];
+        out << std::left << std::setw(16) << latencyOpName(static_cast<LatencyOp>(i)) << std::right
+            << std::setw(10) << h.count() << std::setw(12) << h.mean() / 1000.0
+            << std::setw(12) << micros(h.percentile(0.50)) << std::setw(12) << micros(h.percentile(0.99))
+            << std::setw(12) << micros(h.percentile(0.999)) << std::setw(12) << micros(h.max()) << "\n";
+    }
+}
+
+void LatencyStats::appendCsv(const std::string& path) {
+    const bool fresh = !std::filesystem::exists(path);
+    std::ofstream out(path, std::ios::app);
+    if (!out.is_open()) throw FileOperationException("Failed to write latency file: " + path);
+
+    if (fresh) out << "Timestamp,Operation,Count,MeanUs,P50Us,P99Us,P999Us,MaxUs\n";
+    const std::string stamp = DateUtil::localTimestamp();
+    out << std::fixed << std::setprecision(1);
+    for (size_t i = 0; i < kOps; ++i) {
+        const LatencyHistogram& h = g_histograms[i];
+        if (h.count() == 0) continue;
+        out << stamp << "," << latencyOpName(static_cast<LatencyOp>(i)) << "," << h.count() << ","
+            << h.mean() / 1000.0 << "," << micros(h.percentile(0.50)) << "," << micros(h.percentile(0.99)) << ","
+            << micros(h.percentile(0.999)) << "," << micros(h.max()) << "\n";
+    }
+    if (!out) throw FileOperationException("Failed to write latency file: " + path);
+}
@@ -0,0 +1,171 @@
+#include "MemoryStats.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <ostream>
+#include <sstream>
+
+namespace {
+const size_t kSubsystems = static_cast<size_t>(MemSubsystem::Count);
+
+thread_local MemSubsystem t_subsystem = MemSubsystem::Other;
+
+std::string humanBytes(size_t bytes) {
+    const char* units[] = {"B", "KB", "MB", "GB"};
+    double value = static_cast<double>(bytes);
+    size_t unit = 0;
+    while (value >= 1024.0 && unit + 1 < sizeof(units) / sizeof(units[0])) {
+        value /= 1024.0;
+        unit++;
+    }
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << " " << units[unit];
+    return out.str();
+}
+} // namespace
+
+// ---------------- Collection report ----------------
+
+size_t memsize::heap(const std::string& s) {
+    static const size_t inlineCapacity = std::string().capacity();
+    return s.capacity() > inlineCapacity ? s.capacity() + 1 : 0;
+}
+
+size_t MemoryReport::totalBytes() const {
+    size_t total = 0;
+    for (const auto& c : collections) total += c.bytes;
+    return total;
+}
+
+size_t MemoryReport::totalSlack() const {
+    size_t total = 0;
+    for (const auto& c : collections) total += c.slack;
+    return total;
+}
+
+void MemoryReport::print(std::ostream& out) const {
+    out << std::left << std::setw(18) << "Collection" << std::right
+        << std::setw(12) << "Objects" << std::setw(14) << "Bytes" << std::setw(14) << "Slack" << "\n";
+    for (const auto& c : collections) {
+        out << std::left << std::setw(18) << c.name << std::right
+            << std::setw(12) << c.objects << std::setw(14) << humanBytes(c.bytes)
+            << std::setw(14) << humanBytes(c.slack) << "\n";
+    }
+    out << std::left << std::setw(18) << "Total" << std::right
+        << std::setw(12) << "" << std::setw(14) << humanBytes(totalBytes())
+        << std::setw(14) << humanBytes(totalSlack()) << "\n";
+}
+
+// ---------------- Heap attribution ----------------
+
+const char* memSubsystemName(MemSubsystem subsystem) {
+    switch (subsystem) {
+        case MemSubsystem::Other: return "Other";
+        case MemSubsystem::Products: return "Products";
+        case MemSubsystem::Customers: return "Customers";
+        case MemSubsystem::Orders: return "Orders";
+        case MemSubsystem::Ledger: return "Ledger";
+        case MemSubsystem::Indexes: return "Indexes";
+        case MemSubsystem::Snapshots: return "Snapshots";
+        case MemSubsystem::Count: break;
+    }
+    return "?";
+}
+
+MemoryScope::MemoryScope(MemSubsystem subsystem) : previous(t_subsystem) {
+    t_subsystem = subsystem;
+}
+
+MemoryScope::~MemoryScope() {
+    t_subsystem = previous;
+}
+
+void HeapUsage::print(std::ostream& out) const {
+    if (!tracking) {
+        out << "Heap tracking is off (build with BMS_TRACK_ALLOCATIONS to enable).\n";
+        return;
+    }
+    out << std::left << std::setw(18) << "Subsystem" << std::right
+        << std::setw(14) << "Live bytes" << std::setw(12) << "Blocks" << std::setw(16) << "Allocations" << "\n";
+    size_t bytes = 0, blocks = 0;
+    uint64_t allocs = 0;
+    for (size_t i = 0; i < kSubsystems; ++i) {
+        out << std::left << std::setw(18) << memSubsystemName(static_cast<MemSubsystem>(i)) << std::right
+            << std::setw(14) << humanBytes(liveBytes[i]) << std::setw(12) << liveBlocks[i]
+            << std::setw(16) << allocations[i] << "\n";
+        bytes += liveBytes[i];
+        blocks += liveBlocks[i];
+        allocs += allocations[i];
+    }
+    out << std::left << std::setw(18) << "Total" << std::right
+        << std::setw(14) << humanBytes(bytes) << std::setw(12) << blocks << std::setw(16) << allocs << "\n";
+}
+
+#ifdef BMS_TRACK_ALLOCATIONS
+
+namespace {
+struct alignas(std::max_align_t) BlockHeader {
+    size_t size;
+    MemSubsystem subsystem;
+};
+
+// Zero-initialized before any dynamic initialization, so allocations made
+// by other static constructors are counted too
+std::atomic<size_t> g_liveBytes[kSubsystems];
+std::atomic<size_t> g_liveBlocks[kSubsystems];
+std::atomic<uint64_t> g_allocations[kSubsystems];
+
+void* allocateTracked(size_t size) {
+    void* raw;
+    while ((raw = std::malloc(size + sizeof(BlockHeader))) == nullptr) {
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+    auto* header = static_cast<BlockHeader*>(raw);
+    header->size = size;
+    header->subsystem = t_subsystem;
+
+    const size_t slot = static_cast<size_t>(header->subsystem);
+    g_liveBytes[slot].fetch_add(size, std::memory_order_relaxed);
+    g_liveBlocks[slot].fetch_add(1, std::memory_order_relaxed);
+    g_allocations[slot].fetch_add(1, std::memory_order_relaxed);
+    return header + 1;
+}
+
+void releaseTracked(void* p) noexcept {
+    if (!p) return;
+    auto* header = static_cast<BlockHeader*>(p) - 1;
+    const size_t slot = static_cast<size_t>(header->subsystem);
+    g_liveBytes[slot].fetch_sub(header->size, std::memory_order_relaxed);
+    g_liveBlocks[slot].fetch_sub(1, std::memory_order_relaxed);
+    std::free(header);
+}
+} // namespace
+
+// The array and nothrow forms forward to these. Over-aligned allocations
+// keep the library's own pair and are not counted.
+void* operator new(std::size_t size) { return allocateTracked(size); }
+void operator delete(void* p) noexcept { releaseTracked(p); }
+void operator delete(void* p, std::size_t) noexcept { releaseTracked(p); }
+
+HeapUsage heapUsage() {
+    HeapUsage usage;
+    usage.tracking = true;
+    for (size_t i = 0; i < kSubsystems; ++i) {
+        usage.liveBytes[i] = g_liveBytes[i].load(std::memory_order_relaxed);
+        usage.liveBlocks[i] = g_liveBlocks[i].load(std::memory_order_relaxed);
+        usage.allocations[i] = g_allocations[i].load(std::memory_order_relaxed);
+    }
+    return usage;
+}
+
+#else
+
+HeapUsage heapUsage() {
+    return HeapUsage();
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include "MenuSystem.h"
 
 #include <algorithm>
+#include <chrono>
 #include <unordered_map>
 #include <vector>
 #include <iostream>
@@ -8,13 +9,26 @@
 #include <limits>
 #include <stdexcept>
 #include <cctype>
+#include <cmath>
 #include <ctime>
+#include <sstream>
+#include <utility>
 
 #include "Exceptions.h"
 #include "RegularCustomer.h"
 #include "PremiumCustomer.h"
 #include "Order.h"
-MenuSystem::MenuSystem(DataManager& dm) : dm(dm) {}
+#include "DateUtil.h"
+#include "Sketches.h"
+#include "RfmAnalysis.h"
+#include "Replenishment.h"
+#include "Trace.h"
+#include "LatencyStats.h"
+#include "TableRenderer.h"
+#include "InvoiceExport.h"
+
+MenuSystem::MenuSystem(DataManager& dm, std::string dataDir)
+    : dm(dm), dataDir(std::move(dataDir)), reportCache() {}
 
 void MenuSystem::clearInput() {
     std::cin.clear();
@@ -101,7 +115,80 @@ std::string MenuSystem::getStringInput(const std::string& prompt) {
     }
 }
 
-void MenuSystem::mainLoop() {
+bool MenuSystem::readOptionalInt(const char* prompt, int& out) {
+    while (true) {
+        std::string s = readLine(prompt);
+        if (s.empty()) return false;
+        try {
+            size_t used = 0;
+            int v = std::stoi(s, &used);
+            if (used == s.size()) {
+                out = v;
+                return true;
+            }
+        } catch (const std::exception&) {
+        }
+        std::cout << "Invalid number. Try again.\n";
+    }
+}
+
+bool MenuSystem::readOptionalDouble(const char* prompt, double& out) {
+    while (true) {
+        std::string s = readLine(prompt);
+        if (s.empty()) return false;
+        try {
+            size_t used = 0;
+            double v = std::stod(s, &used);
+            if (used == s.size()) {
+                out = v;
+                return true;
+            }
+        } catch (const std::exception&) {
+        }
+        std::cout << "Invalid number. Try again.\n";
+    }
+}
+
+void MenuSystem::pageTable(const TableRenderer& table, size_t rowCount, const TableRenderer::RowFn& row) {
+    size_t cursor = 0;
+    while (true) {
+        const size_t last = std::min(rowCount, cursor + kListPageRows);
+        table.writeHeader(std::cout);
+        table.writeRows(std::cout, cursor, last, row);
+        if (rowCount <= kListPageRows) return;
+
+        char c = 0;
+        while (c == 0) {
+            std::cout << "Rows " << cursor + 1 << "-" << last << " of " << rowCount
+                      << ". [Enter] next, p prev, a all, q quit: ";
+            std::string cmd;
+            if (!std::getline(std::cin, cmd)) {
+                std::cin.clear();
+                std::cout << "\n";
+                return;
+            }
+            c = cmd.empty() ? 'n' : static_cast<char>(std::tolower(static_cast<unsigned char>(cmd[0])));
+            if (c != 'n' && c != 'p' && c != 'a' && c != 'q') {
+                std::cout << "Unknown choice.\n";
+                c = 0;
+            }
+        }
+        if (c == 'q') return;
+        if (c == 'a') {
+            table.writeRows(std::cout, last, rowCount, row);
+            return;
+        }
+        if (c == 'p') {
+            cursor = cursor >= kListPageRows ? cursor - kListPageRows : 0;
+        } else {
+            if (last >= rowCount) return;
+            cursor = last;
+        }
+    }
+}
+
+void MenuSystem::mainLoop(const std::function<void()>& onFirstMenu) {
+    bool firstMenu = true;
     while (true) {
         std::cout << "\n===== Business Management System =====\n"
                   << "1. Inventory Management\n"
@@ -109,9 +196,17 @@ void MenuSystem::mainLoop() {
                   << "3. Order Management\n"
                   << "4. Finance Reports\n"
                   << "5. System Reports\n"
+                  << "6. About / Stats\n"
                   << "0. Exit\n";
+        if (firstMenu) {
+            firstMenu = false;
+            if (onFirstMenu) {
+                std::cout.flush();
+                onFirstMenu();
+            }
+        }
 
-        int choice = getIntInput("Select: ", 0, 5);
+        int choice = getIntInput("Select: ", 0, 6);
 
         try {
             switch (choice) {
@@ -120,6 +215,7 @@ void MenuSystem::mainLoop() {
                 case 3: orderMenu(); break;
                 case 4: financeMenu(); break;
                 case 5: reportsMenu(); break;
+                case 6: aboutMenu(); break;
                 case 0: return;
                 default: std::cout << "Invalid choice.\n"; break;
             }
@@ -141,18 +237,20 @@ void MenuSystem::inventoryMenu() {
                   << "5. Remove Product\n"
                   << "6. List Products\n"
                   << "7. Low Stock Alert\n"
+                  << "8. Replenishment Proposal\n"
                   << "0. Back\n";
 
-        int choice = getIntInput("Select: ", 0, 7);
+        int choice = getIntInput("Select: ", 0, 8);
 
         switch (choice) {
-            case 1: addProduct(); dm.saveAll("data"); break;
-            case 2: restockProduct(); dm.saveAll("data"); break;
-            case 3: removeStockAsLoss(); dm.saveAll("data"); break;
-            case 4: updateProduct(); dm.saveAll("data"); break;
-            case 5: removeProduct(); dm.saveAll("data"); break;
+            case 1: addProduct(); dm.saveAll(dataDir); break;
+            case 2: restockProduct(); dm.saveAll(dataDir); break;
+            case 3: removeStockAsLoss(); dm.saveAll(dataDir); break;
+            case 4: updateProduct(); dm.saveAll(dataDir); break;
+            case 5: removeProduct(); dm.saveAll(dataDir); break;
             case 6: listProducts(); break;
             case 7: lowStockAlert(); break;
+            case 8: replenishmentProposal(); dm.saveAll(dataDir); break;
             case 0: return;
             default: std::cout << "Invalid choice.\n"; break;
         }
@@ -166,9 +264,9 @@ void MenuSystem::addProduct() {
     double cost = readDouble("Cost Price: ");
     int qty = readInt("Initial Quantity: ");
 
-    dm.products().emplace_back(id, name, price, cost, qty);
+    dm.addProduct(id, name, price, cost, qty);
 
-    dm.finance().recordExpense(cost * qty, "Initial stock for " + name, "N/A");
+    dm.recordExpense(cost * qty, "Initial stock for " + name, "N/A");
 
     std::cout << "Product added.\n";
 }
@@ -177,21 +275,17 @@ void MenuSystem::restockProduct() {
     int id = readInt("Product ID to restock: ");
     int qty = readInt("Quantity to add: ");
 
-    for (auto& p : dm.products()) {
-        if (p.getId() == id) {
-            p.updateStock(qty);
+    Product* p = lookupProduct(id);
+    if (!p) throw InvalidInputException("Product ID not found.");
 
-            //Step 3: record expense for buying stock (recommended)
-            dm.finance().recordExpense(p.getCost() * qty,
-                                      "Restock product #" + std::to_string(id),
-                                      "N/A");
+    dm.adjustStock(*p, qty);
 
-            std::cout << "Restocked.\n";
-            return;
-        }
-    }
+    //Step 3: record expense for buying stock (recommended)
+    dm.recordExpense(p->getCost() * qty,
+                     "Restock product #" + std::to_string(id),
+                     "N/A");
 
-    throw InvalidInputException("Product ID not found.");
+    std::cout << "Restocked.\n";
 }
 
 void MenuSystem::removeStock(Product& product, int qty, const std::string& reason) {
@@ -199,10 +293,10 @@ void MenuSystem::removeStock(Product& product, int qty, const std::string& reaso
     std::transform(normalized.begin(), normalized.end(), normalized.begin(),
                    [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
 
-    product.updateStock(-qty);
+    dm.adjustStock(product, -qty);
 
     if (normalized == "damage" || normalized == "expiry" || normalized == "loss") {
-        dm.finance().recordExpense(
+        dm.recordExpense(
             product.getCost() * qty,
             "Stock loss (" + normalized + ") for product #" + std::to_string(product.getId()),
             currentDateISO()
@@ -215,113 +309,145 @@ void MenuSystem::removeStockAsLoss() {
     int qty = readInt("Quantity to remove: ");
     std::string reason = readLine("Reason (damage/expiry/loss/other): ");
 
-    for (auto& p : dm.products()) {
-        if (p.getId() != id) continue;
+    Product* p = lookupProduct(id);
+    if (!p) throw InvalidInputException("Product ID not found.");
 
-        removeStock(p, qty, reason);
-
-        std::cout << "Stock removed.\n";
-        return;
-    }
+    removeStock(*p, qty, reason);
 
-    throw InvalidInputException("Product ID not found.");
+    std::cout << "Stock removed.\n";
 }
 
 void MenuSystem::updateProduct() {
     int id = readInt("Product ID to update: ");
 
-    for (auto& p : dm.products()) {
-        if (p.getId() != id) continue;
+    Product* p = lookupProduct(id);
+    if (!p) throw InvalidInputException("Product ID not found.");
 
-        std::string name = readLine("New name: ");
-        double price = readDouble("New selling price: ");
-        double cost = readDouble("New cost price: ");
-        int qty = readInt("New quantity: ");
+    std::string name = readLine("New name: ");
+    double price = readDouble("New selling price: ");
+    double cost = readDouble("New cost price: ");
+    int qty = readInt("New quantity: ");
 
-        p.setName(name);
-        p.setPrice(price);
-        p.setCost(cost);
-        p.setQuantity(qty);
+    dm.updateProduct(*p, name, price, cost, qty);
 
-        std::cout << "Product updated.\n";
-        return;
-    }
-
-    throw InvalidInputException("Product ID not found.");
+    std::cout << "Product updated.\n";
 }
 
 void MenuSystem::removeProduct() {
     int id = readInt("Product ID to remove: ");
 
-    // Reject removal if this product is referenced by any existing order.
-    for (const auto& o : dm.orders()) {
-        for (const auto& item : o.getItems()) {
-            Product* p = item.first;
-            if (p && p->getId() == id) {
-                throw InvalidInputException("Cannot remove product: it is referenced by existing orders.");
-            }
-        }
+    // Checked before the loss is booked; removeProduct checks again
+    if (dm.productReferenced(id)) {
+        throw InvalidInputException("Cannot remove product: it is referenced by existing orders.");
     }
 
-    for (auto it = dm.products().begin(); it != dm.products().end(); ++it) {
-        if (it->getId() != id) continue;
-
-        if (it->getQuantity() > 0) {
-            dm.finance().recordExpense(
-                it->getCost() * it->getQuantity(),
-                "Product removal loss for product #" + std::to_string(id),
-                "N/A"
-            );
-        }
+    Product* p = lookupProduct(id);
+    if (!p) throw InvalidInputException("Product ID not found.");
 
-        dm.products().erase(it);
-        std::cout << "Product removed.\n";
-        return;
+    if (p->getQuantity() > 0) {
+        dm.recordExpense(
+            p->getCost() * p->getQuantity(),
+            "Product removal loss for product #" + std::to_string(id),
+            "N/A"
+        );
     }
 
-    throw InvalidInputException("Product ID not found.");
+    dm.removeProduct(id);
+    std::cout << "Product removed.\n";
 }
 
 void MenuSystem::listProducts() {
+    using Col = TableRenderer::Column;
+    const auto Left = TableRenderer::Align::Left;
+
+    static const TableRenderer table({Col{"ID", 6, Left}, Col{"Name", 40, Left}, Col{"Price", 20, Left},
+                                      Col{"Cost", 12, Left}, Col{"Qty", 8, Left}, Col{"Avail", 8, Left}},
+                                     95);
+
+    dm.expireReservations();
+    const auto& products = dm.products();
+    pageTable(table, products.size(), [&](size_t i, TableRenderer::Row& row) {
+        const Product& p = products[i];
+        row.number(p.getId()).text(p.getName()).decimal(p.getPrice()).decimal(p.getCost())
+           .number(p.getQuantity()).number(dm.available(p));
+    });
+}
+
+void MenuSystem::lowStockAlert() {
+    int threshold = readInt("Low stock threshold: ");
+
+    // Stock index is ordered by quantity: only the matching products are visited
+    const auto low = dm.stockIndex().below(threshold);
+    for (const auto& [id, qty] : low) {
+        const Product* p = dm.findProduct(id);
+        std::cout << "LOW STOCK -> ID " << id
+                  << " (" << (p ? p->getName() : "(unknown)") << ") Qty: " << qty << "\n";
+    }
+
+    if (low.empty()) std::cout << "No low-stock items.\n";
+}
+
+void MenuSystem::replenishmentProposal() {
     using std::cout;
     using std::left;
+    using std::right;
     using std::setw;
 
-    cout << "\n";
+    ReplenishmentPolicy policy;
+    std::string asOf = readLine("As-of date (YYYY-MM-DD, blank for today): ");
+    int asOfDay = DateUtil::todayDayNumber();
+    if (!asOf.empty() && !DateUtil::toDayNumber(asOf, asOfDay)) {
+        throw InvalidInputException("Invalid date: " + asOf);
+    }
+    readOptionalInt("Lead time days (blank = 7): ", policy.leadTimeDays);
+    readOptionalInt("Safety days (blank = 3): ", policy.safetyDays);
+    readOptionalInt("Review period days (blank = 14): ", policy.reviewDays);
+    readOptionalInt("Velocity window days (blank = 30): ", policy.velocityWindow);
+
+    PurchaseProposal proposal = ReplenishmentPlanner::plan(dm, policy, asOfDay);
+
+    cout << "\n=== Replenishment Proposal (" << proposal.date << ") ===\n";
+    if (proposal.lines.empty()) {
+        cout << "No products at their reorder point.\n";
+        return;
+    }
+
     cout << left
          << setw(6)  << "ID"
-         << setw(40) << "Name"
-         << setw(20) << "Price"
+         << setw(26) << "Name"
+         << right
+         << setw(8)  << "OnHand"
+         << setw(10) << "Per Day"
+         << setw(8)  << "ROP"
+         << setw(8)  << "Order"
          << setw(12) << "Cost"
-         << setw(8)  << "Qty"
          << "\n";
+    cout << "------------------------------------------------------------------------------\n";
+    cout << std::fixed << std::setprecision(2);
 
-    cout << "-----------------------------------------------------------------------------------------\n";
-
-    for (const auto& p : dm.products()) {
+    for (const auto& l : proposal.lines) {
+        const Product* p = dm.findProduct(l.productId);
         cout << left
-             << setw(6)  << p.getId()
-             << setw(40) << p.getName()
-             << setw(20) << p.getPrice()
-             << setw(12) << p.getCost()
-             << setw(8)  << p.getQuantity()
+             << setw(6)  << l.productId
+             << setw(26) << (p ? p->getName().substr(0, 25) : "(unknown)")
+             << right
+             << setw(8)  << l.onHand
+             << setw(10) << l.dailyVelocity
+             << setw(8)  << l.reorderPoint
+             << setw(8)  << l.orderQty
+             << setw(12) << l.lineCost
              << "\n";
     }
-}
-
-void MenuSystem::lowStockAlert() {
-    int threshold = readInt("Low stock threshold: ");
-    bool any = false;
+    cout << "\nTotal purchase cost: " << proposal.totalCost << "\n";
 
-    for (const auto& p : dm.products()) {
-        if (p.isLowStock(threshold)) {
-            any = true;
-            std::cout << "LOW STOCK -> ID " << p.getId()
-                      << " (" << p.getName() << ") Qty: " << p.getQuantity() << "\n";
-        }
-    }
+    cout << "Apply proposal? (y/n): ";
+    char ch;
+    std::cin >> ch;
+    clearInput();
+    if (ch != 'y' && ch != 'Y') return;
 
-    if (!any) std::cout << "No low-stock items.\n";
+    double total = ReplenishmentPlanner::apply(dm, proposal);
+    cout << "Restocked " << proposal.lines.size() << " product(s); booked expense " << total << ".\n";
 }
 
 // ---------------- Customer Menu ----------------
@@ -339,11 +465,11 @@ void MenuSystem::customerMenu() {
         int choice = getIntInput("Select: ", 0, 5);
 
         switch (choice) {
-            case 1: addRegularCustomer(); dm.saveAll("data"); break;
-            case 2: addPremiumCustomer(); dm.saveAll("data"); break;
+            case 1: addRegularCustomer(); dm.saveAll(dataDir); break;
+            case 2: addPremiumCustomer(); dm.saveAll(dataDir); break;
             case 3: listCustomers(); break;
             case 4: viewCustomerDetails(); break;
-            case 5: upgradeCustomerToPremium(); dm.saveAll("data"); break;
+            case 5: upgradeCustomerToPremium(); dm.saveAll(dataDir); break;
             case 0: return;
             default: std::cout << "Invalid choice.\n"; break;
         }
@@ -354,7 +480,7 @@ void MenuSystem::addRegularCustomer() {
     int id = readInt("Customer ID: ");
     std::string name = readLine("Name: ");
 
-    dm.customers().push_back(new RegularCustomer(id, name));
+    dm.addCustomer(new RegularCustomer(id, name));
     std::cout << "Regular customer added.\n";
 }
 
@@ -363,52 +489,42 @@ void MenuSystem::addPremiumCustomer() {
     std::string name = readLine("Name: ");
     double loyalty = readDouble("Loyalty (fraction like 0.10 for 10%): ");
 
-    dm.customers().push_back(new PremiumCustomer(id, name, loyalty));
+    dm.addCustomer(new PremiumCustomer(id, name, loyalty));
     std::cout << "Premium customer added.\n";
 }
 
 void MenuSystem::listCustomers() {
-    using std::cout;
-    using std::left;
-    using std::right;
-    using std::setw;
-
-    cout << "\n";
-    cout << left
-         << setw(6)  << "ID"
-         << setw(20) << "Name"
-         << setw(12) << "Type"
-         << right
-         << setw(10) << "Orders"
-         << setw(15) << "TotalSpent"
-         << "\n";
-
-    cout << "---------------------------------------------------------------\n";
-    cout << std::fixed << std::setprecision(2);
-
-    for (auto* c : dm.customers()) {
-        if (!c) continue;
-
-        std::string type = dynamic_cast<PremiumCustomer*>(c) ? "Premium" : "Regular";
-
-        double spent = 0.0;
-        for (const auto& o : dm.orders()) {
-            if (!o.getIsFinalized()) continue;
-            if (!o.getCustomer()) continue;
-            if (o.getCustomer()->getId() == c->getId()) {
-                spent += o.getTotalAmount();
-            }
-        }
+    using Col = TableRenderer::Column;
+    const auto Left = TableRenderer::Align::Left;
+    const auto Right = TableRenderer::Align::Right;
+
+    static const TableRenderer table({Col{"ID", 6, Left}, Col{"Name", 20, Left}, Col{"Type", 12, Left},
+                                      Col{"Orders", 10, Right}, Col{"TotalSpent", 15, Right}},
+                                     63);
+
+    std::vector<const Customer*> rows;
+    rows.reserve(dm.customers().size());
+    for (const auto* c : dm.customers()) {
+        if (c) rows.push_back(c);
+    }
 
-        cout << left
-             << setw(6)  << c->getId()
-             << setw(20) << c->getName()
-             << setw(12) << type
-             << right
-             << setw(10) << c->getOrderHistory().size()
-             << setw(15) << spent
-             << "\n";
+    // One pass over the orders instead of one per customer
+    std::unordered_map<int, double> spent;
+    for (const auto& o : dm.orders()) {
+        if (o.getIsFinalized() && o.getCustomer()) spent[o.getCustomer()->getId()] += o.getTotalAmount();
     }
+    // Archived orders are still in the order histories, so their spend counts too
+    for (const auto& [customerId, totals] : dm.archive().customerTotals()) spent[customerId] += totals.spent;
+
+    pageTable(table, rows.size(), [&](size_t i, TableRenderer::Row& row) {
+        const Customer* c = rows[i];
+        const auto it = spent.find(c->getId());
+        row.number(c->getId())
+           .text(c->getName())
+           .text(dynamic_cast<const PremiumCustomer*>(c) ? "Premium" : "Regular")
+           .number(static_cast<long long>(c->getOrderHistory().size()))
+           .decimal(it == spent.end() ? 0.0 : it->second);
+    });
 }
 
 void MenuSystem::viewCustomerDetails() {
@@ -451,6 +567,9 @@ void MenuSystem::viewCustomerDetails() {
         if (!o.getCustomer()) continue;
         if (o.getCustomer()->getId() == id) totalSpent += o.getTotalAmount();
     }
+    const auto& archived = dm.archive().customerTotals();
+    const auto found = archived.find(id);
+    if (found != archived.end()) totalSpent += found->second.spent;
 
     std::cout << "Total Spent: " << totalSpent << "\n";
 }
@@ -466,7 +585,7 @@ void MenuSystem::upgradeCustomerToPremium() {
                 return;
             }
 
-            c->upgradeToPremium(c, loyalty);
+            dm.upgradeCustomers({id}, loyalty);
 
             std::cout << "Upgraded to Premium.\n";
             return;
@@ -486,16 +605,24 @@ void MenuSystem::orderMenu() {
                   << "3. View Order Details\n"
                   << "4. Add Item to Order\n"
                   << "5. Finalize Order\n"
+                  << "6. Search Orders\n"
+                  << "7. Remove Item from Order\n"
+                  << "8. Finalize Pending Orders\n"
+                  << "9. Export Invoices\n"
                   << "0. Back\n";
 
-        int choice = getIntInput("Select: ", 0, 5);
+        int choice = getIntInput("Select: ", 0, 9);
 
         switch (choice) {
-            case 1: createOrder(); dm.saveAll("data"); break;
+            case 1: createOrder(); dm.saveAll(dataDir); break;
             case 2: listOrders(); break;
             case 3: viewOrderDetails(); break;
-            case 4: addItemToOrder(); dm.saveAll("data"); break;
-            case 5: finalizeOrder(); dm.saveAll("data"); break;
+            case 4: addItemToOrder(); dm.saveAll(dataDir); break;
+            case 5: finalizeOrder(); dm.saveAll(dataDir); break;
+            case 6: searchOrders(); break;
+            case 7: removeItemFromOrder(); dm.saveAll(dataDir); break;
+            case 8: finalizePendingOrders(); dm.saveAll(dataDir); break;
+            case 9: exportInvoices(); break;
             case 0: return;
             default: std::cout << "Invalid choice.\n"; break;
         }
@@ -535,15 +662,14 @@ void MenuSystem::createOrder() {
                 customerPtr = new RegularCustomer(customerId, name);
             }
 
-            dm.customers().push_back(customerPtr);
+            dm.addCustomer(customerPtr);
             std::cout << "Customer created.\n";
         } else {
             throw InvalidInputException("Order cancelled (customer not found).");
         }
     }
 
-    dm.orders().emplace_back(orderId, customerPtr, date);
-    Order& order = dm.orders().back();
+    Order& order = dm.createOrder(orderId, customerPtr, date);
     std::cout << "Order created.\n";
 
     std::cout << "Add items now? (y/n): ";
@@ -557,19 +683,13 @@ void MenuSystem::createOrder() {
         int productId = readInt("Product ID: ");
         int qty = readInt("Quantity: ");
 
-        Product* productPtr = nullptr;
-        for (auto& p : dm.products()) {
-            if (p.getId() == productId) {
-                productPtr = &p;
-                break;
-            }
-        }
+        Product* productPtr = lookupProduct(productId);
 
         if (!productPtr) {
             throw InvalidInputException("Product not found.");
         }
 
-        order.addItem(productPtr, qty);
+        dm.addOrderItem(order, productPtr, qty);
         std::cout << "Item added to cart.\n";
 
         std::cout << "Add another item? (y/n): ";
@@ -578,7 +698,7 @@ void MenuSystem::createOrder() {
     }
 
     if (!order.getItems().empty()) {
-        const double subtotal = order.calculateTotal();
+        const double subtotal = order.getTotalAmount();
         const double discount = customerPtr ? customerPtr->calculateDiscount() : 0.0;
         const double finalTotal = subtotal * (1.0 - discount);
 
@@ -594,7 +714,7 @@ void MenuSystem::createOrder() {
         clearInput();
 
         if (finalizeNow == 'y' || finalizeNow == 'Y') {
-            order.finalize(dm.finance());
+            dm.finalizeOrder(order);
             std::cout << "Order finalized.\n";
             order.printInvoice();
         }
@@ -602,11 +722,95 @@ void MenuSystem::createOrder() {
 }
 
 void MenuSystem::listOrders() {
+    using Col = TableRenderer::Column;
+    const auto Left = TableRenderer::Align::Left;
+
+    static const TableRenderer table({Col{"OrderID", 10, Left}, Col{"Customer", 12, Left}, Col{"Date", 15, Left},
+                                      Col{"Total", 12, Left}, Col{"Finalized", 12, Left}},
+                                     69);
+
+    const auto& orders = dm.orders();
+    pageTable(table, orders.size(), [&](size_t i, TableRenderer::Row& row) {
+        const Order& o = orders[i];
+        row.number(o.getOrderId())
+           .number(o.getCustomer() ? o.getCustomer()->getId() : -1)
+           .text(o.getDate())
+           .decimal(o.getTotalAmount())
+           .text(o.getIsFinalized() ? "Yes" : "No");
+    });
+}
+
+void MenuSystem::exportInvoices() {
+    std::cout << "\nExports the invoices of finalized orders. Leave a date blank to skip it.\n";
+    const std::string from = readLine("From date (YYYY-MM-DD): ");
+    const std::string to = readLine("To date (YYYY-MM-DD): ");
+
+    const auto orders = InvoiceExport::finalizedOrders(dm, from, to);
+    if (orders.empty()) {
+        std::cout << "No finalized orders in that range.\n";
+        return;
+    }
+
+    std::cout << orders.size() << " invoice(s).\n"
+              << "1. One file per invoice\n"
+              << "2. Single file with offset index\n";
+    const bool bundle = getIntInput("Output: ", 1, 2) == 2;
+    std::string path = readLine(bundle ? "File (blank = invoices.txt in the data directory): "
+                                       : "Directory (blank = invoices in the data directory): ");
+    if (path.empty()) path = dataDir + (bundle ? "/invoices.txt" : "/invoices");
+
+    const auto start = std::chrono::steady_clock::now();
+    const InvoiceExportStats stats = bundle ? InvoiceExport::toBundle(orders, path)
+                                            : InvoiceExport::toDirectory(orders, path);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Exported " << stats.invoices << " invoice(s), " << stats.bytes << " bytes, to " << path;
+    if (bundle) std::cout << " (index " << path << ".idx)";
+    std::cout << " in " << std::fixed << std::setprecision(1) << ms << " ms on " << stats.workers
+              << " thread(s).\n";
+}
+
+void MenuSystem::searchOrders() {
     using std::cout;
     using std::left;
-    using std::right;
     using std::setw;
 
+    cout << "\nLeave any field blank to skip it.\n";
+
+    OrderQuery q;
+    readOptionalInt("Order ID: ", q.orderId);
+    q.fromDate = readLine("From date (YYYY-MM-DD): ");
+    q.toDate = readLine("To date (YYYY-MM-DD): ");
+    readOptionalInt("Customer ID: ", q.customerId);
+
+    int tier = 0;
+    readOptionalInt("Tier (1=Regular, 2=Premium): ", tier);
+    if (tier == 1) q.tier = CustomerTier::Regular;
+    else if (tier == 2) q.tier = CustomerTier::Premium;
+
+    readOptionalInt("Product ID: ", q.productId);
+    readOptionalDouble("Min total: ", q.minTotal);
+    readOptionalDouble("Max total: ", q.maxTotal);
+    readOptionalInt("Finalized (1=yes, 0=no): ", q.finalized);
+
+    int sortBy = 1;
+    readOptionalInt("Sort by (1=ID, 2=Date, 3=Total, 4=Customer): ", sortBy);
+    if (sortBy == 2) q.sortBy = OrderSortKey::Date;
+    else if (sortBy == 3) q.sortBy = OrderSortKey::Total;
+    else if (sortBy == 4) q.sortBy = OrderSortKey::Customer;
+
+    int desc = 0;
+    readOptionalInt("Descending (1=yes): ", desc);
+    q.descending = desc == 1;
+
+    int offset = 0, limit = 0;
+    readOptionalInt("Offset: ", offset);
+    readOptionalInt("Limit: ", limit);
+    q.offset = offset > 0 ? static_cast<size_t>(offset) : 0;
+    q.limit = limit > 0 ? static_cast<size_t>(limit) : 0;
+
+    QueryResult result = dm.queryOrders(q);
+
     cout << "\n";
     cout << left
          << setw(10) << "OrderID"
@@ -620,7 +824,8 @@ void MenuSystem::listOrders() {
 
     cout << std::fixed << std::setprecision(2);
 
-    for (const auto& o : dm.orders()) {
+    for (size_t row : result.rows) {
+        const Order& o = dm.orders()[row];
         int cid = o.getCustomer() ? o.getCustomer()->getId() : -1;
 
         cout << left
@@ -631,19 +836,34 @@ void MenuSystem::listOrders() {
              << setw(12) << (o.getIsFinalized() ? "Yes" : "No")
              << "\n";
     }
+
+    cout << "\nShowing " << result.rows.size() << " of " << result.matched
+         << " matching orders (" << result.accessPath << ").\n";
 }
 
 void MenuSystem::viewOrderDetails() {
     int orderId = readInt("Order ID: ");
 
-    for (const auto& o : dm.orders()) {
-        if (o.getOrderId() != orderId) continue;
-
-        o.printInvoice();
+    const Order* o = dm.findOrder(orderId);
+    if (o) {
+        o->printInvoice();
         return;
     }
 
-    throw InvalidInputException("Order not found.");
+    ArchivedOrder archived;
+    if (!dm.archive().findOrder(orderId, archived)) throw InvalidInputException("Order not found.");
+
+    const Customer* c = dm.findCustomer(archived.customerId);
+    std::cout << "\nOrder ID   : " << archived.orderId << " (archived)\n"
+              << "Date       : " << archived.date << "\n"
+              << "Customer   : " << (c ? c->getName() : "N/A") << "\n"
+              << "CustomerID : " << (archived.customerId >= 0 ? std::to_string(archived.customerId) : "N/A") << "\n"
+              << "Status     : FINALIZED\n";
+    for (const auto& [pid, qty] : archived.items) {
+        const Product* p = dm.findProduct(pid);
+        std::cout << "  " << std::left << std::setw(6) << qty << (p ? p->getName() : "(removed product #" + std::to_string(pid) + ")") << "\n";
+    }
+    std::cout << std::fixed << std::setprecision(2) << "Total      : " << archived.total << "\n";
 }
 
 void MenuSystem::addItemToOrder() {
@@ -651,40 +871,109 @@ void MenuSystem::addItemToOrder() {
     int productId = readInt("Product ID: ");
     int qty = readInt("Quantity: ");
 
-    Order* orderPtr = nullptr;
-    for (auto& o : dm.orders()) {
-        if (o.getOrderId() == orderId) { orderPtr = &o; break; }
-    }
+    Order* orderPtr = dm.findOrder(orderId);
     if (!orderPtr) throw InvalidInputException("Order not found.");
 
-    Product* productPtr = nullptr;
-    for (auto& p : dm.products()) {
-        if (p.getId() == productId) { productPtr = &p; break; }
-    }
+    Product* productPtr = lookupProduct(productId);
     if (!productPtr) throw InvalidInputException("Product not found.");
 
-    orderPtr->addItem(productPtr, qty);
-    orderPtr->calculateTotal(); // show updated subtotal (optional)
+    dm.addOrderItem(*orderPtr, productPtr, qty);
 
     std::cout << "Item added.\n";
 }
 
+void MenuSystem::removeItemFromOrder() {
+    int orderId = readInt("Order ID: ");
+    int productId = readInt("Product ID to remove: ");
+
+    Order* orderPtr = dm.findOrder(orderId);
+    if (!orderPtr) throw InvalidInputException("Order not found.");
+
+    Product* productPtr = lookupProduct(productId);
+    if (!productPtr) throw InvalidInputException("Product not found.");
+
+    dm.removeOrderItem(*orderPtr, productPtr);
+    std::cout << "Item removed; its reservation was released.\n";
+}
+
 void MenuSystem::finalizeOrder() {
     int orderId = readInt("Order ID to finalize: ");
 
-    for (auto& o : dm.orders()) {
-        if (o.getOrderId() == orderId) {
-            o.finalize(dm.finance());
-            std::cout << "Order finalized.\n";
+    Order* o = dm.findOrder(orderId);
+    if (!o) throw InvalidInputException("Order not found.");
 
-            // Print invoice
-            o.printInvoice();
+    dm.finalizeOrder(*o);
+    std::cout << "Order finalized.\n";
 
-            return;
+    // Print invoice
+    o->printInvoice();
+}
+
+void MenuSystem::finalizePendingOrders() {
+    OrderQuery q;
+    q.finalized = 0;
+    q.toDate = readLine("Finalize pending orders dated up to (YYYY-MM-DD, blank = all): ");
+    q.sortBy = OrderSortKey::Date;
+
+    const QueryResult pending = dm.queryOrders(q);
+    if (pending.rows.empty()) {
+        std::cout << "No pending orders.\n";
+        return;
+    }
+
+    std::vector<int> ids;
+    ids.reserve(pending.rows.size());
+    for (size_t row : pending.rows) ids.push_back(dm.orders()[row].getOrderId());
+
+    const BatchFinalizeResult result = dm.finalizeBatch(ids);
+
+    std::cout << "Finalized " << result.finalized.size() << " of " << ids.size()
+              << " order(s); revenue " << std::fixed << std::setprecision(2) << result.revenue << ".\n";
+    for (const auto& failure : result.failed) {
+        std::cout << "  Order #" << failure.first << " skipped: " << failure.second << "\n";
+    }
+}
+
+// ---------------- About / Stats Menu ----------------
+
+void MenuSystem::aboutMenu() {
+    while (true) {
+        std::cout << "\n--- About / Stats ---\n"
+                  << "Data directory: " << dataDir << "\n"
+                  << "Products: " << dm.products().size()
+                  << ", customers: " << dm.customers().size()
+                  << ", orders: " << dm.orders().size()
+                  << ", transactions: " << dm.finance().getTransactions().size()
+                  << " (" << dm.finance().outlierCount() << " dated outside the indexed span)\n"
+                  << "1. Memory Usage\n"
+                  << "2. Operation Latency\n"
+                  << "0. Back\n";
+
+        int choice = getIntInput("Select: ", 0, 2);
+
+        switch (choice) {
+            case 1: memoryUsageReport(); break;
+            case 2:
+                std::cout << "\n=== Operation Latency (since startup) ===\n";
+                LatencyStats::print(std::cout);
+                break;
+            case 0: return;
+            default: std::cout << "Invalid choice.\n"; break;
         }
     }
+}
+
+Product* MenuSystem::lookupProduct(int productId) {
+    LatencyTimer timer(LatencyOp::ProductLookup);
+    return dm.findProduct(productId);
+}
+
+void MenuSystem::memoryUsageReport() {
+    std::cout << "\n=== Memory by Collection (estimated) ===\n";
+    dm.memoryUsage().print(std::cout);
 
-    throw InvalidInputException("Order not found.");
+    std::cout << "\n=== Live Heap by Subsystem ===\n";
+    heapUsage().print(std::cout);
 }
 
 // ---------------- Finance Menu ----------------
@@ -696,15 +985,17 @@ void MenuSystem::financeMenu() {
                   << "2. View Expense Summary\n"
                   << "3. Profit/Loss Report\n"
                   << "4. Transaction History\n"
+                  << "5. Search Transactions\n"
                   << "0. Back\n";
 
-        int choice = getIntInput("Select: ", 0, 4);
+        int choice = getIntInput("Select: ", 0, 5);
 
         switch (choice) {
             case 1: showRevenueSummary(); break;
             case 2: showExpenseSummary(); break;
             case 3: showProfitLossReport(); break;
             case 4: listTransactions(); break;
+            case 5: searchTransactions(); break;
             case 0: return;
             default: std::cout << "Invalid choice.\n"; break;
         }
@@ -712,29 +1003,152 @@ void MenuSystem::financeMenu() {
 }
 
 void MenuSystem::showRevenueSummary() {
-    std::cout << "\nTotal Revenue: " << dm.finance().getTotalRevenue() << "\n";
+    showReport("revenue", DependsOnLedger, [this](std::ostream& out) {
+        out << "\nTotal Revenue: " << dm.finance().getTotalRevenue() << "\n";
+    });
 }
 
 void MenuSystem::showExpenseSummary() {
-    std::cout << "\nTotal Expenses: " << dm.finance().getTotalExpenses() << "\n";
+    showReport("expenses", DependsOnLedger, [this](std::ostream& out) {
+        out << "\nTotal Expenses: " << dm.finance().getTotalExpenses() << "\n";
+    });
 }
 
 void MenuSystem::showProfitLossReport() {
-    std::cout << "\nProfit/Loss: " << dm.finance().calculateProfit() << "\n";
+    std::string from = readLine("From date (YYYY-MM-DD, blank for all time): ");
+    std::string to = from.empty() ? "" : readLine("To date (YYYY-MM-DD, blank for open end): ");
+
+    showReport("profit:" + from + ":" + to, DependsOnLedger, [&](std::ostream& out) {
+        const Finance& f = dm.finance();
+        if (from.empty()) {
+            out << "\nProfit/Loss: " << f.calculateProfit() << "\n";
+            return;
+        }
+        out << "\nPeriod: " << from << " to " << (to.empty() ? "latest" : to) << "\n"
+            << "Revenue: " << f.getRevenueBetween(from, to) << "\n"
+            << "Expenses: " << f.getExpensesBetween(from, to) << "\n"
+            << "Profit/Loss: " << f.calculateProfitBetween(from, to) << "\n";
+    });
 }
 
 void MenuSystem::showFinanceSummary() {
-    std::cout << "\nTotal Revenue: " << dm.finance().getTotalRevenue() << "\n"
-              << "Total Expenses: " << dm.finance().getTotalExpenses() << "\n"
-              << "Profit: " << dm.finance().calculateProfit() << "\n";
+    showReport("finance-summary", DependsOnLedger, [this](std::ostream& out) {
+        out << "\nTotal Revenue: " << dm.finance().getTotalRevenue() << "\n"
+            << "Total Expenses: " << dm.finance().getTotalExpenses() << "\n"
+            << "Profit: " << dm.finance().calculateProfit() << "\n";
+    });
+}
+
+void MenuSystem::showReport(const std::string& key, unsigned deps,
+                            const std::function<void(std::ostream&)>& render) {
+    TraceSpan span("report", key);
+    const DataEpochs& now = dm.epochs();
+    if (const std::string* cached = reportCache.lookup(key, now)) {
+        span.arg("cached", 1);
+        std::cout << *cached;
+        return;
+    }
+
+    // Money is shown to the cent, as on every other screen
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    render(out);
+    std::cout << out.str();
+    reportCache.store(key, deps, now, out.str());
+}
+
+const std::vector<MenuSystem::NamedReport>& MenuSystem::namedReports() {
+    static const std::vector<NamedReport> reports = {
+        {"best-selling", &MenuSystem::bestSellingProductsReport},
+        {"risk-inventory", &MenuSystem::riskInventoryReport},
+        {"top-customers", &MenuSystem::topCustomersReport},
+        {"inventory-valuation", &MenuSystem::inventoryValuationReport},
+        {"monthly-sales", &MenuSystem::monthlySalesReport},
+        {"smart-risk", &MenuSystem::smartRiskReport},
+    };
+    return reports;
+}
+
+std::vector<std::string> MenuSystem::reportNames() {
+    std::vector<std::string> names;
+    for (const auto& r : namedReports()) names.push_back(r.name);
+    return names;
+}
+
+bool MenuSystem::renderReport(const std::string& name, std::ostream& out) {
+    for (const auto& r : namedReports()) {
+        if (name == r.name) {
+            TraceSpan span("report", name);
+            (this->*r.render)(out);
+            return true;
+        }
+    }
+    return false;
+}
+
+void MenuSystem::reportCacheStats() {
+    const uint64_t hits = reportCache.hits();
+    const uint64_t misses = reportCache.misses();
+    const uint64_t total = hits + misses;
+
+    std::cout << "\n=== Report Cache ===\n"
+              << "Entries: " << reportCache.size() << "\n"
+              << "Hits: " << hits << "\n"
+              << "Misses: " << misses << "\n"
+              << "Hit rate: " << std::fixed << std::setprecision(1)
+              << (total ? 100.0 * hits / total : 0.0) << "%\n";
 }
 
 void MenuSystem::listTransactions() {
+    using Col = TableRenderer::Column;
+    const auto Left = TableRenderer::Align::Left;
+
+    static const TableRenderer table({Col{"Type", 12, Left}, Col{"Amount", 12, Left}, Col{"Date", 15, Left},
+                                      Col{"Description", 25, Left}},
+                                     74);
+
+    const auto& tx = dm.finance().getTransactions();
+    pageTable(table, tx.size(), [&](size_t i, TableRenderer::Row& row) {
+        const auto& t = tx[i];
+        row.text(t.type).decimal(t.amount).text(t.date).text(t.description);
+    });
+}
+
+void MenuSystem::searchTransactions() {
     using std::cout;
     using std::left;
-    using std::right;
     using std::setw;
 
+    cout << "\nLeave any field blank to skip it.\n";
+
+    LedgerQuery q;
+    q.fromDate = readLine("From date (YYYY-MM-DD): ");
+    q.toDate = readLine("To date (YYYY-MM-DD): ");
+
+    int type = 0;
+    readOptionalInt("Type (1=Revenue, 2=Expense): ", type);
+    if (type == 1) q.type = "Revenue";
+    else if (type == 2) q.type = "Expense";
+
+    readOptionalDouble("Min amount: ", q.minAmount);
+    readOptionalDouble("Max amount: ", q.maxAmount);
+
+    int sortBy = 1;
+    readOptionalInt("Sort by (1=Entry order, 2=Date, 3=Amount): ", sortBy);
+    if (sortBy == 2) q.sortBy = LedgerSortKey::Date;
+    else if (sortBy == 3) q.sortBy = LedgerSortKey::Amount;
+
+    int desc = 0;
+    readOptionalInt("Descending (1=yes): ", desc);
+    q.descending = desc == 1;
+
+    int offset = 0, limit = 0;
+    readOptionalInt("Offset: ", offset);
+    readOptionalInt("Limit: ", limit);
+    q.offset = offset > 0 ? static_cast<size_t>(offset) : 0;
+    q.limit = limit > 0 ? static_cast<size_t>(limit) : 0;
+
+    QueryResult result = dm.queryTransactions(q);
     const auto& tx = dm.finance().getTransactions();
 
     cout << "\n";
@@ -749,7 +1163,8 @@ void MenuSystem::listTransactions() {
 
     cout << std::fixed << std::setprecision(2);
 
-    for (const auto& t : tx) {
+    for (size_t row : result.rows) {
+        const auto& t = tx[row];
         cout << left
              << setw(12) << t.type
              << setw(12) << t.amount
@@ -757,16 +1172,18 @@ void MenuSystem::listTransactions() {
              << setw(25) << t.description
              << "\n";
     }
+
+    cout << "\nShowing " << result.rows.size() << " of " << result.matched
+         << " matching transactions (" << result.accessPath << ").\n";
 }
 
-void MenuSystem::bestSellingProductsReport() {
-    using std::cout;
+void MenuSystem::bestSellingProductsReport(std::ostream& out) {
     using std::left;
     using std::right;
     using std::setw;
 
     // productId -> totalQtySold
-    std::unordered_map<int, int> qtySold;
+    std::unordered_map<int, long long> qtySold;
 
     // 1) Aggregate sales from finalized orders only
     for (const auto& o : dm.orders()) {
@@ -780,9 +1197,12 @@ void MenuSystem::bestSellingProductsReport() {
             qtySold[p->getId()] += qty;
         }
     }
+    for (const auto& [pid, units] : dm.archive().unitsByProduct()) {
+        qtySold[pid] += units;
+    }
 
     // 2) Build sortable rows: (productId, totalQtySold)
-    std::vector<std::pair<int, int>> rows;
+    std::vector<std::pair<int, long long>> rows;
     rows.reserve(qtySold.size());
     for (const auto& kv : qtySold) {
         rows.push_back({kv.first, kv.second});
@@ -796,21 +1216,21 @@ void MenuSystem::bestSellingProductsReport() {
               });
 
     // 4) Print
-    cout << "\n=== Best Selling Products (Finalized Orders Only) ===\n";
+    out << "\n=== Best Selling Products (Finalized Orders Only) ===\n";
 
     if (rows.empty()) {
-        cout << "No finalized sales yet.\n";
+        out << "No finalized sales yet.\n";
         return;
     }
 
-    cout << left
+    out << left
          << setw(6)  << "Rank"
          << setw(8)  << "ID"
          << setw(30) << "Name"
          << setw(12) << "SoldQty"
          << "\n";
 
-    cout << "-----------------------------------------------------------------\n";
+    out << "-----------------------------------------------------------------\n";
 
     int rank = 1;
     for (const auto& [pid, sold] : rows) {
@@ -823,7 +1243,7 @@ void MenuSystem::bestSellingProductsReport() {
             }
         }
 
-        cout << left
+        out << left
              << setw(6)  << rank
              << setw(8)  << pid
              << setw(30) << name
@@ -833,8 +1253,7 @@ void MenuSystem::bestSellingProductsReport() {
         rank++;
     }
 }
-void MenuSystem::topCustomersReport() {
-    using std::cout;
+void MenuSystem::topCustomersReport(std::ostream& out) {
     using std::left;
     using std::right;
     using std::setw;
@@ -848,6 +1267,9 @@ void MenuSystem::topCustomersReport() {
         int cid = o.getCustomer()->getId();
         spending[cid] += o.getTotalAmount();
     }
+    for (const auto& [cid, totals] : dm.archive().customerTotals()) {
+        spending[cid] += totals.spent;
+    }
 
     std::vector<std::pair<int, double>> rows(spending.begin(), spending.end());
 
@@ -856,9 +1278,9 @@ void MenuSystem::topCustomersReport() {
                   return a.second > b.second;
               });
 
-    cout << "\n=== Top Customers ===\n";
+    out << "\n=== Top Customers ===\n";
 
-    cout << left
+    out << left
          << setw(6)  << "Rank"
          << setw(8)  << "ID"
          << setw(20) << "Name"
@@ -866,8 +1288,8 @@ void MenuSystem::topCustomersReport() {
          << setw(15) << "Total Spent"
          << "\n";
 
-    cout << "------------------------------------------------------\n";
-    cout << std::fixed << std::setprecision(2);
+    out << "------------------------------------------------------\n";
+    out << std::fixed << std::setprecision(2);
 
     int rank = 1;
     for (auto& [cid, total] : rows) {
@@ -879,7 +1301,7 @@ void MenuSystem::topCustomersReport() {
             }
         }
 
-        cout << left
+        out << left
              << setw(6)  << rank++
              << setw(8)  << cid
              << setw(20) << name
@@ -889,33 +1311,32 @@ void MenuSystem::topCustomersReport() {
     }
 
     if (rows.empty())
-        cout << "No finalized sales yet.\n";
+        out << "No finalized sales yet.\n";
 }
-void MenuSystem::inventoryValuationReport() {
-    using std::cout;
+void MenuSystem::inventoryValuationReport(std::ostream& out) {
     using std::left;
     using std::right;
     using std::setw;
 
     double totalValue = 0.0;
 
-    cout << "\n=== Inventory Valuation ===\n";
+    out << "\n=== Inventory Valuation ===\n";
 
-    cout << left
+    out << left
          << setw(8)  << "ID"
          << setw(30) << "Name"
          << setw(12) << "Stock"
          << setw(15) << "Value"
          << "\n";
 
-    cout << "----------------------------------------------------------------\n";
-    cout << std::fixed << std::setprecision(2);
+    out << "----------------------------------------------------------------\n";
+    out << std::fixed << std::setprecision(2);
 
     for (const auto& p : dm.products()) {
         double value = p.getQuantity() * p.getCost();
         totalValue += value;
 
-        cout << left
+        out << left
              << setw(8)  << p.getId()
              << setw(30) << p.getName()
              << setw(12) << p.getQuantity()
@@ -923,10 +1344,9 @@ void MenuSystem::inventoryValuationReport() {
              << "\n";
     }
 
-    cout << "\nTotal Inventory Value: " << totalValue << "\n";
+    out << "\nTotal Inventory Value: " << totalValue << "\n";
 }
-void MenuSystem::monthlySalesReport() {
-    using std::cout;
+void MenuSystem::monthlySalesReport(std::ostream& out) {
     using std::left;
     using std::right;
     using std::setw;
@@ -941,24 +1361,27 @@ void MenuSystem::monthlySalesReport() {
 
         monthly[month] += o.getTotalAmount();
     }
+    for (const auto& [month, revenue] : dm.archive().revenueByMonth()) {
+        monthly[month] += revenue;
+    }
 
     std::vector<std::pair<std::string, double>> rows(monthly.begin(), monthly.end());
 
     std::sort(rows.begin(), rows.end());
 
-    cout << "\n=== Monthly Sales Report ===\n";
+    out << "\n=== Monthly Sales Report ===\n";
 
-    cout << left
+    out << left
          << setw(10) << "Month"
          << right
          << setw(15) << "Revenue"
          << "\n";
 
-    cout << "------------------------------\n";
-    cout << std::fixed << std::setprecision(2);
+    out << "------------------------------\n";
+    out << std::fixed << std::setprecision(2);
 
     for (auto& [month, revenue] : rows) {
-        cout << left
+        out << left
              << setw(10) << month
              << right
              << setw(15) << revenue
@@ -966,11 +1389,10 @@ void MenuSystem::monthlySalesReport() {
     }
 
     if (rows.empty())
-        cout << "No sales data.\n";
+        out << "No sales data.\n";
 }
 
-void MenuSystem::riskInventoryReport() {
-    using std::cout;
+void MenuSystem::riskInventoryReport(std::ostream& out) {
     using std::left;
     using std::right;
     using std::setw;
@@ -979,7 +1401,7 @@ void MenuSystem::riskInventoryReport() {
     int lowSalesThreshold  = 5;
 
     // Count total sold quantities
-    std::unordered_map<int, int> qtySold;
+    std::unordered_map<int, long long> qtySold;
 
     for (const auto& o : dm.orders()) {
         if (!o.getIsFinalized()) continue;
@@ -992,12 +1414,15 @@ void MenuSystem::riskInventoryReport() {
             qtySold[p->getId()] += qty;
         }
     }
+    for (const auto& [pid, units] : dm.archive().unitsByProduct()) {
+        qtySold[pid] += units;
+    }
 
-    cout << "\n=== Risk Inventory Report ===\n";
-    cout << "High Stock > " << highStockThreshold
+    out << "\n=== Risk Inventory Report ===\n";
+    out << "High Stock > " << highStockThreshold
          << " AND Sold < " << lowSalesThreshold << "\n\n";
 
-    cout << left
+    out << left
          << setw(8)  << "ID"
          << setw(22) << "Name"
          << right
@@ -1005,20 +1430,20 @@ void MenuSystem::riskInventoryReport() {
          << setw(12) << "Sold"
          << "\n";
 
-    cout << "------------------------------------------------------------\n";
+    out << "------------------------------------------------------------\n";
 
     bool found = false;
 
     for (const auto& p : dm.products()) {
         int currentStock = p.getQuantity();
-        int sold = qtySold[p.getId()];  // default 0 if not sold
+        long long sold = qtySold[p.getId()];  // default 0 if not sold
 
         if (currentStock > highStockThreshold &&
             sold < lowSalesThreshold) {
 
             found = true;
 
-            cout << left
+            out << left
                  << setw(8)  << p.getId()
                  << setw(22) << p.getName()
                  << right
@@ -1029,17 +1454,16 @@ void MenuSystem::riskInventoryReport() {
     }
 
     if (!found) {
-        cout << "No risky inventory detected.\n";
+        out << "No risky inventory detected.\n";
     }
 }
 
-void MenuSystem::smartRiskReport() {
-    using std::cout;
+void MenuSystem::smartRiskReport(std::ostream& out) {
     using std::left;
     using std::right;
     using std::setw;
 
-    std::unordered_map<int, int> qtySold;
+    std::unordered_map<int, long long> qtySold;
 
     for (const auto& o : dm.orders()) {
         if (!o.getIsFinalized()) continue;
@@ -1048,19 +1472,22 @@ void MenuSystem::smartRiskReport() {
             qtySold[it.first->getId()] += it.second;
         }
     }
+    for (const auto& [pid, units] : dm.archive().unitsByProduct()) {
+        qtySold[pid] += units;
+    }
 
     struct Row {
         int id;
         std::string name;
         int stock;
-        int sold;
+        long long sold;
         double risk;
     };
 
     std::vector<Row> rows;
 
     for (const auto& p : dm.products()) {
-        int sold = qtySold[p.getId()];
+        long long sold = qtySold[p.getId()];
         int stock = p.getQuantity();
         double risk = stock / double(sold + 1);
 
@@ -1072,9 +1499,9 @@ void MenuSystem::smartRiskReport() {
                   return a.risk > b.risk;
               });
 
-    cout << "\n=== Smart Risk Inventory Report ===\n";
+    out << "\n=== Smart Risk Inventory Report ===\n";
 
-    cout << left
+    out << left
          << setw(6)  << "ID"
          << setw(30) << "Name"
          << setw(10) << "Stock"
@@ -1082,11 +1509,11 @@ void MenuSystem::smartRiskReport() {
          << setw(12) << "Risk Score"
          << "\n";
 
-    cout << "----------------------------------------------------------------------\n";
-    cout << std::fixed << std::setprecision(2);
+    out << "----------------------------------------------------------------------\n";
+    out << std::fixed << std::setprecision(2);
 
     for (const auto& r : rows) {
-        cout << left
+        out << left
              << setw(6)  << r.id
              << setw(30) << r.name
              << setw(10) << r.stock
@@ -1096,6 +1523,284 @@ void MenuSystem::smartRiskReport() {
     }
 }
 
+void MenuSystem::velocityRiskReport() {
+    std::string asOf = readLine("As-of date (YYYY-MM-DD, blank for today): ");
+    int asOfDay = DateUtil::todayDayNumber();
+    if (!asOf.empty() && !DateUtil::toDayNumber(asOf, asOfDay)) {
+        throw InvalidInputException("Invalid date: " + asOf);
+    }
+    int window = getIntInput("Velocity window in days (e.g. 7/30/90): ", 1, 3650);
+
+    showReport("velocity:" + std::to_string(asOfDay) + ":" + std::to_string(window),
+               DependsOnProducts | DependsOnOrders,
+               [&](std::ostream& out) { renderVelocityRisk(out, asOfDay, window); });
+}
+
+void MenuSystem::renderVelocityRisk(std::ostream& out, int asOfDay, int window) {
+    using std::left;
+    using std::right;
+    using std::setw;
+
+    const SalesVelocity& velocity = dm.salesVelocity();
+
+    struct Row {
+        int id;
+        std::string name;
+        int stock;
+        long long sold7;
+        long long sold30;
+        long long sold90;
+        double perDay;
+        double cover;   // days of cover; negative when there were no sales in the window
+    };
+
+    std::vector<Row> rows;
+    rows.reserve(dm.products().size());
+
+    for (const auto& p : dm.products()) {
+        const int pid = p.getId();
+        const double perDay = velocity.dailyVelocity(pid, asOfDay, window);
+        const double cover = perDay > 0.0 ? p.getQuantity() / perDay : -1.0;
+
+        rows.push_back({pid, p.getName(), p.getQuantity(),
+                        velocity.unitsInLastDays(pid, asOfDay, 7),
+                        velocity.unitsInLastDays(pid, asOfDay, 30),
+                        velocity.unitsInLastDays(pid, asOfDay, 90),
+                        perDay, cover});
+    }
+
+    // Shortest cover first; products with no recent sales go last
+    std::sort(rows.begin(), rows.end(),
+              [](const Row& a, const Row& b) {
+                  if ((a.cover < 0.0) != (b.cover < 0.0)) return b.cover < 0.0;
+                  if (a.cover != b.cover) return a.cover < b.cover;
+                  return a.id < b.id;
+              });
+
+    out << "\n=== Velocity Risk Report (as of " << DateUtil::fromDayNumber(asOfDay)
+         << ", " << window << "-day velocity) ===\n";
+
+    out << left
+         << setw(6)  << "ID"
+         << setw(26) << "Name"
+         << right
+         << setw(8)  << "Stock"
+         << setw(8)  << "7d"
+         << setw(8)  << "30d"
+         << setw(8)  << "90d"
+         << setw(10) << "Per Day"
+         << setw(14) << "Days Cover"
+         << "\n";
+
+    out << "--------------------------------------------------------------------------------------\n";
+    out << std::fixed << std::setprecision(2);
+
+    for (const auto& r : rows) {
+        out << left
+             << setw(6)  << r.id
+             << setw(26) << r.name.substr(0, 25)
+             << right
+             << setw(8)  << r.stock
+             << setw(8)  << r.sold7
+             << setw(8)  << r.sold30
+             << setw(8)  << r.sold90
+             << setw(10) << r.perDay;
+        if (r.cover < 0.0) {
+            out << setw(14) << "no sales";
+        } else {
+            out << setw(14) << r.cover;
+        }
+        out << "\n";
+    }
+}
+
+void MenuSystem::approximateAnalyticsReport() {
+    using std::cout;
+    using std::left;
+    using std::right;
+    using std::setw;
+
+    int topK = getIntInput("Heavy hitters to show (1-100): ", 1, 100);
+    std::string extraDirs = readLine("Extra data directories to merge (comma-separated, blank for none): ");
+
+    TraceSpan span("report:approximate-analytics");
+    OrderSketches sketches = OrderSketches::build(dm.orders(), static_cast<size_t>(topK));
+
+    // Other stores: load, sketch, merge, and drop the full data again
+    size_t start = 0;
+    while (start < extraDirs.size()) {
+        size_t comma = extraDirs.find(',', start);
+        if (comma == std::string::npos) comma = extraDirs.size();
+
+        std::string dir = extraDirs.substr(start, comma - start);
+        dir.erase(0, dir.find_first_not_of(" \t"));
+        dir.erase(dir.find_last_not_of(" \t") + 1);
+        start = comma + 1;
+        if (dir.empty()) continue;
+
+        DataManager other;
+        other.loadAll(dir);
+        sketches.merge(OrderSketches::build(other.orders(), static_cast<size_t>(topK)));
+        cout << "Merged sketches from: " << dir << "\n";
+    }
+
+    const HeavyHitters& heavy = sketches.heavyHitters();
+    const CountMinSketch& cms = heavy.sketch();
+
+    cout << "\n=== Approximate Analytics (Finalized Orders) ===\n";
+    cout << std::fixed << std::setprecision(2);
+
+    HyperLogLog probe(OrderSketches::kMonthPrecision);
+    cout << "\nDistinct customers per month (+/- " << probe.standardError() * 100.0
+         << "% std. error)\n";
+    cout << left << setw(10) << "Month" << right << setw(15) << "Customers" << "\n";
+    cout << "-------------------------\n";
+    for (const auto& [month, hll] : sketches.monthlyCustomers()) {
+        cout << left << setw(10) << month
+             << right << setw(15) << std::llround(hll.estimate()) << "\n";
+    }
+    if (sketches.monthlyCustomers().empty()) cout << "No sales data.\n";
+
+    HyperLogLog productProbe(OrderSketches::kProductPrecision);
+    cout << "\nHeavy-hitter products (units overcount <= "
+         << std::llround(cms.epsilon() * cms.totalCount()) << " with "
+         << (1.0 - cms.delta()) * 100.0 << "% probability; buyers +/- "
+         << productProbe.standardError() * 100.0 << "%)\n";
+
+    cout << left
+         << setw(6)  << "Rank"
+         << setw(8)  << "ID"
+         << setw(30) << "Name"
+         << right
+         << setw(12) << "~Units"
+         << setw(12) << "~Buyers"
+         << "\n";
+    cout << "--------------------------------------------------------------------\n";
+
+    int rank = 1;
+    for (const auto& [pid, units] : heavy.top()) {
+        std::string name = "(unknown)";
+        for (const auto& p : dm.products()) {
+            if (p.getId() == pid) { name = p.getName(); break; }
+        }
+
+        const double buyers = sketches.distinctBuyers(pid);
+        cout << left
+             << setw(6)  << rank++
+             << setw(8)  << pid
+             << setw(30) << name.substr(0, 29)
+             << right
+             << setw(12) << units
+             << setw(12) << (buyers < 0 ? std::string("n/a") : std::to_string(std::llround(buyers)))
+             << "\n";
+    }
+    if (heavy.top().empty()) cout << "No finalized sales yet.\n";
+
+    cout << "\nSketch memory: " << sketches.memoryBytes() / 1024 << " KiB\n";
+}
+
+void MenuSystem::rfmSegmentationReport() {
+    using std::cout;
+    using std::left;
+    using std::right;
+    using std::setw;
+
+    std::string asOf = readLine("As-of date (YYYY-MM-DD, blank for today): ");
+    int asOfDay = DateUtil::todayDayNumber();
+    if (!asOf.empty() && !DateUtil::toDayNumber(asOf, asOfDay)) {
+        throw InvalidInputException("Invalid date: " + asOf);
+    }
+
+    RfmCutoffs cut{};
+    std::vector<RfmRow> rows;
+    {
+        TraceSpan span("report:rfm");
+        rows = RfmAnalysis::compute(dm.customers(), dm.orders(), asOfDay, &cut, &dm.archive());
+    }
+
+    // Segment summary
+    struct Summary { size_t customers = 0; double revenue = 0.0; };
+    std::vector<std::pair<std::string, Summary>> segments;
+    for (const auto& r : rows) {
+        auto it = std::find_if(segments.begin(), segments.end(),
+                               [&](const auto& s) { return s.first == r.segment; });
+        if (it == segments.end()) {
+            segments.push_back({r.segment, Summary{}});
+            it = segments.end() - 1;
+        }
+        it->second.customers++;
+        it->second.revenue += r.monetary;
+    }
+    std::sort(segments.begin(), segments.end(),
+              [](const auto& a, const auto& b) { return a.second.revenue > b.second.revenue; });
+
+    cout << "\n=== RFM Segmentation (as of " << DateUtil::fromDayNumber(asOfDay) << ") ===\n";
+    cout << std::fixed << std::setprecision(2);
+    cout << "Quintile cutoffs  R(days): " << cut.recency[0] << "/" << cut.recency[1] << "/"
+         << cut.recency[2] << "/" << cut.recency[3]
+         << "  F: " << cut.frequency[0] << "/" << cut.frequency[1] << "/"
+         << cut.frequency[2] << "/" << cut.frequency[3]
+         << "  M: " << cut.monetary[0] << "/" << cut.monetary[1] << "/"
+         << cut.monetary[2] << "/" << cut.monetary[3] << "\n\n";
+    // The archive keeps per-customer totals only, so it cannot be cut at asOfDay
+    const OrderArchive& archive = dm.archive();
+    if (archive.orderCount() > 0 && archive.lastDay() > asOfDay) {
+        cout << "Note: archived orders run to " << DateUtil::fromDayNumber(archive.lastDay())
+             << ", after the as-of date, so " << archive.orderCount()
+             << " archived order(s) are left out of these scores.\n\n";
+    }
+
+    cout << left << setw(22) << "Segment"
+         << right << setw(12) << "Customers" << setw(16) << "Revenue" << "\n";
+    cout << "--------------------------------------------------\n";
+    for (const auto& [name, s] : segments) {
+        cout << left << setw(22) << name
+             << right << setw(12) << s.customers << setw(16) << s.revenue << "\n";
+    }
+
+    int limit = 0;
+    readOptionalInt("\nShow top N customers by RFM score (blank to skip): ", limit);
+    if (limit > 0) {
+        std::vector<const RfmRow*> ranked;
+        ranked.reserve(rows.size());
+        for (const auto& r : rows) ranked.push_back(&r);
+
+        const size_t n = std::min(ranked.size(), static_cast<size_t>(limit));
+        std::partial_sort(ranked.begin(), ranked.begin() + n, ranked.end(),
+                          [](const RfmRow* a, const RfmRow* b) {
+                              const int sa = a->r + a->f + a->m, sb = b->r + b->f + b->m;
+                              if (sa != sb) return sa > sb;
+                              if (a->monetary != b->monetary) return a->monetary > b->monetary;
+                              return a->customerId < b->customerId;
+                          });
+
+        cout << left << setw(8) << "ID"
+             << right << setw(10) << "Recency" << setw(8) << "Freq" << setw(14) << "Monetary"
+             << setw(6) << "R" << setw(4) << "F" << setw(4) << "M"
+             << "  " << left << "Segment" << "\n";
+        cout << "------------------------------------------------------------------------\n";
+        for (size_t i = 0; i < n; ++i) {
+            const RfmRow& r = *ranked[i];
+            cout << left << setw(8) << r.customerId
+                 << right << setw(10) << r.recencyDays << setw(8) << r.frequency
+                 << setw(14) << r.monetary
+                 << setw(6) << r.r << setw(4) << r.f << setw(4) << r.m
+                 << "  " << left << r.segment << "\n";
+        }
+    }
+
+    double loyalty = 0.0;
+    if (!readOptionalDouble("\nUpgrade regular Champions to Premium with loyalty (fraction, blank to skip): ", loyalty)) {
+        return;
+    }
+
+    std::vector<int> champions;
+    for (const auto& r : rows) {
+        if (r.r >= 4 && r.f >= 4 && r.m >= 4) champions.push_back(r.customerId);
+    }
+    size_t upgraded = dm.upgradeCustomers(champions, loyalty);
+    cout << "Upgraded " << upgraded << " customer(s) to Premium.\n";
+}
 
 // ---------------- Reports Menu (placeholder) ----------------
 
@@ -1108,17 +1813,43 @@ void MenuSystem::reportsMenu() {
                   << "4. Inventory Valuation\n"
                   << "5. Monthly Sales\n"
                   << "6. Smart Risk Score\n"
+                  << "7. Velocity Risk (Days of Cover)\n"
+                  << "8. Approximate Analytics (Sketches)\n"
+                  << "9. RFM Customer Segmentation\n"
+                  << "10. Report Cache Stats\n"
                   << "0. Back\n";
 
-        int choice = getIntInput("Select: ", 0, 6);
+        int choice = getIntInput("Select: ", 0, 10);
 
         switch (choice) {
-            case 1: bestSellingProductsReport(); break;
-            case 2: riskInventoryReport(); break;
-            case 3: topCustomersReport(); break;
-            case 4: inventoryValuationReport(); break;
-            case 5: monthlySalesReport(); break;
-            case 6: smartRiskReport(); break;
+            case 1:
+                showReport("best-selling", DependsOnProducts | DependsOnOrders,
+                           [this](std::ostream& out) { bestSellingProductsReport(out); });
+                break;
+            case 2:
+                showReport("risk-inventory", DependsOnProducts | DependsOnOrders,
+                           [this](std::ostream& out) { riskInventoryReport(out); });
+                break;
+            case 3:
+                showReport("top-customers", DependsOnCustomers | DependsOnOrders,
+                           [this](std::ostream& out) { topCustomersReport(out); });
+                break;
+            case 4:
+                showReport("inventory-valuation", DependsOnProducts,
+                           [this](std::ostream& out) { inventoryValuationReport(out); });
+                break;
+            case 5:
+                showReport("monthly-sales", DependsOnOrders,
+                           [this](std::ostream& out) { monthlySalesReport(out); });
+                break;
+            case 6:
+                showReport("smart-risk", DependsOnProducts | DependsOnOrders,
+                           [this](std::ostream& out) { smartRiskReport(out); });
+                break;
+            case 7: velocityRiskReport(); break;
+            case 8: approximateAnalyticsReport(); break;
+            case 9: rfmSegmentationReport(); dm.saveAll(dataDir); break;
+            case 10: reportCacheStats(); break;
             case 0: return;
             default: std::cout << "Invalid choice.\n"; break;
         }
@@ -1,13 +1,45 @@
 #include "Order.h"
 #include "Exceptions.h"
 #include "Finance.h"
+#include "Trace.h"
+#include "LatencyStats.h"
+#include "TextFormat.h"
 
 #include <iostream>
-#include <iomanip>
 #include <algorithm>
+#include <mutex>
 #include <string>
 #include <utility>
 
+namespace {
+// Serializes the ledger/history tail of finalize(); stock is reserved lock-free before it.
+std::mutex g_finalizeTailMutex;
+
+// Takes stock for every line of an order or none of it: each line is
+// reserved with a CAS decrement, and anything taken is put back unless
+// commit() is reached.
+class StockReservation {
+public:
+    ~StockReservation() {
+        if (!committed) {
+            for (auto& line : taken) line.first->releaseReserved(line.second);
+        }
+    }
+
+    bool reserve(Product* product, int qty) {
+        if (!product->tryReserve(qty)) return false;
+        taken.emplace_back(product, qty);
+        return true;
+    }
+
+    void commit() { committed = true; }
+
+private:
+    std::vector<std::pair<Product*, int>> taken;
+    bool committed = false;
+};
+} // namespace
+
 Order::Order(int orderId, Customer* customer, const std::string& date)
     : orderId(orderId),
       customer(customer),
@@ -15,6 +47,39 @@ Order::Order(int orderId, Customer* customer, const std::string& date)
       totalAmount(0.0),
       isFinalized(false) {}
 
+Order::Order(const Order& other)
+    : orderId(other.orderId), customer(other.customer), items(other.items), date(other.date),
+      totalAmount(other.totalAmount), isFinalized(other.isFinalized.load()) {}
+
+Order::Order(Order&& other) noexcept
+    : orderId(other.orderId), customer(other.customer), items(std::move(other.items)),
+      date(std::move(other.date)), totalAmount(other.totalAmount),
+      isFinalized(other.isFinalized.load()) {}
+
+Order& Order::operator=(const Order& other) {
+    if (this != &other) {
+        orderId = other.orderId;
+        customer = other.customer;
+        items = other.items;
+        date = other.date;
+        totalAmount = other.totalAmount;
+        isFinalized.store(other.isFinalized.load());
+    }
+    return *this;
+}
+
+Order& Order::operator=(Order&& other) noexcept {
+    if (this != &other) {
+        orderId = other.orderId;
+        customer = other.customer;
+        items = std::move(other.items);
+        date = std::move(other.date);
+        totalAmount = other.totalAmount;
+        isFinalized.store(other.isFinalized.load());
+    }
+    return *this;
+}
+
 int Order::getOrderId() const {
     return orderId;
 }
@@ -40,6 +105,7 @@ bool Order::getIsFinalized() const {
 }
 
 void Order::addItem(Product* product, int qty) {
+    LatencyTimer timer(LatencyOp::AddItem);
     if (!product) {
         throw InvalidInputException("Product is null.");
     }
@@ -87,10 +153,24 @@ void Order::addLoadedItem(Product* product, int qty) {
     items.emplace_back(product, qty);
 }
 
+void Order::reserveItems(size_t count) {
+    items.reserve(count);
+}
+
 void Order::setTotalAmount(double amount) {
     totalAmount = amount;
 }
 
+void Order::setCustomer(Customer* c) {
+    customer = c;
+}
+
+void Order::relinkProducts(const std::function<Product*(Product*)>& remap) {
+    for (auto& it : items) {
+        if (it.first) it.first = remap(it.first);
+    }
+}
+
 void Order::removeItem(Product* product) {
     if (isFinalized) {
         throw InvalidInputException("Cannot modify a finalized order.");
@@ -116,7 +196,7 @@ double Order::calculateTotal() {
 }
 
 
-void Order::finalize(Finance& finance) {
+double Order::finalTotal() const {
     if (isFinalized) {
         throw InvalidInputException("Order already finalized.");
     }
@@ -127,37 +207,61 @@ void Order::finalize(Finance& finance) {
         throw InvalidInputException("Cannot finalize an empty order.");
     }
 
-    // Step 1: Calculate subtotal
-    calculateTotal();
+    double subtotal = 0.0;
+    for (const auto& item : items) {
+        if (!item.first) {
+            throw InvalidInputException("Order references a removed product.");
+        }
+        subtotal += item.first->getPrice() * item.second;
+    }
 
-    // Step 2: Apply discount
     double discount = customer->calculateDiscount();
     if (discount < 0.0 || discount >= 1.0) {
         throw InvalidInputException("Invalid discount value.");
     }
-    totalAmount = totalAmount * (1.0 - discount);
+    return subtotal * (1.0 - discount);
+}
+
+void Order::markFinalized(double total) {
+    totalAmount = total;
+    customer->addOrderToHistory(orderId);
+    isFinalized = true;
+}
 
-    // Step 3: Update stock (reduce inventory)
+void Order::finalize(Finance& finance) {
+    LatencyTimer timer(LatencyOp::Finalize);
+    TraceSpan span("Order::finalize");
+    span.arg("order", orderId);
+    // Step 1: Validate and price (subtotal minus customer discount)
+    const double total = finalTotal();
+
+    // Step 2: Reserve stock for every item, all-or-nothing
+    StockReservation reservation;
     for (auto& item : items) {
-        Product* product = item.first;
-        int qty = item.second;
+        if (!reservation.reserve(item.first, item.second)) {
+            throw InsufficientStockException("Insufficient stock for product: " + item.first->getName());
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(g_finalizeTailMutex);
 
-        // updateStock should throw if it goes negative
-        product->updateStock(-qty);
+    // Another thread may have finalized this order since the check above;
+    // the reservation gives the stock back
+    if (isFinalized) {
+        throw InvalidInputException("Order already finalized.");
     }
 
-    // Step 4: Record revenue
+    // Step 3: Record revenue
     finance.recordRevenue(
-        totalAmount,
+        total,
         "Order #" + std::to_string(orderId),
-        date
+        date,
+        orderId
     );
 
-    // Step 5: Customer order history
-    customer->addOrderToHistory(orderId);
-
-    // Step 6: Lock the order
-    isFinalized = true;
+    // Step 4: Customer order history, lock the order and keep the stock
+    markFinalized(total);
+    reservation.commit();
 }
 
 void Order::setFinalized(bool v) {
@@ -165,32 +269,43 @@ void Order::setFinalized(bool v) {
 }
 
 void Order::printInvoice() const {
-    using std::cout;
-    using std::left;
-    using std::right;
-    using std::setw;
-
-    cout << "\n============================================================\n";
-    cout << "                     INVOICE / RECEIPT\n";
-    cout << "============================================================\n";
-
-    cout << "Order ID   : " << orderId << "\n";
-    cout << "Date       : " << date << "\n";
-    cout << "Customer   : " << (customer ? customer->getName() : "N/A") << "\n";
-    cout << "CustomerID : " << (customer ? std::to_string(customer->getId()) : "N/A") << "\n";
-    cout << "Status     : " << (isFinalized ? "FINALIZED" : "PENDING") << "\n";
-
-    cout << "------------------------------------------------------------\n";
-    cout << left
-         << setw(6)  << "Qty"
-         << setw(22) << "Item"
-         << right
-         << setw(12) << "Unit"
-         << setw(12) << "Line"
-         << "\n";
-    cout << "------------------------------------------------------------\n";
-
-    cout << std::fixed << std::setprecision(2);
+    LatencyTimer timer(LatencyOp::PrintInvoice);
+    std::string text;
+    renderInvoice(text);
+    std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+void Order::renderInvoice(std::string& out) const {
+    using Align = TextFormat::Align;
+    const char* rule = "------------------------------------------------------------\n";
+
+    out += "\n============================================================\n";
+    out += "                     INVOICE / RECEIPT\n";
+    out += "============================================================\n";
+
+    out += "Order ID   : ";
+    TextFormat::integer(out, orderId);
+    out += "\nDate       : ";
+    out += date;
+    out += "\nCustomer   : ";
+    out += customer ? customer->getName() : "N/A";
+    out += "\nCustomerID : ";
+    if (customer) {
+        TextFormat::integer(out, customer->getId());
+    } else {
+        out += "N/A";
+    }
+    out += "\nStatus     : ";
+    out += isFinalized ? "FINALIZED" : "PENDING";
+    out += "\n";
+
+    out += rule;
+    TextFormat::pad(out, "Qty", 6);
+    TextFormat::pad(out, "Item", 22);
+    TextFormat::pad(out, "Unit", 12, Align::Right);
+    TextFormat::pad(out, "Line", 12, Align::Right);
+    out += "\n";
+    out += rule;
 
     double subtotal = 0.0;
     for (const auto& it : items) {
@@ -202,16 +317,14 @@ void Order::printInvoice() const {
         double line = unit * qty;
         subtotal += line;
 
-        cout << left
-             << setw(6)  << qty
-             << setw(22) << p->getName().substr(0, 21)   // prevent overflow
-             << right
-             << setw(12) << unit
-             << setw(12) << line
-             << "\n";
+        TextFormat::integer(out, qty, 6);
+        TextFormat::pad(out, std::string_view(p->getName()).substr(0, 21), 22);   // prevent overflow
+        TextFormat::fixed(out, unit, 2, 12, Align::Right);
+        TextFormat::fixed(out, line, 2, 12, Align::Right);
+        out += "\n";
     }
 
-    cout << "------------------------------------------------------------\n";
+    out += rule;
 
     // totalAmount is assumed to be final total AFTER discount (from finalize)
     double total = totalAmount;
@@ -223,14 +336,15 @@ void Order::printInvoice() const {
         discountAmount = 0.0;
     }
 
-    cout << left << setw(28) << "Subtotal:"
-         << right << setw(24) << subtotal << "\n";
-
-    cout << left << setw(28) << "Discount:"
-         << right << setw(24) << discountAmount << "\n";
-
-    cout << left << setw(28) << "TOTAL PAYABLE:"
-         << right << setw(24) << total << "\n";
-
-    cout << "============================================================\n\n";
-}
\ No newline at end of file
+    TextFormat::pad(out, "Subtotal:", 28);
+    TextFormat::fixed(out, subtotal, 2, 24, Align::Right);
+    out += "\n";
+    TextFormat::pad(out, "Discount:", 28);
+    TextFormat::fixed(out, discountAmount, 2, 24, Align::Right);
+    out += "\n";
+    TextFormat::pad(out, "TOTAL PAYABLE:", 28);
+    TextFormat::fixed(out, total, 2, 24, Align::Right);
+    out += "\n";
+
+    out += "============================================================\n\n";
+}
@@ -0,0 +1,362 @@
+#include "OrderArchive.h"
+#include "DateUtil.h"
+#include "Exceptions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+const char kMagic[8] = {'B', 'M', 'S', 'A', 'R', 'C', '1', '\n'};
+
+// ---------------- Varint encoding ----------------
+
+void putVarint(std::string& buf, uint64_t v) {
+    while (v >= 0x80) {
+        buf += static_cast<char>((v & 0x7F) | 0x80);
+        v >>= 7;
+    }
+    buf += static_cast<char>(v);
+}
+
+void putSigned(std::string& buf, int64_t v) {
+    putVarint(buf, (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+}
+
+void putString(std::string& buf, const std::string& s) {
+    putVarint(buf, s.size());
+    buf += s;
+}
+
+// Reads from a byte range; any overrun marks the reader bad instead of throwing
+struct Reader {
+    const std::string& buf;
+    size_t pos = 0;
+    bool ok = true;
+
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= buf.size()) break;
+            const auto byte = static_cast<unsigned char>(buf[pos++]);
+            v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+
+    int64_t signedVarint() {
+        const uint64_t v = varint();
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+    }
+
+    std::string string() {
+        const uint64_t n = varint();
+        if (!ok || n > buf.size() - pos) {
+            ok = false;
+            return {};
+        }
+        std::string s = buf.substr(pos, n);
+        pos += n;
+        return s;
+    }
+};
+
+long long toCents(double amount) {
+    return std::llround(amount * 100.0);
+}
+
+std::string segmentName(size_t n) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "segment-%04zu.arc", n);
+    return name;
+}
+
+fs::path archiveDir(const std::string& dataDir) {
+    return fs::path(dataDir) / "archive";
+}
+
+// Reads the magic and the summary block; `rest` receives the order block
+// when requested.
+std::string readBlocks(const std::string& path, std::string* rest) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) throw FileOperationException("Failed to open archive segment: " + path);
+
+    char magic[sizeof(kMagic)];
+    uint32_t summaryBytes = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+        !in.read(reinterpret_cast<char*>(&summaryBytes), sizeof(summaryBytes))) {
+        throw FileOperationException("Not an archive segment: " + path);
+    }
+    std::string summary(summaryBytes, '\0');
+    if (!in.read(&summary[0], summaryBytes)) throw FileOperationException("Truncated archive segment: " + path);
+
+    if (rest) {
+        rest->assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    return summary;
+}
+} // namespace
+
+// ---------------- Loading ----------------
+
+void OrderArchive::clear() {
+    m_segments.clear();
+    m_orderIds.clear();
+    m_revenueCents = 0;
+    m_lastDay = INT_MIN;
+    m_units.clear();
+    m_customers.clear();
+    m_months.clear();
+}
+
+void OrderArchive::load(const std::string& dataDir) {
+    clear();
+
+    const fs::path dir = archiveDir(dataDir);
+    std::error_code ec;
+    if (!fs::is_directory(dir, ec)) return;
+
+    std::vector<std::string> paths;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind("segment-", 0) == 0 && entry.path().extension() == ".arc") {
+            paths.push_back(entry.path().string());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    for (const auto& path : paths) readSegment(path);
+    std::sort(m_orderIds.begin(), m_orderIds.end());
+}
+
+void OrderArchive::readSegment(const std::string& path) {
+    const std::string summary = readBlocks(path, nullptr);
+    Reader r{summary};
+
+    const uint64_t orders = r.varint();
+    const int lastDay = static_cast<int>(r.signedVarint());
+    const long long revenue = r.signedVarint();
+
+    Segment segment{path, INT_MAX, INT_MIN};
+    int64_t id = 0;
+    for (uint64_t i = 0; r.ok && i < orders; ++i) {
+        id = i == 0 ? r.signedVarint() : id + static_cast<int64_t>(r.varint());
+        m_orderIds.push_back(static_cast<int>(id));
+        segment.firstId = std::min(segment.firstId, static_cast<int>(id));
+        segment.lastId = std::max(segment.lastId, static_cast<int>(id));
+    }
+
+    const uint64_t products = r.varint();
+    for (uint64_t i = 0; r.ok && i < products; ++i) {
+        const int productId = static_cast<int>(r.signedVarint());
+        m_units[productId] += static_cast<long long>(r.varint());
+    }
+
+    const uint64_t customers = r.varint();
+    for (uint64_t i = 0; r.ok && i < customers; ++i) {
+        const int customerId = static_cast<int>(r.signedVarint());
+        ArchivedCustomerTotals& t = m_customers[customerId];
+        t.orders += static_cast<int>(r.varint());
+        t.spent += static_cast<double>(r.signedVarint()) / 100.0;
+        t.lastDay = std::max(t.lastDay, static_cast<int>(r.signedVarint()));
+    }
+
+    const uint64_t months = r.varint();
+    for (uint64_t i = 0; r.ok && i < months; ++i) {
+        std::string month = r.string();
+        m_months[month] += static_cast<double>(r.signedVarint()) / 100.0;
+    }
+
+    if (!r.ok || r.pos != summary.size()) throw FileOperationException("Corrupt archive segment: " + path);
+
+    m_revenueCents += revenue;
+    m_lastDay = std::max(m_lastDay, lastDay);
+    m_segments.push_back(std::move(segment));
+}
+
+// ---------------- Writing ----------------
+
+void OrderArchive::append(const std::string& dataDir, const std::vector<const Order*>& orders) {
+    if (orders.empty()) return;
+
+    std::vector<const Order*> sorted(orders);
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Order* a, const Order* b) { return a->getOrderId() < b->getOrderId(); });
+
+    // Summaries, in cents
+    long long revenue = 0;
+    int lastDay = INT_MIN;
+    std::map<int, long long> units;
+    struct CustomerCents { int orders = 0; long long spent = 0; int lastDay = INT_MIN; };
+    std::map<int, CustomerCents> customers;
+    std::map<std::string, long long> months;
+
+    std::string body;
+    int64_t prevId = 0, prevDay = 0;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        const Order& o = *sorted[i];
+        int day;
+        if (!o.getIsFinalized() || !DateUtil::toDayNumber(o.getDate(), day)) {
+            throw InvalidInputException("Only finalized, dated orders can be archived: #" +
+                                        std::to_string(o.getOrderId()));
+        }
+        const int customerId = o.getCustomer() ? o.getCustomer()->getId() : -1;
+        const long long cents = toCents(o.getTotalAmount());
+
+        if (i == 0) putSigned(body, o.getOrderId());
+        else putVarint(body, static_cast<uint64_t>(o.getOrderId() - prevId));
+        putSigned(body, customerId);
+        putSigned(body, day - prevDay);
+        putSigned(body, cents);
+        putVarint(body, o.getItems().size());
+        for (const auto& [p, qty] : o.getItems()) {
+            const int productId = p ? p->getId() : -1;
+            putSigned(body, productId);
+            putSigned(body, qty);
+            if (p) units[productId] += qty;
+        }
+        prevId = o.getOrderId();
+        prevDay = day;
+
+        revenue += cents;
+        lastDay = std::max(lastDay, day);
+        if (customerId >= 0) {
+            CustomerCents& c = customers[customerId];
+            c.orders++;
+            c.spent += cents;
+            c.lastDay = std::max(c.lastDay, day);
+        }
+        months[DateUtil::fromDayNumber(day).substr(0, 7)] += cents;
+    }
+
+    std::string summary;
+    putVarint(summary, sorted.size());
+    putSigned(summary, lastDay);
+    putSigned(summary, revenue);
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        if (i == 0) putSigned(summary, sorted[i]->getOrderId());
+        else putVarint(summary, static_cast<uint64_t>(sorted[i]->getOrderId() - sorted[i - 1]->getOrderId()));
+    }
+    putVarint(summary, units.size());
+    for (const auto& [productId, count] : units) {
+        putSigned(summary, productId);
+        putVarint(summary, static_cast<uint64_t>(count));
+    }
+    putVarint(summary, customers.size());
+    for (const auto& [customerId, c] : customers) {
+        putSigned(summary, customerId);
+        putVarint(summary, static_cast<uint64_t>(c.orders));
+        putSigned(summary, c.spent);
+        putSigned(summary, c.lastDay);
+    }
+    putVarint(summary, months.size());
+    for (const auto& [month, cents] : months) {
+        putString(summary, month);
+        putSigned(summary, cents);
+    }
+
+    // Write under a temporary name so a crash never leaves half a segment
+    const fs::path dir = archiveDir(dataDir);
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec) throw FileOperationException("Failed to create archive directory: " + dir.string());
+
+    size_t n = m_segments.size() + 1;
+    while (fs::exists(dir / segmentName(n))) n++;
+    const std::string path = (dir / segmentName(n)).string();
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) throw FileOperationException("Failed to write archive segment: " + tmp);
+        const uint32_t summaryBytes = static_cast<uint32_t>(summary.size());
+        out.write(kMagic, sizeof(kMagic));
+        out.write(reinterpret_cast<const char*>(&summaryBytes), sizeof(summaryBytes));
+        out.write(summary.data(), static_cast<std::streamsize>(summary.size()));
+        out.write(body.data(), static_cast<std::streamsize>(body.size()));
+        if (!out.flush()) throw FileOperationException("Failed to write archive segment: " + tmp);
+    }
+    fs::rename(tmp, path, ec);
+    if (ec) throw FileOperationException("Failed to publish archive segment: " + path);
+
+    // Same bookkeeping as loading it back
+    readSegment(path);
+    std::sort(m_orderIds.begin(), m_orderIds.end());
+}
+
+// ---------------- Reading orders ----------------
+
+std::vector<ArchivedOrder> OrderArchive::decodeOrders(const std::string& path) {
+    std::string body;
+    const std::string summary = readBlocks(path, &body);
+    Reader s{summary};
+    const uint64_t count = s.varint();
+
+    Reader r{body};
+    std::vector<ArchivedOrder> orders;
+    orders.reserve(static_cast<size_t>(std::min<uint64_t>(count, body.size())));
+    int64_t id = 0, day = 0;
+    for (uint64_t i = 0; r.ok && i < count; ++i) {
+        ArchivedOrder o;
+        id = i == 0 ? r.signedVarint() : id + static_cast<int64_t>(r.varint());
+        o.orderId = static_cast<int>(id);
+        o.customerId = static_cast<int>(r.signedVarint());
+        day += r.signedVarint();
+        o.date = DateUtil::fromDayNumber(static_cast<int>(day));
+        o.total = static_cast<double>(r.signedVarint()) / 100.0;
+        const uint64_t items = r.varint();
+        for (uint64_t k = 0; r.ok && k < items; ++k) {
+            const int productId = static_cast<int>(r.signedVarint());
+            const int qty = static_cast<int>(r.signedVarint());
+            o.items.emplace_back(productId, qty);
+        }
+        orders.push_back(std::move(o));
+    }
+    if (!s.ok || !r.ok || r.pos != body.size()) throw FileOperationException("Corrupt archive segment: " + path);
+    return orders;
+}
+
+std::vector<ArchivedOrder> OrderArchive::readOrders() const {
+    std::vector<ArchivedOrder> all;
+    for (const auto& segment : m_segments) {
+        std::vector<ArchivedOrder> orders = decodeOrders(segment.path);
+        all.insert(all.end(), std::make_move_iterator(orders.begin()), std::make_move_iterator(orders.end()));
+    }
+    return all;
+}
+
+bool OrderArchive::findOrder(int orderId, ArchivedOrder& out) const {
+    if (!contains(orderId)) return false;
+    for (const auto& segment : m_segments) {
+        if (orderId < segment.firstId || orderId > segment.lastId) continue;
+        for (auto& o : decodeOrders(segment.path)) {
+            if (o.orderId == orderId) {
+                out = std::move(o);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// ---------------- Accessors ----------------
+
+bool OrderArchive::contains(int orderId) const {
+    return std::binary_search(m_orderIds.begin(), m_orderIds.end(), orderId);
+}
+
+size_t OrderArchive::orderCount() const { return m_orderIds.size(); }
+size_t OrderArchive::segmentCount() const { return m_segments.size(); }
+double OrderArchive::revenue() const { return static_cast<double>(m_revenueCents) / 100.0; }
+int OrderArchive::lastDay() const { return m_lastDay; }
+
+const std::unordered_map<int, long long>& OrderArchive::unitsByProduct() const { return m_units; }
+const std::unordered_map<int, ArchivedCustomerTotals>& OrderArchive::customerTotals() const { return m_customers; }
+const std::map<std::string, double>& OrderArchive::revenueByMonth() const { return m_months; }
@@ -3,6 +3,7 @@
 
 #include <sstream>
 #include <stdexcept>
+#include <utility>
 
 Product::Product() : id(0), name(""), price(0.0), cost(0.0), quantity(0) {}
 
@@ -15,6 +16,36 @@ Product::Product(int id, const std::string &name, double price, double cost, int
     setQuantity(quantity);
 }
 
+Product::Product(const Product& other)
+    : id(other.id), name(other.name), price(other.price), cost(other.cost),
+      quantity(other.quantity.load()) {}
+
+Product::Product(Product&& other) noexcept
+    : id(other.id), name(std::move(other.name)), price(other.price), cost(other.cost),
+      quantity(other.quantity.load()) {}
+
+Product& Product::operator=(const Product& other) {
+    if (this != &other) {
+        id = other.id;
+        name = other.name;
+        price = other.price;
+        cost = other.cost;
+        quantity.store(other.quantity.load());
+    }
+    return *this;
+}
+
+Product& Product::operator=(Product&& other) noexcept {
+    if (this != &other) {
+        id = other.id;
+        name = std::move(other.name);
+        price = other.price;
+        cost = other.cost;
+        quantity.store(other.quantity.load());
+    }
+    return *this;
+}
+
 int Product::getId() const {
     return id;
 }
@@ -75,20 +106,34 @@ void Product::setQuantity(int newQuantity) {
 }
 
 void Product::updateStock(int qty) {
-    if (quantity + qty < 0) {
-        throw InsufficientStockException("Stock update would make quantity negative.");
-    }
-    quantity += qty;
+    int current = quantity.load();
+    do {
+        if (current + qty < 0) {
+            throw InsufficientStockException("Stock update would make quantity negative.");
+        }
+    } while (!quantity.compare_exchange_weak(current, current + qty));
+}
+
+bool Product::tryReserve(int qty) {
+    int current = quantity.load();
+    do {
+        if (current < qty) return false;
+    } while (!quantity.compare_exchange_weak(current, current - qty));
+    return true;
+}
+
+void Product::releaseReserved(int qty) {
+    quantity.fetch_add(qty);
 }
 
 double Product::calculateProfit() const {
-    return (price - cost) * static_cast<double>(quantity);
+    return (price - cost) * static_cast<double>(quantity.load());
 }
 
 std::string Product::toString() const {
     std::ostringstream out;
     out << "Product{id=" << id << ", name=\"" << name << "\", price=" << price
-        << ", cost=" << cost << ", quantity=" << quantity << "}";
+        << ", cost=" << cost << ", quantity=" << quantity.load() << "}";
     return out.str();
 }
 
@@ -108,6 +153,6 @@ bool Product::operator==(const Product& other) const {
 // Output operator
 std::ostream& operator<<(std::ostream& os, const Product& product) {
     os << "Product{id=" << product.id << ", name=\"" << product.name << "\", price=" << product.price
-       << ", cost=" << product.cost << ", quantity=" << product.quantity << "}";
+       << ", cost=" << product.cost << ", quantity=" << product.quantity.load() << "}";
     return os;
 }
@@ -0,0 +1,375 @@
+#include "Query.h"
+#include "DateUtil.h"
+#include "Exceptions.h"
+#include "MemoryStats.h"
+#include "PremiumCustomer.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace {
+// Parses an optional bound; blank means open-ended.
+int parseBound(const std::string& date, int openValue) {
+    if (date.empty()) return openValue;
+    int day;
+    if (!DateUtil::toDayNumber(date, day)) {
+        throw InvalidInputException("Invalid date in query: " + date);
+    }
+    return day;
+}
+
+// Sorts candidate rows and applies offset/limit, only fully sorting
+// the prefix that is actually returned.
+template<typename Less>
+void sortAndPage(QueryResult& result, size_t offset, size_t limit, Less less) {
+    auto& rows = result.rows;
+    result.matched = rows.size();
+
+    if (offset >= rows.size()) {
+        rows.clear();
+        return;
+    }
+
+    size_t end = rows.size();
+    if (limit > 0 && offset + limit < end) end = offset + limit;
+
+    if (end < rows.size()) {
+        std::partial_sort(rows.begin(), rows.begin() + end, rows.end(), less);
+        rows.resize(end);
+    } else {
+        std::sort(rows.begin(), rows.end(), less);
+    }
+    rows.erase(rows.begin(), rows.begin() + offset);
+}
+} // namespace
+
+// ---------------- OrderIndex ----------------
+
+void OrderIndex::rebuild(const std::vector<Order>& orders) {
+    m_id.clear();
+    m_customer.clear();
+    m_day.clear();
+    m_total.clear();
+    m_finalized.clear();
+    m_itemStart.clear();
+    m_itemCount.clear();
+    m_itemProducts.clear();
+    m_deadItems = 0;
+    m_byId.clear();
+    m_byDay.clear();
+
+    m_id.reserve(orders.size());
+    m_customer.reserve(orders.size());
+    m_day.reserve(orders.size());
+    m_total.reserve(orders.size());
+    m_finalized.reserve(orders.size());
+    m_itemStart.reserve(orders.size());
+    m_itemCount.reserve(orders.size());
+    m_byId.reserve(orders.size());
+
+    for (const auto& o : orders) appendRow(o);
+
+    // Bulk build of the date index is one sort instead of n inserts
+    m_byDay.resize(m_id.size());
+    for (size_t r = 0; r < m_byDay.size(); ++r) m_byDay[r] = r;
+    std::stable_sort(m_byDay.begin(), m_byDay.end(),
+                     [this](size_t a, size_t b) { return m_day[a] < m_day[b]; });
+}
+
+void OrderIndex::sync(const std::vector<Order>& orders) {
+    if (orders.size() < m_id.size()) {
+        rebuild(orders);
+        return;
+    }
+    for (size_t r = m_id.size(); r < orders.size(); ++r) {
+        appendRow(orders[r]);
+        indexDay(r);
+    }
+}
+
+void OrderIndex::refreshRow(const std::vector<Order>& orders, size_t row) {
+    if (row >= m_id.size()) {
+        sync(orders);
+        return;
+    }
+
+    const Order& o = orders[row];
+    m_customer[row] = o.getCustomer() ? o.getCustomer()->getId() : -1;
+    m_total[row] = o.getTotalAmount();
+    m_finalized[row] = o.getIsFinalized() ? 1 : 0;
+    writeItems(o, row);
+}
+
+void OrderIndex::appendRow(const Order& o) {
+    const size_t row = m_id.size();
+
+    int day;
+    if (!DateUtil::toDayNumber(o.getDate(), day)) day = INT_MIN;
+
+    m_id.push_back(o.getOrderId());
+    m_customer.push_back(o.getCustomer() ? o.getCustomer()->getId() : -1);
+    m_day.push_back(day);
+    m_total.push_back(o.getTotalAmount());
+    m_finalized.push_back(o.getIsFinalized() ? 1 : 0);
+    m_itemStart.push_back(0);
+    m_itemCount.push_back(0);
+    writeItems(o, row);
+
+    m_byId.emplace(o.getOrderId(), row);  // first occurrence wins, like a linear search
+}
+
+void OrderIndex::writeItems(const Order& o, size_t row) {
+    const auto& items = o.getItems();
+
+    // Same size: overwrite the slice in place
+    if (items.size() == m_itemCount[row] && !items.empty()) {
+        for (size_t i = 0; i < items.size(); ++i) {
+            m_itemProducts[m_itemStart[row] + i] = items[i].first ? items[i].first->getId() : -1;
+        }
+        return;
+    }
+
+    // Otherwise move the row's slice to the tail and leave the old one dead
+    m_deadItems += m_itemCount[row];
+    m_itemStart[row] = static_cast<uint32_t>(m_itemProducts.size());
+    m_itemCount[row] = static_cast<uint32_t>(items.size());
+    for (const auto& it : items) {
+        m_itemProducts.push_back(it.first ? it.first->getId() : -1);
+    }
+
+    if (m_deadItems > 1024 && m_deadItems * 2 > m_itemProducts.size()) compactItems();
+}
+
+void OrderIndex::compactItems() {
+    std::vector<int> packed;
+    packed.reserve(m_itemProducts.size() - m_deadItems);
+    for (size_t r = 0; r < m_id.size(); ++r) {
+        const uint32_t start = static_cast<uint32_t>(packed.size());
+        packed.insert(packed.end(),
+                      m_itemProducts.begin() + m_itemStart[r],
+                      m_itemProducts.begin() + m_itemStart[r] + m_itemCount[r]);
+        m_itemStart[r] = start;
+    }
+    m_itemProducts.swap(packed);
+    m_deadItems = 0;
+}
+
+void OrderIndex::indexDay(size_t row) {
+    // New orders are usually the latest, so this is normally a push_back
+    auto pos = std::upper_bound(m_byDay.begin(), m_byDay.end(), row,
+                                [this](size_t a, size_t b) {
+                                    if (m_day[a] != m_day[b]) return m_day[a] < m_day[b];
+                                    return a < b;
+                                });
+    m_byDay.insert(pos, row);
+}
+
+long OrderIndex::findRow(int orderId) const {
+    auto it = m_byId.find(orderId);
+    return it == m_byId.end() ? -1 : static_cast<long>(it->second);
+}
+
+size_t OrderIndex::size() const {
+    return m_id.size();
+}
+
+size_t OrderIndex::memoryBytes() const {
+    return memsize::heap(m_id) + memsize::heap(m_customer) + memsize::heap(m_day) +
+           memsize::heap(m_total) + memsize::heap(m_finalized) + memsize::heap(m_itemStart) +
+           memsize::heap(m_itemCount) + memsize::heap(m_itemProducts) +
+           memsize::heap(m_byId) + memsize::heap(m_byDay);
+}
+
+QueryResult OrderIndex::run(const OrderQuery& q, const std::vector<Customer*>& customers) const {
+    QueryResult result;
+
+    const bool hasDateRange = !q.fromDate.empty() || !q.toDate.empty();
+    const int fromDay = parseBound(q.fromDate, INT_MIN + 1);
+    const int toDay = parseBound(q.toDate, INT_MAX);
+
+    std::unordered_set<int> premiumIds;
+    if (q.tier != CustomerTier::Any) {
+        for (auto* c : customers) {
+            if (c && dynamic_cast<PremiumCustomer*>(c)) premiumIds.insert(c->getId());
+        }
+    }
+
+    auto matches = [&](size_t r) {
+        if (q.orderId != -1 && m_id[r] != q.orderId) return false;
+        if (hasDateRange && (m_day[r] < fromDay || m_day[r] > toDay)) return false;
+        if (q.customerId != -1 && m_customer[r] != q.customerId) return false;
+        if (q.finalized != -1 && m_finalized[r] != q.finalized) return false;
+        if (q.minTotal >= 0.0 && m_total[r] < q.minTotal) return false;
+        if (q.maxTotal >= 0.0 && m_total[r] > q.maxTotal) return false;
+        if (q.tier != CustomerTier::Any) {
+            if (m_customer[r] == -1) return false;
+            const bool premium = premiumIds.count(m_customer[r]) > 0;
+            if (premium != (q.tier == CustomerTier::Premium)) return false;
+        }
+        if (q.productId != -1) {
+            const int* begin = m_itemProducts.data() + m_itemStart[r];
+            const int* end = begin + m_itemCount[r];
+            if (std::find(begin, end, q.productId) == end) return false;
+        }
+        return true;
+    };
+
+    // ---- Plan: pick the access path with the fewest candidate rows ----
+    if (q.orderId != -1) {
+        result.accessPath = "id-index";
+        long r = findRow(q.orderId);
+        if (r >= 0 && matches(static_cast<size_t>(r))) result.rows.push_back(static_cast<size_t>(r));
+    } else {
+        size_t lo = 0, hi = m_byDay.size();
+        if (hasDateRange) {
+            lo = static_cast<size_t>(std::lower_bound(m_byDay.begin(), m_byDay.end(), fromDay,
+                    [this](size_t r, int day) { return m_day[r] < day; }) - m_byDay.begin());
+            hi = static_cast<size_t>(std::upper_bound(m_byDay.begin(), m_byDay.end(), toDay,
+                    [this](int day, size_t r) { return day < m_day[r]; }) - m_byDay.begin());
+            if (hi < lo) hi = lo;
+        }
+
+        // Index probes are random access; only worth it when clearly selective
+        if (hasDateRange && (hi - lo) * 2 < m_id.size()) {
+            result.accessPath = "date-index";
+            for (size_t i = lo; i < hi; ++i) {
+                if (matches(m_byDay[i])) result.rows.push_back(m_byDay[i]);
+            }
+        } else {
+            result.accessPath = "full-scan";
+            for (size_t r = 0; r < m_id.size(); ++r) {
+                if (matches(r)) result.rows.push_back(r);
+            }
+        }
+    }
+
+    // ---- Order and page ----
+    const bool desc = q.descending;
+    auto less = [&](size_t a, size_t b) {
+        switch (q.sortBy) {
+            case OrderSortKey::Date:
+                if (m_day[a] != m_day[b]) return desc ? m_day[a] > m_day[b] : m_day[a] < m_day[b];
+                break;
+            case OrderSortKey::Total:
+                if (m_total[a] != m_total[b]) return desc ? m_total[a] > m_total[b] : m_total[a] < m_total[b];
+                break;
+            case OrderSortKey::Customer:
+                if (m_customer[a] != m_customer[b]) return desc ? m_customer[a] > m_customer[b] : m_customer[a] < m_customer[b];
+                break;
+            case OrderSortKey::Id:
+                if (m_id[a] != m_id[b]) return desc ? m_id[a] > m_id[b] : m_id[a] < m_id[b];
+                break;
+        }
+        return a < b;
+    };
+
+    sortAndPage(result, q.offset, q.limit, less);
+    return result;
+}
+
+// ---------------- LedgerIndex ----------------
+
+void LedgerIndex::clear() {
+    m_day.clear();
+    m_amount.clear();
+    m_revenue.clear();
+    m_byDay.clear();
+}
+
+size_t LedgerIndex::memoryBytes() const {
+    return memsize::heap(m_day) + memsize::heap(m_amount) + memsize::heap(m_revenue) + memsize::heap(m_byDay);
+}
+
+void LedgerIndex::sync(const Finance& finance) {
+    const auto& tx = finance.getTransactions();
+    if (tx.size() < m_day.size()) clear();
+
+    const size_t first = m_day.size();
+    const bool bulk = tx.size() - first > 64;
+
+    for (size_t r = first; r < tx.size(); ++r) {
+        int day;
+        if (!DateUtil::toDayNumber(tx[r].date, day)) day = INT_MIN;
+
+        m_day.push_back(day);
+        m_amount.push_back(tx[r].amount);
+        m_revenue.push_back(tx[r].type == "Revenue" ? 1 : 0);
+
+        if (bulk) {
+            m_byDay.push_back(r);
+            continue;
+        }
+        auto pos = std::upper_bound(m_byDay.begin(), m_byDay.end(), r,
+                                    [this](size_t a, size_t b) {
+                                        if (m_day[a] != m_day[b]) return m_day[a] < m_day[b];
+                                        return a < b;
+                                    });
+        m_byDay.insert(pos, r);
+    }
+
+    // Large tails (e.g. first sync after a load) are cheaper to re-sort
+    if (bulk) {
+        std::stable_sort(m_byDay.begin(), m_byDay.end(),
+                         [this](size_t a, size_t b) { return m_day[a] < m_day[b]; });
+    }
+}
+
+QueryResult LedgerIndex::run(const LedgerQuery& q) const {
+    QueryResult result;
+
+    const bool hasDateRange = !q.fromDate.empty() || !q.toDate.empty();
+    const int fromDay = parseBound(q.fromDate, INT_MIN + 1);
+    const int toDay = parseBound(q.toDate, INT_MAX);
+
+    int wantRevenue = -1;
+    if (q.type == "Revenue") wantRevenue = 1;
+    else if (q.type == "Expense") wantRevenue = 0;
+    else if (!q.type.empty()) throw InvalidInputException("Unknown transaction type: " + q.type);
+
+    auto matches = [&](size_t r) {
+        if (hasDateRange && (m_day[r] < fromDay || m_day[r] > toDay)) return false;
+        if (wantRevenue != -1 && m_revenue[r] != wantRevenue) return false;
+        if (q.minAmount >= 0.0 && m_amount[r] < q.minAmount) return false;
+        if (q.maxAmount >= 0.0 && m_amount[r] > q.maxAmount) return false;
+        return true;
+    };
+
+    size_t lo = 0, hi = m_byDay.size();
+    if (hasDateRange) {
+        lo = static_cast<size_t>(std::lower_bound(m_byDay.begin(), m_byDay.end(), fromDay,
+                [this](size_t r, int day) { return m_day[r] < day; }) - m_byDay.begin());
+        hi = static_cast<size_t>(std::upper_bound(m_byDay.begin(), m_byDay.end(), toDay,
+                [this](int day, size_t r) { return day < m_day[r]; }) - m_byDay.begin());
+        if (hi < lo) hi = lo;
+    }
+
+    if (hasDateRange && (hi - lo) * 2 < m_day.size()) {
+        result.accessPath = "date-index";
+        for (size_t i = lo; i < hi; ++i) {
+            if (matches(m_byDay[i])) result.rows.push_back(m_byDay[i]);
+        }
+    } else {
+        result.accessPath = "full-scan";
+        for (size_t r = 0; r < m_day.size(); ++r) {
+            if (matches(r)) result.rows.push_back(r);
+        }
+    }
+
+    const bool desc = q.descending;
+    auto less = [&](size_t a, size_t b) {
+        switch (q.sortBy) {
+            case LedgerSortKey::Date:
+                if (m_day[a] != m_day[b]) return desc ? m_day[a] > m_day[b] : m_day[a] < m_day[b];
+                break;
+            case LedgerSortKey::Amount:
+                if (m_amount[a] != m_amount[b]) return desc ? m_amount[a] > m_amount[b] : m_amount[a] < m_amount[b];
+                break;
+            case LedgerSortKey::Position:
+                return desc ? a > b : a < b;
+        }
+        return a < b;
+    };
+
+    sortAndPage(result, q.offset, q.limit, less);
+    return result;
+}
@@ -0,0 +1,55 @@
+#include "Replenishment.h"
+#include "DateUtil.h"
+#include "Exceptions.h"
+
+#include <cmath>
+
+PurchaseProposal ReplenishmentPlanner::plan(DataManager& dm, const ReplenishmentPolicy& policy, int asOfDay) {
+    if (policy.leadTimeDays < 0 || policy.safetyDays < 0 || policy.reviewDays < 0 || policy.velocityWindow <= 0) {
+        throw InvalidInputException("Replenishment policy values must be non-negative (window positive).");
+    }
+
+    const SalesVelocity& velocity = dm.salesVelocity();
+    StockIndex& index = dm.stockIndex();
+
+    // 1) Per-product reorder points from recent demand
+    for (const auto& p : dm.products()) {
+        const double v = velocity.dailyVelocity(p.getId(), asOfDay, policy.velocityWindow);
+        // No recent demand: only an empty shelf reaches the reorder point
+        const int rop = v > 0.0
+            ? static_cast<int>(std::ceil(v * (policy.leadTimeDays + policy.safetyDays)))
+            : 0;
+        index.setReorderPoint(p.getId(), rop);
+    }
+
+    // 2) Walk only the products at or below their reorder point
+    PurchaseProposal proposal;
+    proposal.date = DateUtil::fromDayNumber(asOfDay);
+
+    const int cover = policy.leadTimeDays + policy.safetyDays + policy.reviewDays;
+    for (int pid : index.atReorderPoint()) {
+        const Product* p = dm.findProduct(pid);
+        if (!p) continue;
+
+        const double v = velocity.dailyVelocity(pid, asOfDay, policy.velocityWindow);
+        if (v <= 0.0) continue;
+
+        const int upTo = static_cast<int>(std::ceil(v * cover));
+        const int qty = upTo - p->getQuantity();
+        if (qty <= 0) continue;
+
+        const double cost = p->getCost() * qty;
+        proposal.lines.push_back({pid, p->getQuantity(), v, index.reorderPoint(pid), qty, cost});
+        proposal.totalCost += cost;
+    }
+
+    return proposal;
+}
+
+double ReplenishmentPlanner::apply(DataManager& dm, const PurchaseProposal& proposal) {
+    std::vector<std::pair<int, int>> lines;
+    lines.reserve(proposal.lines.size());
+    for (const auto& l : proposal.lines) lines.push_back({l.productId, l.orderQty});
+
+    return dm.restockBatch(lines, proposal.date);
+}
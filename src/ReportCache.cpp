@@ -0,0 +1,51 @@
+#include "ReportCache.h"
+
+#include <utility>
+
+ReportCache::ReportCache(size_t maxEntries) : maxEntries(maxEntries) {}
+
+bool ReportCache::isFresh(const Entry& e, const DataEpochs& now) {
+    if ((e.deps & DependsOnProducts) && e.epochs.products != now.products) return false;
+    if ((e.deps & DependsOnCustomers) && e.epochs.customers != now.customers) return false;
+    if ((e.deps & DependsOnOrders) && e.epochs.orders != now.orders) return false;
+    if ((e.deps & DependsOnLedger) && e.epochs.ledger != now.ledger) return false;
+    return true;
+}
+
+const std::string* ReportCache::lookup(const std::string& key, const DataEpochs& now) {
+    auto it = entries.find(key);
+    if (it == entries.end() || !isFresh(it->second, now)) {
+        missCount++;
+        return nullptr;
+    }
+    hitCount++;
+    return &it->second.text;
+}
+
+void ReportCache::store(const std::string& key, unsigned deps, const DataEpochs& now, std::string text) {
+    if (entries.size() >= maxEntries && entries.find(key) == entries.end()) {
+        // Drop stale entries first; if everything is fresh, drop an arbitrary one
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (!isFresh(it->second, now)) it = entries.erase(it);
+            else ++it;
+        }
+        if (entries.size() >= maxEntries) entries.erase(entries.begin());
+    }
+    entries[key] = Entry{deps, now, std::move(text)};
+}
+
+void ReportCache::clear() {
+    entries.clear();
+}
+
+uint64_t ReportCache::hits() const {
+    return hitCount;
+}
+
+uint64_t ReportCache::misses() const {
+    return missCount;
+}
+
+size_t ReportCache::size() const {
+    return entries.size();
+}
@@ -0,0 +1,144 @@
+#include "Reservations.h"
+
+#include <stdexcept>
+
+ReservationLedger::ReservationLedger(int ttlSeconds, size_t wheelSlots)
+    : m_ttl(1), m_wheel(wheelSlots == 0 ? 1 : wheelSlots), m_lastTick(-1),
+      m_nextGeneration(1), m_count(0) {
+    setTtl(ttlSeconds);
+}
+
+void ReservationLedger::setTtl(int seconds) {
+    if (seconds <= 0) {
+        throw std::invalid_argument("Reservation TTL must be positive.");
+    }
+    m_ttl = seconds;
+}
+
+int ReservationLedger::ttl() const {
+    return m_ttl;
+}
+
+void ReservationLedger::schedule(int orderId, int productId, const Hold& hold) {
+    const size_t slot = static_cast<size_t>(hold.expiresAt) % m_wheel.size();
+    m_wheel[slot].push_back(WheelEntry{orderId, productId, hold.generation});
+}
+
+void ReservationLedger::unreserve(int productId, int qty) {
+    auto it = m_reserved.find(productId);
+    if (it == m_reserved.end()) return;
+    it->second -= qty;
+    if (it->second <= 0) m_reserved.erase(it);
+}
+
+void ReservationLedger::reserve(int orderId, int productId, int qty, int64_t now) {
+    if (qty <= 0) {
+        throw std::invalid_argument("Reserved quantity must be positive.");
+    }
+    if (m_lastTick < 0) m_lastTick = now - 1;
+
+    Hold& hold = m_holds[orderId][productId];
+    if (hold.generation == 0) {
+        hold.qty = 0;
+        m_count++;
+    }
+    hold.qty += qty;
+    hold.expiresAt = now + m_ttl;
+    hold.generation = m_nextGeneration++;   // any older wheel entry is now stale
+    m_reserved[productId] += qty;
+
+    schedule(orderId, productId, hold);
+}
+
+int ReservationLedger::release(int orderId, int productId) {
+    auto order = m_holds.find(orderId);
+    if (order == m_holds.end()) return 0;
+    auto line = order->second.find(productId);
+    if (line == order->second.end()) return 0;
+
+    const int qty = line->second.qty;
+    unreserve(productId, qty);
+    order->second.erase(line);
+    if (order->second.empty()) m_holds.erase(order);
+    m_count--;
+    return qty;
+}
+
+int ReservationLedger::releaseOrder(int orderId) {
+    auto order = m_holds.find(orderId);
+    if (order == m_holds.end()) return 0;
+
+    int total = 0;
+    for (const auto& line : order->second) {
+        unreserve(line.first, line.second.qty);
+        total += line.second.qty;
+        m_count--;
+    }
+    m_holds.erase(order);
+    return total;
+}
+
+std::vector<ReservationLedger::Expired> ReservationLedger::advance(int64_t now) {
+    std::vector<Expired> expired;
+    if (m_lastTick < 0) {
+        m_lastTick = now;
+        return expired;
+    }
+    if (now <= m_lastTick) return expired;
+
+    // A jump longer than one revolution only needs each slot visited once
+    const int64_t slots = static_cast<int64_t>(m_wheel.size());
+    const int64_t first = (now - m_lastTick > slots) ? now - slots + 1 : m_lastTick + 1;
+
+    for (int64_t tick = first; tick <= now; ++tick) {
+        auto& bucket = m_wheel[static_cast<size_t>(tick % slots)];
+        size_t keep = 0;
+        for (size_t i = 0; i < bucket.size(); ++i) {
+            const WheelEntry e = bucket[i];
+
+            auto order = m_holds.find(e.orderId);
+            if (order == m_holds.end()) continue;
+            auto line = order->second.find(e.productId);
+            if (line == order->second.end() || line->second.generation != e.generation) continue;
+
+            if (line->second.expiresAt > now) {
+                bucket[keep++] = e;   // due on a later revolution
+                continue;
+            }
+
+            expired.push_back(Expired{e.orderId, e.productId, line->second.qty});
+            unreserve(e.productId, line->second.qty);
+            order->second.erase(line);
+            if (order->second.empty()) m_holds.erase(order);
+            m_count--;
+        }
+        bucket.resize(keep);
+    }
+
+    m_lastTick = now;
+    return expired;
+}
+
+int ReservationLedger::reserved(int productId) const {
+    auto it = m_reserved.find(productId);
+    return it == m_reserved.end() ? 0 : it->second;
+}
+
+int ReservationLedger::reservedFor(int orderId, int productId) const {
+    auto order = m_holds.find(orderId);
+    if (order == m_holds.end()) return 0;
+    auto line = order->second.find(productId);
+    return line == order->second.end() ? 0 : line->second.qty;
+}
+
+size_t ReservationLedger::size() const {
+    return m_count;
+}
+
+void ReservationLedger::clear() {
+    for (auto& bucket : m_wheel) bucket.clear();
+    m_holds.clear();
+    m_reserved.clear();
+    m_lastTick = -1;
+    m_count = 0;
+}
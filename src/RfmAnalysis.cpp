@@ -0,0 +1,169 @@
+#include "RfmAnalysis.h"
+#include "DateUtil.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <unordered_map>
+
+namespace {
+struct Totals {
+    int lastDay = INT_MIN;
+    int frequency = 0;
+    double monetary = 0.0;
+};
+
+// Quintile cutoffs by successive selection: each nth_element only has
+// to partition the part of the array right of the previous cutoff.
+void selectCutoffs(std::vector<double>& values, double out[4]) {
+    if (values.empty()) {
+        for (int i = 0; i < 4; ++i) out[i] = 0.0;
+        return;
+    }
+    auto from = values.begin();
+    for (int i = 0; i < 4; ++i) {
+        auto nth = values.begin() + static_cast<long>(values.size() * (i + 1) / 5);
+        if (nth == values.end()) --nth;
+        std::nth_element(from, nth, values.end());
+        out[i] = *nth;
+        from = nth;
+    }
+}
+
+// Higher value -> higher score
+int scoreAscending(double v, const double cut[4]) {
+    int score = 1;
+    for (int i = 0; i < 4; ++i) {
+        if (v > cut[i]) score++;
+    }
+    return score;
+}
+} // namespace
+
+const char* RfmAnalysis::segmentFor(int r, int f, int m) {
+    if (r == 0) return "No Purchases";
+    if (r >= 4 && f >= 4 && m >= 4) return "Champions";
+    if (r >= 3 && f >= 4) return "Loyal";
+    if (r >= 4 && f >= 2) return "Potential Loyalist";
+    if (r >= 4) return "New";
+    if (r <= 2 && f >= 3) return "At Risk";
+    if (r <= 2) return "Hibernating";
+    return "Needs Attention";
+}
+
+std::vector<RfmRow> RfmAnalysis::compute(const std::vector<Customer*>& customers,
+                                         const std::vector<Order>& orders,
+                                         int asOfDay,
+                                         RfmCutoffs* cutoffsOut,
+                                         const OrderArchive* archive) {
+    // customerId -> dense slot
+    std::unordered_map<int, size_t> slotOf;
+    slotOf.reserve(customers.size());
+    for (size_t i = 0; i < customers.size(); ++i) {
+        if (customers[i]) slotOf.emplace(customers[i]->getId(), i);
+    }
+
+    // 1) Parallel resolve: each order's customer slot and day, parsed once.
+    //    Orders that do not count get kNoSlot. Each worker also sorts the
+    //    orders it kept into one bucket per contiguous range of slots.
+    const uint32_t kNoSlot = UINT32_MAX;
+    std::vector<uint32_t> orderSlot(orders.size(), kNoSlot);
+    std::vector<int> orderDay(orders.size());
+
+    const unsigned workers = parallelWorkerCount(orders.size(), 16384);
+    const size_t slotsPerBucket = std::max<size_t>(1, (customers.size() + workers - 1) / workers);
+    // buckets[resolveWorker][bucket] = order positions, ascending
+    std::vector<std::vector<std::vector<size_t>>> buckets(workers, std::vector<std::vector<size_t>>(workers));
+
+    parallelFor(orders.size(), workers, [&](size_t begin, size_t end, unsigned w) {
+        for (size_t i = begin; i < end; ++i) {
+            const Order& o = orders[i];
+            if (!o.getIsFinalized() || !o.getCustomer()) continue;
+
+            auto slot = slotOf.find(o.getCustomer()->getId());
+            if (slot == slotOf.end()) continue;
+
+            int day;
+            if (!DateUtil::toDayNumber(o.getDate(), day) || day > asOfDay) continue;
+
+            orderSlot[i] = static_cast<uint32_t>(slot->second);
+            orderDay[i] = day;
+            buckets[w][slot->second / slotsPerBucket].push_back(i);
+        }
+    });
+
+    // 2) Parallel aggregation, one bucket per worker: each worker owns a
+    //    range of the one totals array and reads only the orders bucketed
+    //    for it, so the total work stays O(orders + customers). Resolve
+    //    ranges are taken in order, so every customer's orders are summed
+    //    in order position as before.
+    std::vector<Totals> merged(customers.size());
+    parallelFor(workers, workers, [&](size_t first, size_t last, unsigned) {
+        for (size_t b = first; b < last; ++b) {
+            for (const auto& perWorker : buckets) {
+                for (size_t i : perWorker[b]) {
+                    Totals& t = merged[orderSlot[i]];
+                    t.frequency++;
+                    t.monetary += orders[i].getTotalAmount();
+                    if (orderDay[i] > t.lastDay) t.lastDay = orderDay[i];
+                }
+            }
+        }
+    });
+
+    // Archived orders arrive pre-aggregated per customer
+    if (archive && archive->orderCount() > 0 && archive->lastDay() <= asOfDay) {
+        for (const auto& [customerId, t] : archive->customerTotals()) {
+            auto slot = slotOf.find(customerId);
+            if (slot == slotOf.end()) continue;
+            Totals& m = merged[slot->second];
+            m.frequency += t.orders;
+            m.monetary += t.spent;
+            if (t.lastDay > m.lastDay) m.lastDay = t.lastDay;
+        }
+    }
+
+    // 3) Quintile cutoffs, one dimension per thread
+    std::vector<double> dims[3];
+    for (const Totals& t : merged) {
+        if (t.frequency == 0) continue;
+        dims[0].push_back(static_cast<double>(asOfDay - t.lastDay));
+        dims[1].push_back(static_cast<double>(t.frequency));
+        dims[2].push_back(t.monetary);
+    }
+
+    RfmCutoffs cut{};
+    double* targets[3] = {cut.recency, cut.frequency, cut.monetary};
+    parallelFor(3, dims[0].size() >= 65536 ? 3u : 1u, [&](size_t begin, size_t end, unsigned) {
+        for (size_t d = begin; d < end; ++d) selectCutoffs(dims[d], targets[d]);
+    });
+    if (cutoffsOut) *cutoffsOut = cut;
+
+    // 4) Score
+    std::vector<RfmRow> rows(customers.size());
+    parallelFor(customers.size(), parallelWorkerCount(customers.size(), 65536),
+                [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+            const Totals& t = merged[i];
+            RfmRow& row = rows[i];
+            row.customerId = customers[i] ? customers[i]->getId() : -1;
+            row.frequency = t.frequency;
+            row.monetary = t.monetary;
+
+            if (t.frequency == 0) {
+                row.recencyDays = -1;
+                row.r = row.f = row.m = 0;
+            } else {
+                row.recencyDays = asOfDay - t.lastDay;
+                // Recent is better, so recency scores run the other way
+                row.r = 6 - scoreAscending(row.recencyDays, cut.recency);
+                row.f = scoreAscending(t.frequency, cut.frequency);
+                row.m = scoreAscending(t.monetary, cut.monetary);
+            }
+            row.segment = segmentFor(row.r, row.f, row.m);
+        }
+    });
+
+    return rows;
+}
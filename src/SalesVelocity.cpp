@@ -0,0 +1,174 @@
+#include "SalesVelocity.h"
+#include "DateUtil.h"
+
+#include <algorithm>
+#include <climits>
+
+void SalesVelocity::clear() {
+    m_series.clear();
+}
+
+void SalesVelocity::rebuild(const std::vector<Order>& orders) {
+    clear();
+
+    struct Sale { int productId; int day; int qty; };
+    std::vector<Sale> sales;
+
+    // 1) Flatten finalized order lines
+    for (const auto& o : orders) {
+        if (!o.getIsFinalized()) continue;
+
+        int day;
+        if (!DateUtil::toDayNumber(o.getDate(), day)) continue;
+
+        for (const auto& it : o.getItems()) {
+            if (it.first) sales.push_back({it.first->getId(), day, it.second});
+        }
+    }
+
+    // 2) Group by product and day, then build each series once
+    std::sort(sales.begin(), sales.end(), [](const Sale& a, const Sale& b) {
+        return a.productId != b.productId ? a.productId < b.productId : a.day < b.day;
+    });
+    std::vector<std::pair<int, long long>> points;
+    for (size_t i = 0; i < sales.size();) {
+        const int pid = sales[i].productId;
+        points.clear();
+        for (; i < sales.size() && sales[i].productId == pid; ++i) {
+            if (!points.empty() && points.back().first == sales[i].day) points.back().second += sales[i].qty;
+            else points.emplace_back(sales[i].day, sales[i].qty);
+        }
+        build(m_series[pid], points);
+    }
+}
+
+void SalesVelocity::build(Series& s, const std::vector<std::pair<int, long long>>& points) {
+    s = Series{};
+    if (points.empty()) return;
+
+    // The kMaxSeriesDays span holding the most points
+    size_t bestFirst = 0, bestCount = 0;
+    for (size_t lo = 0, hi = 0; hi < points.size(); ++hi) {
+        while (static_cast<long long>(points[hi].first) - points[lo].first + 1 > kMaxSeriesDays) lo++;
+        if (hi - lo + 1 > bestCount) {
+            bestCount = hi - lo + 1;
+            bestFirst = lo;
+        }
+    }
+
+    s.firstDay = s.minDay = points[bestFirst].first;
+    s.maxDay = points[bestFirst + bestCount - 1].first;
+    s.prefix.assign(static_cast<size_t>(s.maxDay - s.firstDay + 1), 0);
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (i >= bestFirst && i < bestFirst + bestCount) {
+            s.prefix[static_cast<size_t>(points[i].first - s.firstDay)] += points[i].second;
+        } else {
+            s.outliers.push_back(points[i]);
+        }
+    }
+    for (size_t i = 1; i < s.prefix.size(); ++i) s.prefix[i] += s.prefix[i - 1];
+    s.sales = bestCount;
+    // Rebuild again only once the outliers have doubled
+    s.outlierLimit = 2 * s.outliers.size();
+}
+
+void SalesVelocity::reanchor(Series& s) {
+    std::vector<std::pair<int, long long>> points = s.outliers;
+    for (size_t i = 0; i < s.prefix.size(); ++i) {
+        const long long units = s.prefix[i] - (i > 0 ? s.prefix[i - 1] : 0);
+        if (units != 0) points.emplace_back(s.firstDay + static_cast<int>(i), units);
+    }
+    std::sort(points.begin(), points.end());
+
+    // Merge points that fall on the same day
+    size_t kept = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (kept > 0 && points[kept - 1].first == points[i].first) points[kept - 1].second += points[i].second;
+        else points[kept++] = points[i];
+    }
+    points.resize(kept);
+    build(s, points);
+}
+
+void SalesVelocity::recordOrder(const Order& order) {
+    if (!order.getIsFinalized()) return;
+
+    int day;
+    if (!DateUtil::toDayNumber(order.getDate(), day)) return;
+
+    for (const auto& it : order.getItems()) {
+        if (it.first) recordSale(it.first->getId(), day, it.second);
+    }
+}
+
+void SalesVelocity::recordSale(int productId, int day, int qty) {
+    Series& s = m_series[productId];
+
+    if (s.prefix.empty()) {
+        s.firstDay = s.minDay = s.maxDay = day;
+        s.prefix.push_back(qty);
+        s.sales = 1;
+        return;
+    }
+
+    // Too far from the bucketed sales: keep it aside
+    const long long lo = std::min(s.minDay, day);
+    const long long hi = std::max(s.maxDay, day);
+    if (hi - lo + 1 > kMaxSeriesDays) {
+        s.outliers.emplace_back(day, qty);
+        if (s.outliers.size() > std::max(s.sales, s.outlierLimit)) reanchor(s);
+        return;
+    }
+
+    // Back-dated sale: grow the front by at least the current length, so
+    // a run of older sales shifts the series a logarithmic number of times
+    if (day < s.firstDay) {
+        const long long wanted = static_cast<long long>(s.firstDay) - static_cast<long long>(s.prefix.size());
+        const long long floor = static_cast<long long>(s.maxDay) - kMaxSeriesDays + 1;
+        const int newFirst = static_cast<int>(std::min<long long>(day, std::max(wanted, floor)));
+        s.prefix.insert(s.prefix.begin(), static_cast<size_t>(s.firstDay - newFirst), 0);
+        s.firstDay = newFirst;
+    }
+
+    // Extend the tail up to `day` (common case: today's sale)
+    const size_t idx = static_cast<size_t>(day - s.firstDay);
+    if (idx >= s.prefix.size()) {
+        s.prefix.resize(idx + 1, s.prefix.back());
+    }
+
+    for (size_t i = idx; i < s.prefix.size(); ++i) s.prefix[i] += qty;
+    s.minDay = static_cast<int>(lo);
+    s.maxDay = static_cast<int>(hi);
+    s.sales++;
+}
+
+long long SalesVelocity::cumulative(const Series& s, int day) {
+    if (s.prefix.empty() || day < s.firstDay) return 0;
+    const size_t idx = std::min(static_cast<size_t>(day - s.firstDay), s.prefix.size() - 1);
+    return s.prefix[idx];
+}
+
+long long SalesVelocity::unitsSold(int productId, int fromDay, int toDay) const {
+    if (toDay < fromDay) return 0;
+
+    auto it = m_series.find(productId);
+    if (it == m_series.end()) return 0;
+
+    const Series& s = it->second;
+    const long long before = (fromDay == INT_MIN) ? 0 : cumulative(s, fromDay - 1);
+    long long units = cumulative(s, toDay) - before;
+    for (const auto& [day, qty] : s.outliers) {
+        if (day >= fromDay && day <= toDay) units += qty;
+    }
+    return units;
+}
+
+long long SalesVelocity::unitsInLastDays(int productId, int asOfDay, int days) const {
+    if (days <= 0) return 0;
+    return unitsSold(productId, asOfDay - days + 1, asOfDay);
+}
+
+double SalesVelocity::dailyVelocity(int productId, int asOfDay, int days) const {
+    if (days <= 0) return 0.0;
+    return static_cast<double>(unitsInLastDays(productId, asOfDay, days)) / days;
+}
@@ -0,0 +1,590 @@
+#include "Server.h"
+#include "Exceptions.h"
+#include "PremiumCustomer.h"
+#include "TextFormat.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+std::atomic<int> g_wakeFd{-1};
+std::atomic<bool> g_stopRequested{false};
+
+const size_t kMaxLineLength = 64 * 1024;
+
+bool isWriteCommand(const std::string& cmd) {
+    return cmd == "create-order" || cmd == "add-item" || cmd == "remove-item" ||
+           cmd == "finalize" || cmd == "finalize-batch" || cmd == "restock" || cmd == "expense";
+}
+
+// Money in replies: fixed, two decimals, like the batch CSV
+std::string money(double v) {
+    std::string s;
+    TextFormat::fixed(s, v);
+    return s;
+}
+
+std::string secondWord(const std::string& line) {
+    std::istringstream in(line);
+    std::string word;
+    in >> word >> word;
+    return word;
+}
+
+std::string okResponse(const std::string& payload) {
+    const size_t lines = static_cast<size_t>(std::count(payload.begin(), payload.end(), '\n'));
+    return "OK " + std::to_string(lines) + "\n" + payload;
+}
+
+std::string errResponse(std::string message) {
+    std::replace(message.begin(), message.end(), '\n', ' ');
+    return "ERR " + message + "\n";
+}
+
+#ifndef _WIN32
+struct Connection {
+    int fd = -1;
+    std::string in;
+    std::string out;
+    std::deque<std::string> pending;   // complete lines not yet dispatched
+    bool busy = false;                 // a request is with the workers
+    bool peerClosed = false;
+};
+
+void setNonBlocking(int fd) {
+    const int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        throw std::runtime_error(std::string("fcntl failed: ") + std::strerror(errno));
+    }
+}
+#endif
+} // namespace
+
+Server::Server(DataManager& dm, std::string dataDir, ServerOptions options)
+    : dm(dm), dataDir(std::move(dataDir)), options(std::move(options)),
+      runner(dm, this->dataDir, 0), pendingWrites(0), readOnly(false), stopping(false),
+      savedVersion(0), lastSaveOk(true), saverStop(false),
+      served(0), listenFd(-1), wakeFds{-1, -1} {}
+
+Server::~Server() {
+    closeAll();
+}
+
+size_t Server::requestsServed() const {
+    return served.load();
+}
+
+void Server::applyWrite(const std::function<size_t()>& mutate) {
+    SnapshotPtr toSave;
+    {
+        std::unique_lock<std::shared_mutex> lock(dataMutex);
+        size_t writes;
+        try {
+            writes = mutate();
+        } catch (...) {
+            dm.syncIndexes();
+            dm.publishSnapshot();
+            throw;
+        }
+        dm.syncIndexes();
+        dm.publishSnapshot();
+
+        // Nothing is saved once the change log stopped (see ChangeFeed::failure())
+        pendingWrites += writes;
+        if (options.commitEvery > 0 && pendingWrites >= options.commitEvery && dm.changes().failure().empty()) {
+            toSave = dm.pinSnapshot();
+            pendingWrites = 0;
+        }
+    }
+    if (toSave) queueSave(std::move(toSave));
+}
+
+bool Server::commit() {
+    SnapshotPtr snapshot;
+    {
+        std::unique_lock<std::shared_mutex> lock(dataMutex);
+        if (!dm.changes().failure().empty()) return false;
+        snapshot = dm.pinSnapshot();
+        pendingWrites = 0;
+    }
+    const uint64_t version = snapshot->version;
+    queueSave(std::move(snapshot));
+    return waitSaved(version);
+}
+
+void Server::attachReplica(ReplicaHooks hooks) {
+    replica = std::move(hooks);
+    readOnly = true;
+}
+
+std::string Server::handle(const std::string& line) {
+    std::istringstream args(line);
+    std::string cmd;
+    args >> cmd;
+
+    std::ostringstream out;
+    try {
+        if (isWriteCommand(cmd)) {
+            if (readOnly) throw std::runtime_error("Read-only replica; send 'promote' first.");
+            applyWrite([&] {
+                runner.execute(line, out);
+                return size_t{1};
+            });
+        } else if (cmd == "commit") {
+            if (!commit()) throw FileOperationException("Save failed; see server log.");
+        } else if (cmd == "promote") {
+            std::lock_guard<std::mutex> lock(promoteMutex);
+            if (!readOnly) throw std::runtime_error("Not a replica.");
+            replica.promote();
+            readOnly = false;
+        } else if (cmd == "role") {
+            out << (readOnly ? replica.status() : std::string("primary")) << "\n";
+        } else if (cmd == "report" && secondWord(line) == "top-products") {
+            std::string name;
+            args >> name;
+            topProducts(*dm.pinSnapshot(), args, out);   // no data lock: the snapshot is immutable
+        } else {
+            std::shared_lock<std::shared_mutex> lock(dataMutex);
+            handleRead(cmd, args, line, out);
+        }
+    } catch (const std::exception& e) {
+        return errResponse(e.what());
+    }
+    return okResponse(out.str());
+}
+
+void Server::handleRead(const std::string& cmd, std::istream& args, const std::string& line,
+                        std::ostream& out) {
+    if (cmd == "ping") return;
+
+    if (cmd == "query-orders") {
+        runner.execute(line, out);
+        return;
+    }
+
+    if (cmd == "product" || cmd == "customer" || cmd == "order") {
+        int id;
+        if (!(args >> id)) throw InvalidInputException("Missing or invalid argument: id");
+
+        if (cmd == "product") {
+            const Product* p = dm.findProduct(id);
+            if (!p) throw InvalidInputException("Product not found: " + std::to_string(id));
+            out << p->getId() << "," << p->getName() << "," << money(p->getPrice()) << ","
+                << money(p->getCost()) << "," << p->getQuantity() << "," << dm.available(*p) << "\n";
+        } else if (cmd == "customer") {
+            const Customer* c = dm.findCustomer(id);
+            if (!c) throw InvalidInputException("Customer not found: " + std::to_string(id));
+            out << c->getId() << "," << c->getName() << ","
+                << (dynamic_cast<const PremiumCustomer*>(c) ? "Premium" : "Regular") << ","
+                << c->getOrderHistory().size() << "\n";
+        } else {
+            const Order* o = dm.findOrder(id);
+            if (!o) throw InvalidInputException("Order not found: " + std::to_string(id));
+            out << o->getOrderId() << "," << (o->getCustomer() ? o->getCustomer()->getId() : -1)
+                << "," << o->getDate() << "," << money(o->getTotalAmount()) << ","
+                << (o->getIsFinalized() ? "true" : "false") << ",";
+            bool first = true;
+            for (const auto& item : o->getItems()) {
+                if (!first) out << ";";
+                out << (item.first ? item.first->getId() : -1) << ":" << item.second;
+                first = false;
+            }
+            out << "\n";
+        }
+        return;
+    }
+
+    if (cmd == "report") {
+        std::string name;
+        args >> name;
+        TraceSpan span("report", name);
+        if (name == "finance") {
+            std::string from, to;
+            args >> from >> to;
+            const Finance& f = dm.finance();
+            out << "revenue," << money(f.getRevenueBetween(from, to)) << "\n"
+                << "expenses," << money(f.getExpensesBetween(from, to)) << "\n"
+                << "profit," << money(f.calculateProfitBetween(from, to)) << "\n";
+            return;
+        }
+        if (name == "low-stock") {
+            int threshold;
+            if (!(args >> threshold)) throw InvalidInputException("Missing or invalid argument: threshold");
+            for (const auto& entry : dm.stockIndex().below(threshold)) {
+                out << entry.first << "," << entry.second << "\n";
+            }
+            return;
+        }
+        throw InvalidInputException("Unknown report: " + name);
+    }
+
+    throw InvalidInputException("Unknown command: " + cmd);
+}
+
+void Server::topProducts(const Snapshot& snapshot, std::istream& args, std::ostream& out) {
+    TraceSpan span("report:top-products");
+    int n = 10;
+    args >> n;
+    if (n <= 0) throw InvalidInputException("Count must be positive.");
+
+    std::unordered_map<int, long long> units;
+    {
+        // Archive summaries only change on reload, but a follower reloads while serving
+        std::shared_lock<std::shared_mutex> lock(dataMutex);
+        units = dm.archive().unitsByProduct();
+    }
+    snapshot.orders.forEach([&units](const OrderRow& o) {
+        if (!o.finalized) return;
+        for (const auto& item : o.items) units[item.first] += item.second;
+    });
+
+    std::vector<std::pair<long long, int>> ranked;
+    ranked.reserve(units.size());
+    for (const auto& u : units) ranked.emplace_back(u.second, u.first);
+    const size_t shown = std::min(ranked.size(), static_cast<size_t>(n));
+    std::partial_sort(ranked.begin(), ranked.begin() + static_cast<long>(shown), ranked.end(),
+                      [](const auto& a, const auto& b) {
+                          return a.first != b.first ? a.first > b.first : a.second < b.second;
+                      });
+
+    for (size_t i = 0; i < shown; ++i) {
+        out << ranked[i].second << "," << ranked[i].first << "\n";
+    }
+}
+
+void Server::queueSave(SnapshotPtr snapshot) {
+    {
+        std::lock_guard<std::mutex> lock(saveMutex);
+        if (!saveQueued || saveQueued->version < snapshot->version) saveQueued = std::move(snapshot);
+    }
+    saveCv.notify_all();
+}
+
+bool Server::waitSaved(uint64_t version) {
+    std::unique_lock<std::mutex> lock(saveMutex);
+    saveCv.wait(lock, [this, version] { return savedVersion >= version; });
+    return lastSaveOk;
+}
+
+void Server::saverLoop() {
+    for (;;) {
+        SnapshotPtr snapshot;
+        {
+            std::unique_lock<std::mutex> lock(saveMutex);
+            saveCv.wait(lock, [this] { return saverStop || saveQueued; });
+            if (!saveQueued) return;    // stopping with nothing left to write
+            snapshot = std::move(saveQueued);
+            saveQueued.reset();
+        }
+
+        bool ok = true;
+        try {
+            DataManager::saveSnapshot(*snapshot, dataDir);
+        } catch (const std::exception& e) {
+            ok = false;
+            std::cerr << "Background save failed: " << e.what() << "\n";
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(saveMutex);
+            savedVersion = std::max(savedVersion, snapshot->version);
+            lastSaveOk = ok;
+        }
+        saveCv.notify_all();
+    }
+}
+
+void Server::submit(uint64_t connection, std::string line) {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobs.push_back(Job{connection, std::move(line)});
+    }
+    jobReady.notify_one();
+}
+
+#ifdef _WIN32
+
+void Server::run() {
+    throw std::runtime_error("Server mode is not supported on Windows.");
+}
+
+void Server::requestStop() {
+    g_stopRequested = true;
+}
+
+void Server::openListener() {}
+void Server::closeAll() {}
+void Server::workerLoop() {}
+
+#else
+
+void Server::requestStop() {
+    g_stopRequested = true;
+    const int fd = g_wakeFd.load();
+    if (fd >= 0) {
+        const char byte = 's';
+        (void)!write(fd, &byte, 1);
+    }
+}
+
+void Server::workerLoop() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        std::string response = handle(job.line);
+        served++;
+
+        {
+            std::lock_guard<std::mutex> lock(doneMutex);
+            done.push_back(Completion{job.connection, std::move(response)});
+        }
+        const char byte = 'd';
+        (void)!write(wakeFds[1], &byte, 1);
+    }
+}
+
+void Server::openListener() {
+    const std::string& ep = options.endpoint;
+
+    if (ep.rfind("unix:", 0) == 0) {
+        unixPath = ep.substr(5);
+        sockaddr_un addr{};
+        if (unixPath.empty() || unixPath.size() >= sizeof(addr.sun_path)) {
+            throw InvalidInputException("Invalid unix socket path: " + unixPath);
+        }
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, unixPath.c_str(), sizeof(addr.sun_path) - 1);
+
+        listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0) throw std::runtime_error(std::string("socket failed: ") + std::strerror(errno));
+        unlink(unixPath.c_str());
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            throw std::runtime_error("bind " + unixPath + " failed: " + std::strerror(errno));
+        }
+    } else if (ep.rfind("tcp:", 0) == 0) {
+        int port = 0;
+        try {
+            port = std::stoi(ep.substr(4));
+        } catch (const std::exception&) {
+            port = -1;
+        }
+        if (port <= 0 || port > 65535) throw InvalidInputException("Invalid TCP port: " + ep.substr(4));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (listenFd < 0) throw std::runtime_error(std::string("socket failed: ") + std::strerror(errno));
+        const int one = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            throw std::runtime_error("bind 127.0.0.1:" + std::to_string(port) + " failed: " +
+                                     std::strerror(errno));
+        }
+    } else {
+        throw InvalidInputException("Endpoint must be unix:PATH or tcp:PORT, got: " + ep);
+    }
+
+    if (listen(listenFd, SOMAXCONN) < 0) {
+        throw std::runtime_error(std::string("listen failed: ") + std::strerror(errno));
+    }
+    setNonBlocking(listenFd);
+}
+
+void Server::closeAll() {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (auto& t : workers) {
+        if (t.joinable()) t.join();
+    }
+    workers.clear();
+
+    {
+        std::lock_guard<std::mutex> lock(saveMutex);
+        saverStop = true;
+    }
+    saveCv.notify_all();
+    if (saver.joinable()) saver.join();
+
+    g_wakeFd = -1;
+    for (int& fd : wakeFds) {
+        if (fd >= 0) close(fd);
+        fd = -1;
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+        listenFd = -1;
+        if (!unixPath.empty()) unlink(unixPath.c_str());
+    }
+}
+
+void Server::run() {
+    std::signal(SIGPIPE, SIG_IGN);
+    g_stopRequested = false;
+
+    openListener();
+    if (pipe(wakeFds) < 0) throw std::runtime_error(std::string("pipe failed: ") + std::strerror(errno));
+    setNonBlocking(wakeFds[0]);
+    setNonBlocking(wakeFds[1]);
+    g_wakeFd = wakeFds[1];
+
+    {
+        std::unique_lock<std::shared_mutex> lock(dataMutex);
+        dm.syncIndexes();
+        dm.publishSnapshot();
+    }
+    saverStop = false;
+    saver = std::thread([this] { saverLoop(); });
+
+    unsigned count = options.workers;
+    if (count == 0) count = std::max(1u, std::thread::hardware_concurrency());
+    stopping = false;
+    for (unsigned i = 0; i < count; ++i) workers.emplace_back([this] { workerLoop(); });
+
+    std::cerr << "Serving " << options.endpoint << " with " << count << " worker(s)\n";
+
+    std::unordered_map<uint64_t, Connection> connections;
+    uint64_t nextId = 1;
+    std::vector<pollfd> fds;
+    std::vector<uint64_t> ids;   // connection id per fds entry (after the first two)
+
+    auto dispatch = [this](uint64_t id, Connection& c) {
+        if (c.busy || c.pending.empty()) return;
+        c.busy = true;
+        submit(id, std::move(c.pending.front()));
+        c.pending.pop_front();
+    };
+
+    while (!g_stopRequested) {
+        fds.clear();
+        ids.clear();
+        fds.push_back(pollfd{wakeFds[0], POLLIN, 0});
+        fds.push_back(pollfd{listenFd, POLLIN, 0});
+        for (auto& entry : connections) {
+            short events = 0;
+            if (!entry.second.peerClosed) events |= POLLIN;
+            if (!entry.second.out.empty()) events |= POLLOUT;
+            // A closed peer keeps reporting POLLHUP; skip it until there is output
+            const int fd = (events == 0) ? -1 : entry.second.fd;
+            fds.push_back(pollfd{fd, events, 0});
+            ids.push_back(entry.first);
+        }
+
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("poll failed: ") + std::strerror(errno));
+        }
+
+        if (fds[0].revents & POLLIN) {
+            char buf[256];
+            while (read(wakeFds[0], buf, sizeof(buf)) > 0) {}
+
+            std::vector<Completion> finished;
+            {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                finished.swap(done);
+            }
+            for (auto& f : finished) {
+                auto it = connections.find(f.connection);
+                if (it == connections.end()) continue;   // client went away
+                it->second.out += f.response;
+                it->second.busy = false;
+                dispatch(it->first, it->second);
+            }
+        }
+
+        if (fds[1].revents & POLLIN) {
+            for (;;) {
+                const int fd = accept(listenFd, nullptr, nullptr);
+                if (fd < 0) break;
+                setNonBlocking(fd);
+                Connection c;
+                c.fd = fd;
+                connections.emplace(nextId++, std::move(c));
+            }
+        }
+
+        for (size_t i = 2; i < fds.size(); ++i) {
+            auto it = connections.find(ids[i - 2]);
+            if (it == connections.end()) continue;
+            Connection& c = it->second;
+            bool dead = (fds[i].revents & (POLLERR | POLLNVAL)) != 0;
+
+            if (!dead && (fds[i].revents & (POLLIN | POLLHUP))) {
+                char buf[16 * 1024];
+                const ssize_t n = read(c.fd, buf, sizeof(buf));
+                if (n > 0) {
+                    c.in.append(buf, static_cast<size_t>(n));
+                    size_t start = 0;
+                    for (size_t nl; (nl = c.in.find('\n', start)) != std::string::npos; start = nl + 1) {
+                        std::string line = c.in.substr(start, nl - start);
+                        if (!line.empty() && line.back() == '\r') line.pop_back();
+                        if (!line.empty()) c.pending.push_back(std::move(line));
+                    }
+                    c.in.erase(0, start);
+                    if (c.in.size() > kMaxLineLength) {
+                        c.out += errResponse("Request line too long");
+                        c.in.clear();
+                        c.peerClosed = true;
+                    }
+                    dispatch(it->first, c);
+                } else if (n == 0) {
+                    c.peerClosed = true;
+                } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    dead = true;
+                }
+            }
+
+            if (!dead && !c.out.empty()) {
+                const ssize_t n = write(c.fd, c.out.data(), c.out.size());
+                if (n > 0) {
+                    c.out.erase(0, static_cast<size_t>(n));
+                } else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    dead = true;
+                }
+            }
+
+            const bool drained = c.peerClosed && !c.busy && c.pending.empty() && c.out.empty();
+            if (dead || drained) {
+                close(c.fd);
+                connections.erase(it);
+            }
+        }
+    }
+
+    for (auto& entry : connections) close(entry.second.fd);
+    closeAll();
+    std::cerr << "Server stopped after " << served.load() << " request(s)\n";
+}
+
+#endif
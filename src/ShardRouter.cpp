@@ -0,0 +1,734 @@
+#include "ShardRouter.h"
+#include "Exceptions.h"
+#include "FileManager.h"
+#include "TextFormat.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+
+namespace fs = std::filesystem;
+
+namespace {
+// Commands dispatched ahead of the oldest unfinished one
+const size_t kWindow = 256;
+
+template<typename T>
+T nextArg(std::istream& args, const char* name) {
+    T value;
+    if (!(args >> value)) {
+        throw InvalidInputException(std::string("Missing or invalid argument: ") + name);
+    }
+    return value;
+}
+
+void expectEnd(std::istream& args) {
+    std::string extra;
+    if (args >> extra) throw InvalidInputException("Unexpected argument: " + extra);
+}
+
+std::string shardDir(const std::string& root, size_t shard) {
+    return (fs::path(root) / ("shard-" + std::to_string(shard))).string();
+}
+
+std::string runLine(BatchRunner& runner, const std::string& line) {
+    std::ostringstream out;
+    runner.execute(line, out);
+    return out.str();
+}
+
+// Applies another shard's stock change to this shard's product copies
+void applyStock(DataManager& dm, const std::vector<std::pair<int, int>>& deltas) {
+    for (const auto& [productId, delta] : deltas) {
+        Product* p = dm.findProduct(productId);
+        if (!p) continue;
+        try {
+            dm.adjustStock(*p, delta);
+        } catch (const std::exception& e) {
+            std::cerr << "Shard copy of product #" << productId << " out of step: " << e.what() << "\n";
+        }
+    }
+}
+
+// Rank (count, id) pairs by count descending, then id, and print the top n
+template<typename Count>
+void printTop(std::vector<std::pair<Count, int>> ranked, int n, std::ostream& out,
+              const std::unordered_map<int, std::string>* names = nullptr) {
+    const size_t shown = std::min(ranked.size(), static_cast<size_t>(n));
+    std::partial_sort(ranked.begin(), ranked.begin() + static_cast<long>(shown), ranked.end(),
+                      [](const auto& a, const auto& b) {
+                          return a.first != b.first ? a.first > b.first : a.second < b.second;
+                      });
+    for (size_t i = 0; i < shown; ++i) {
+        out << ranked[i].second << ",";
+        if (names) out << names->at(ranked[i].second) << ",";
+        if constexpr (std::is_floating_point_v<Count>) {
+            std::string money;
+            TextFormat::fixed(money, ranked[i].first);
+            out << money << "\n";
+        } else {
+            out << ranked[i].first << "\n";
+        }
+    }
+}
+
+struct QueryRow {
+    int id;
+    int customer;
+    std::string date;
+    double total;
+    std::string csv;
+};
+} // namespace
+
+// ---------------- ShardMap ----------------
+
+ShardMap ShardMap::byHash(size_t shards) {
+    if (shards == 0) throw std::invalid_argument("Shard count must be positive.");
+    ShardMap map;
+    map.count = shards;
+    return map;
+}
+
+ShardMap ShardMap::byRange(std::vector<int> bounds) {
+    if (!std::is_sorted(bounds.begin(), bounds.end())) {
+        throw std::invalid_argument("Shard range bounds must be ascending.");
+    }
+    ShardMap map;
+    map.count = bounds.size() + 1;
+    map.ranged = true;
+    map.upperBounds = std::move(bounds);
+    return map;
+}
+
+ShardMap ShardMap::balancedRanges(std::vector<int> customerIds, size_t shards) {
+    if (shards == 0) throw std::invalid_argument("Shard count must be positive.");
+    std::sort(customerIds.begin(), customerIds.end());
+
+    std::vector<int> bounds;
+    const size_t n = customerIds.size();
+    for (size_t i = 1; i < shards; ++i) {
+        const size_t end = i * n / shards;   // first ID of shard i
+        bounds.push_back(end == 0 ? (bounds.empty() ? 0 : bounds.back()) : customerIds[end - 1]);
+    }
+    return byRange(std::move(bounds));
+}
+
+ShardMap ShardMap::load(const std::string& filepath) {
+    std::ifstream in(filepath);
+    if (!in.is_open()) throw FileOperationException("Failed to open shard map: " + filepath);
+
+    std::string kind;
+    size_t shards = 0;
+    if (!(in >> kind >> shards) || shards == 0) throw FileOperationException("Invalid shard map: " + filepath);
+
+    if (kind == "hash") return byHash(shards);
+    if (kind == "range") {
+        std::vector<int> bounds(shards - 1);
+        for (int& b : bounds) {
+            if (!(in >> b)) throw FileOperationException("Invalid shard map: " + filepath);
+        }
+        return byRange(std::move(bounds));
+    }
+    throw FileOperationException("Unknown shard map kind '" + kind + "' in " + filepath);
+}
+
+void ShardMap::save(const std::string& filepath) const {
+    std::ofstream out(filepath);
+    if (!out.is_open()) throw FileOperationException("Failed to write shard map: " + filepath);
+
+    out << (ranged ? "range " : "hash ") << count;
+    for (int b : upperBounds) out << " " << b;
+    out << "\n";
+}
+
+size_t ShardMap::shardOf(int customerId) const {
+    if (ranged) {
+        return static_cast<size_t>(std::lower_bound(upperBounds.begin(), upperBounds.end(), customerId) -
+                                   upperBounds.begin());
+    }
+    const long n = static_cast<long>(count);
+    return static_cast<size_t>(((customerId % n) + n) % n);
+}
+
+size_t ShardMap::size() const {
+    return count;
+}
+
+// ---------------- Shard ----------------
+
+Shard::Shard(std::string dataDir)
+    : dir(std::move(dataDir)), dm(), runner(dm, dir, 0), stopping(false) {
+    worker = std::thread([this] { loop(); });
+}
+
+Shard::~Shard() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_one();
+    worker.join();
+}
+
+const std::string& Shard::dataDir() const {
+    return dir;
+}
+
+void Shard::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.push_back(std::move(task));
+    }
+    queueReady.notify_one();
+}
+
+void Shard::loop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;   // stopping, and nothing left to run
+            task = std::move(queue.front());
+            queue.pop_front();
+        }
+        task();
+    }
+}
+
+// ---------------- ShardRouter ----------------
+
+ShardRouter::ShardRouter(std::string root, size_t commitEvery)
+    : root(std::move(root)), commitEvery(commitEvery),
+      map(ShardMap::load((fs::path(this->root) / "shards.txt").string())), pending(0) {
+    for (size_t i = 0; i < map.size(); ++i) shards.push_back(std::make_unique<Shard>(shardDir(this->root, i)));
+    pendingStock.resize(shards.size());
+
+    // Load in parallel, then learn where each order lives
+    std::vector<std::future<std::vector<int>>> loads;
+    for (auto& shard : shards) {
+        loads.push_back(shard->submit([dir = shard->dataDir()](DataManager& dm, BatchRunner&) {
+            dm.loadAll(dir);
+            std::vector<int> orderIds;
+            for (const auto& o : dm.orders()) orderIds.push_back(o.getOrderId());
+            return orderIds;
+        }));
+    }
+    for (size_t i = 0; i < loads.size(); ++i) {
+        for (int id : loads[i].get()) orderShard.emplace(id, i);
+    }
+
+    // Every shard should hold the same stock. If a save was cut short they
+    // may not: trust the lowest count and bring the other copies down to it.
+    std::vector<std::future<std::vector<std::pair<int, int>>>> copies;
+    for (auto& shard : shards) {
+        copies.push_back(shard->submit([](DataManager& dm, BatchRunner&) {
+            std::vector<std::pair<int, int>> levels;
+            for (const auto& p : dm.products()) levels.emplace_back(p.getId(), p.getQuantity());
+            return levels;
+        }));
+    }
+    std::vector<std::vector<std::pair<int, int>>> levels;
+    for (auto& f : copies) levels.push_back(f.get());
+    for (const auto& shardLevels : levels) {
+        for (const auto& [id, qty] : shardLevels) {
+            auto it = stock.find(id);
+            if (it == stock.end()) stock.emplace(id, qty);
+            else it->second = std::min(it->second, qty);
+        }
+    }
+    for (size_t i = 0; i < shards.size(); ++i) {
+        std::vector<std::pair<int, int>> fix;
+        for (const auto& [id, qty] : levels[i]) {
+            if (qty != stock[id]) fix.emplace_back(id, stock[id] - qty);
+        }
+        if (fix.empty()) continue;
+        std::cerr << "Shard " << i << ": " << fix.size() << " product stock level(s) differ; using the lowest.\n";
+        shards[i]->submit([fix](DataManager& dm, BatchRunner&) { applyStock(dm, fix); }).get();
+    }
+}
+
+ShardRouter::~ShardRouter() {
+    // Finish what is in flight before the shards go, so no task posts to a
+    // shard that was already destroyed.
+    for (auto& f : inFlight) {
+        if (f.output.valid()) f.output.wait();
+    }
+    // Queued mailbox deliveries use the stock lock, so they run now
+    shards.clear();
+}
+
+size_t ShardRouter::shardCount() const {
+    return shards.size();
+}
+
+void ShardRouter::split(DataManager& source, const std::string& root, const ShardMap& map) {
+    if (source.archive().orderCount() > 0) {
+        // Segments are immutable and mix customers; archive each shard instead
+        throw InvalidInputException("Data directory has archived orders; split before archiving.");
+    }
+    const size_t n = map.size();
+
+    std::vector<std::vector<Customer*>> customers(n);
+    std::vector<std::vector<Order>> orders(n);
+    std::vector<Finance> ledgers(n);
+    std::unordered_map<int, size_t> owner;
+
+    for (Customer* c : source.customers()) customers[map.shardOf(c->getId())].push_back(c);
+    for (const Order& o : source.orders()) {
+        const size_t shard = o.getCustomer() ? map.shardOf(o.getCustomer()->getId()) : 0;
+        orders[shard].push_back(o);
+        owner.emplace(o.getOrderId(), shard);
+    }
+
+    // Revenue follows its order; everything else is booked on shard 0
+    for (const auto& t : source.finance().getTransactions()) {
+        size_t shard = 0;
+        if (t.type == "Revenue" && t.orderId >= 0) {
+            auto it = owner.find(t.orderId);
+            if (it != owner.end()) shard = it->second;
+        }
+        if (t.type == "Revenue") ledgers[shard].recordRevenue(t.amount, t.description, t.date, t.orderId);
+        else ledgers[shard].recordExpense(t.amount, t.description, t.date);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        const fs::path dir = shardDir(root, i);
+        fs::create_directories(dir);
+        FileManager::saveProducts(source.products(), (dir / "products.txt").string());
+        FileManager::saveCustomers(customers[i], (dir / "customers.txt").string());
+        FileManager::saveOrders(orders[i], (dir / "orders.txt").string());
+        FileManager::saveFinance(ledgers[i], (dir / "finance.txt").string());
+    }
+    map.save((fs::path(root) / "shards.txt").string());
+}
+
+BatchStats ShardRouter::run(std::istream& in, std::ostream& out, std::ostream& err) {
+    stats = BatchStats{};
+    pending = 0;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        stats.lines++;
+
+        const size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+
+        InFlight job{stats.lines, {}, false, -1};
+        std::istringstream args(line);
+        std::string cmd;
+        args >> cmd;
+
+        if (cmd == "commit") {
+            drain(out, err);
+            try {
+                expectEnd(args);
+                commit();
+                stats.ok++;
+            } catch (const std::exception& e) {
+                stats.failed++;
+                err << "line " << stats.lines << ": " << e.what() << "\n";
+            }
+            continue;
+        }
+
+        try {
+            job.output = dispatch(line, job.mutates, job.createdOrder);
+        } catch (...) {
+            // Reported in line order with everything still in flight
+            std::promise<std::string> failed;
+            failed.set_exception(std::current_exception());
+            job.output = failed.get_future();
+        }
+        inFlight.push_back(std::move(job));
+
+        if (inFlight.size() > kWindow) retire(out, err);
+        if (commitEvery > 0 && pending >= commitEvery) {
+            drain(out, err);
+            commit();
+        }
+    }
+
+    drain(out, err);
+    if (pending > 0) commit();
+    return stats;
+}
+
+void ShardRouter::retire(std::ostream& out, std::ostream& err) {
+    InFlight job = std::move(inFlight.front());
+    inFlight.pop_front();
+
+    try {
+        out << job.output.get();
+        stats.ok++;
+        if (job.mutates) pending++;
+    } catch (const std::exception& e) {
+        stats.failed++;
+        err << "line " << job.line << ": " << e.what() << "\n";
+        if (job.createdOrder >= 0) orderShard.erase(job.createdOrder);
+    }
+}
+
+void ShardRouter::drain(std::ostream& out, std::ostream& err) {
+    while (!inFlight.empty()) retire(out, err);
+}
+
+void ShardRouter::commit() {
+    for (auto& f : inFlight) f.output.wait();
+
+    // Stock changes sent between shards were queued by tasks that have all
+    // finished, so each save runs after them.
+    std::vector<std::future<void>> saves;
+    for (auto& shard : shards) {
+        saves.push_back(shard->submit([dir = shard->dataDir()](DataManager& dm, BatchRunner&) {
+            dm.saveAll(dir);
+        }));
+    }
+    for (auto& f : saves) f.get();
+
+    pending = 0;
+    stats.commits++;
+}
+
+size_t ShardRouter::ownerOf(int orderId) const {
+    auto it = orderShard.find(orderId);
+    if (it == orderShard.end()) throw InvalidInputException("Order not found: " + std::to_string(orderId));
+    return it->second;
+}
+
+std::future<std::string> ShardRouter::dispatch(const std::string& line, bool& mutates, int& createdOrder) {
+    std::istringstream args(line);
+    std::string cmd;
+    args >> cmd;
+
+    auto runOn = [&line](Shard& shard) {
+        return shard.submit([line](DataManager&, BatchRunner& runner) { return runLine(runner, line); });
+    };
+
+    if (cmd == "create-order") {
+        const int orderId = nextArg<int>(args, "orderId");
+        const int customerId = nextArg<int>(args, "customerId");
+        nextArg<std::string>(args, "date");
+        expectEnd(args);
+        if (orderShard.count(orderId)) throw InvalidInputException("Order ID already exists: " + std::to_string(orderId));
+
+        const size_t shard = map.shardOf(customerId);
+        orderShard.emplace(orderId, shard);
+        createdOrder = orderId;
+        mutates = true;
+        return runOn(*shards[shard]);
+    }
+
+    if (cmd == "add-item" || cmd == "remove-item") {
+        const size_t shard = ownerOf(nextArg<int>(args, "orderId"));
+        mutates = true;
+        return runOn(*shards[shard]);
+    }
+
+    if (cmd == "finalize") {
+        const int orderId = nextArg<int>(args, "orderId");
+        expectEnd(args);
+        const size_t shard = ownerOf(orderId);
+        mutates = true;
+        return shards[shard]->submit([this, shard, orderId](DataManager& dm, BatchRunner&) {
+            finalizeOn(shard, dm, orderId);
+            return std::string();
+        });
+    }
+
+    if (cmd == "finalize-batch") {
+        std::vector<int> ids;
+        int id;
+        while (args >> id) ids.push_back(id);
+        if (!args.eof()) throw InvalidInputException("Invalid order ID in finalize-batch.");
+        if (ids.empty()) throw InvalidInputException("Missing argument: orderId");
+        mutates = true;
+        return finalizeBatch(ids);
+    }
+
+    if (cmd == "restock") {
+        const int productId = nextArg<int>(args, "productId");
+        const int qty = nextArg<int>(args, "qty");
+        std::string date = "N/A";
+        args >> date;
+        expectEnd(args);
+        if (qty <= 0) throw InvalidInputException("Restock quantity must be positive.");
+        mutates = true;
+        return restock(productId, qty, date);
+    }
+
+    if (cmd == "expense") {
+        mutates = true;
+        return runOn(*shards[0]);
+    }
+
+    if (cmd == "query-orders") return queryOrders(args);
+    if (cmd == "report") return report(args);
+
+    throw InvalidInputException("Unknown command: " + cmd);
+}
+
+void ShardRouter::finalizeOn(size_t shard, DataManager& dm, int orderId) {
+    Order* order = dm.findOrder(orderId);
+    if (!order) throw InvalidInputException("Order not found: " + std::to_string(orderId));
+    order->finalTotal();   // validate before any stock is taken
+
+    std::unordered_map<int, int> need;
+    for (const auto& [p, qty] : order->getItems()) need[p->getId()] += qty;
+
+    // Check, finalize and publish under one lock, so every shard receives
+    // stock changes in the order the router-wide count made them. The
+    // mailbox is applied first, so this copy agrees with the count.
+    std::lock_guard<std::mutex> lock(stockMutex);
+    applyPendingStock(shard, dm);
+    for (const auto& [productId, qty] : need) {
+        auto it = stock.find(productId);
+        if (it == stock.end() || it->second < qty) {
+            throw InsufficientStockException("Insufficient stock for product: " +
+                                             dm.findProduct(productId)->getName());
+        }
+    }
+    dm.finalizeOrder(*order);
+
+    std::vector<std::pair<int, int>> deltas;
+    for (const auto& [productId, qty] : need) {
+        stock[productId] -= qty;
+        deltas.emplace_back(productId, -qty);
+    }
+    for (size_t other = 0; other < shards.size(); ++other) {
+        if (other != shard) postStock(other, deltas);
+    }
+}
+
+void ShardRouter::postStock(size_t shard, const std::vector<std::pair<int, int>>& deltas) {
+    auto& mailbox = pendingStock[shard];
+    mailbox.insert(mailbox.end(), deltas.begin(), deltas.end());
+    // Delivered by the next finalize on that shard, or by this task
+    shards[shard]->submit([this, shard](DataManager& dm, BatchRunner&) {
+        std::lock_guard<std::mutex> lock(stockMutex);
+        applyPendingStock(shard, dm);
+    });
+}
+
+void ShardRouter::applyPendingStock(size_t shard, DataManager& dm) {
+    if (pendingStock[shard].empty()) return;
+    std::vector<std::pair<int, int>> deltas;
+    deltas.swap(pendingStock[shard]);
+    applyStock(dm, deltas);
+}
+
+std::future<std::string> ShardRouter::finalizeBatch(const std::vector<int>& ids) {
+    using Failure = std::tuple<size_t, int, std::string>;   // (position, orderId, reason)
+    std::vector<Failure> unknown;
+    std::vector<std::vector<std::pair<size_t, int>>> perShard(shards.size());
+
+    for (size_t i = 0; i < ids.size(); ++i) {
+        auto it = orderShard.find(ids[i]);
+        if (it == orderShard.end()) unknown.emplace_back(i, ids[i], "Order not found.");
+        else perShard[it->second].emplace_back(i, ids[i]);
+    }
+
+    std::vector<std::future<std::vector<Failure>>> parts;
+    for (size_t s = 0; s < shards.size(); ++s) {
+        if (perShard[s].empty()) continue;
+        parts.push_back(shards[s]->submit([this, s, batch = std::move(perShard[s])](DataManager& dm, BatchRunner&) {
+            std::vector<Failure> failed;
+            for (const auto& [pos, id] : batch) {
+                try {
+                    finalizeOn(s, dm, id);
+                } catch (const std::exception& e) {
+                    failed.emplace_back(pos, id, e.what());
+                }
+            }
+            return failed;
+        }));
+    }
+
+    return std::async(std::launch::deferred, [unknown = std::move(unknown), parts = std::move(parts)]() mutable {
+        std::vector<Failure> failed = std::move(unknown);
+        for (auto& part : parts) {
+            for (auto& f : part.get()) failed.push_back(std::move(f));
+        }
+        std::sort(failed.begin(), failed.end());
+
+        std::ostringstream out;
+        for (const auto& [pos, id, reason] : failed) out << id << "," << reason << "\n";
+        return out.str();
+    });
+}
+
+std::future<std::string> ShardRouter::restock(int productId, int qty, const std::string& date) {
+    // Under the stock lock, so the increase lands in every mailbox ahead of
+    // any decrease that it pays for.
+    std::lock_guard<std::mutex> lock(stockMutex);
+    auto it = stock.find(productId);
+    if (it == stock.end()) throw InvalidInputException("Product not found: " + std::to_string(productId));
+    it->second += qty;
+
+    const std::vector<std::pair<int, int>> deltas{{productId, qty}};
+    for (size_t s = 0; s < shards.size(); ++s) postStock(s, deltas);
+
+    // Shard 0 books the cost
+    return shards[0]->submit([productId, qty, date](DataManager& dm, BatchRunner&) {
+        const Product* p = dm.findProduct(productId);
+        if (!p) throw InvalidInputException("Product not found: " + std::to_string(productId));
+        dm.recordExpense(p->getCost() * qty, "Restock product #" + std::to_string(productId), date);
+        return std::string();
+    });
+}
+
+std::future<std::string> ShardRouter::queryOrders(std::istream& args) {
+    const OrderQuery q = BatchRunner::parseOrderQuery(args);
+
+    // Each shard returns enough rows to cover offset + limit after merging
+    OrderQuery perShard = q;
+    perShard.offset = 0;
+    perShard.limit = q.limit == 0 ? 0 : q.offset + q.limit;
+
+    std::vector<std::future<std::vector<QueryRow>>> parts;
+    for (size_t s = 0; s < shards.size(); ++s) {
+        if (q.customerId >= 0 && map.shardOf(q.customerId) != s) continue;
+        parts.push_back(shards[s]->submit([perShard](DataManager& dm, BatchRunner&) {
+            std::vector<QueryRow> rows;
+            for (size_t row : dm.queryOrders(perShard).rows) {
+                const Order& o = dm.orders()[row];
+                std::ostringstream csv;
+                BatchRunner::printOrderRow(o, csv);
+                rows.push_back({o.getOrderId(), o.getCustomer() ? o.getCustomer()->getId() : -1, o.getDate(),
+                                o.getTotalAmount(), csv.str()});
+            }
+            return rows;
+        }));
+    }
+
+    return std::async(std::launch::deferred, [q, parts = std::move(parts)]() mutable {
+        std::vector<QueryRow> rows;
+        for (auto& part : parts) {
+            for (auto& row : part.get()) rows.push_back(std::move(row));
+        }
+
+        auto before = [&q](const QueryRow& a, const QueryRow& b) {
+            switch (q.sortBy) {
+                case OrderSortKey::Date:     return a.date < b.date;
+                case OrderSortKey::Total:    return a.total < b.total;
+                case OrderSortKey::Customer: return a.customer < b.customer;
+                case OrderSortKey::Id:       break;
+            }
+            return a.id < b.id;
+        };
+        std::stable_sort(rows.begin(), rows.end(), [&](const QueryRow& a, const QueryRow& b) {
+            return q.descending ? before(b, a) : before(a, b);
+        });
+
+        std::ostringstream out;
+        const size_t end = q.limit == 0 ? rows.size() : std::min(rows.size(), q.offset + q.limit);
+        for (size_t i = q.offset; i < end; ++i) out << rows[i].csv;
+        return out.str();
+    });
+}
+
+std::future<std::string> ShardRouter::report(std::istream& args) {
+    const std::string name = nextArg<std::string>(args, "report");
+
+    if (name == "finance") {
+        std::string from, to;
+        args >> from >> to;
+        std::vector<std::future<std::pair<double, double>>> parts;
+        for (auto& shard : shards) {
+            parts.push_back(shard->submit([from, to](DataManager& dm, BatchRunner&) {
+                const Finance& f = dm.finance();
+                return std::make_pair(f.getRevenueBetween(from, to), f.getExpensesBetween(from, to));
+            }));
+        }
+        return std::async(std::launch::deferred, [parts = std::move(parts)]() mutable {
+            double revenue = 0.0, expenses = 0.0;
+            for (auto& part : parts) {
+                const auto totals = part.get();
+                revenue += totals.first;
+                expenses += totals.second;
+            }
+            std::string out = "revenue,";
+            TextFormat::fixed(out, revenue);
+            out += "\nexpenses,";
+            TextFormat::fixed(out, expenses);
+            out += "\nprofit,";
+            TextFormat::fixed(out, revenue - expenses);
+            out += '\n';
+            return out;
+        });
+    }
+
+    int n = 10;
+    args >> n;
+    if (n <= 0) throw InvalidInputException("Count must be positive.");
+
+    if (name == "top-products") {
+        std::vector<std::future<std::unordered_map<int, long long>>> parts;
+        for (auto& shard : shards) {
+            parts.push_back(shard->submit([](DataManager& dm, BatchRunner&) {
+                std::unordered_map<int, long long> units = dm.archive().unitsByProduct();
+                for (const auto& o : dm.orders()) {
+                    if (!o.getIsFinalized()) continue;
+                    for (const auto& [p, qty] : o.getItems()) {
+                        if (p) units[p->getId()] += qty;
+                    }
+                }
+                return units;
+            }));
+        }
+        return std::async(std::launch::deferred, [n, parts = std::move(parts)]() mutable {
+            std::unordered_map<int, long long> units;
+            for (auto& part : parts) {
+                for (const auto& [id, count] : part.get()) units[id] += count;
+            }
+            std::vector<std::pair<long long, int>> ranked;
+            for (const auto& [id, count] : units) ranked.emplace_back(count, id);
+            std::ostringstream out;
+            printTop(std::move(ranked), n, out);
+            return out.str();
+        });
+    }
+
+    if (name == "top-customers") {
+        // Customers live on one shard each, so each shard's top n is exact
+        using Spend = std::pair<std::vector<std::pair<double, int>>, std::unordered_map<int, std::string>>;
+        std::vector<std::future<Spend>> parts;
+        for (auto& shard : shards) {
+            parts.push_back(shard->submit([n](DataManager& dm, BatchRunner&) {
+                std::unordered_map<int, double> spend;
+                for (const auto& o : dm.orders()) {
+                    if (o.getIsFinalized() && o.getCustomer()) spend[o.getCustomer()->getId()] += o.getTotalAmount();
+                }
+                for (const auto& [id, totals] : dm.archive().customerTotals()) spend[id] += totals.spent;
+                Spend top;
+                for (const auto& [id, total] : spend) top.first.emplace_back(total, id);
+                std::sort(top.first.begin(), top.first.end(), [](const auto& a, const auto& b) {
+                    return a.first != b.first ? a.first > b.first : a.second < b.second;
+                });
+                if (top.first.size() > static_cast<size_t>(n)) top.first.resize(static_cast<size_t>(n));
+                for (const auto& entry : top.first) top.second.emplace(entry.second, dm.findCustomer(entry.second)->getName());
+                return top;
+            }));
+        }
+        return std::async(std::launch::deferred, [n, parts = std::move(parts)]() mutable {
+            std::vector<std::pair<double, int>> ranked;
+            std::unordered_map<int, std::string> names;
+            for (auto& part : parts) {
+                Spend top = part.get();
+                ranked.insert(ranked.end(), top.first.begin(), top.first.end());
+                names.insert(top.second.begin(), top.second.end());
+            }
+            std::ostringstream out;
+            printTop(std::move(ranked), n, out, &names);
+            return out.str();
+        });
+    }
+
+    throw InvalidInputException("Unknown report: " + name);
+}
@@ -0,0 +1,290 @@
+#include "Sketches.h"
+#include "Parallel.h"
+
+#include <cmath>
+#include <stdexcept>
+
+// ---------------- HyperLogLog ----------------
+
+HyperLogLog::HyperLogLog(int precision) : precision(precision) {
+    if (precision < 4 || precision > 18) {
+        throw std::invalid_argument("HyperLogLog precision must be in [4, 18].");
+    }
+    registers.assign(size_t{1} << precision, 0);
+}
+
+uint64_t HyperLogLog::hashId(uint64_t x) {
+    // splitmix64 finalizer: cheap and well mixed for sequential IDs
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+void HyperLogLog::add(uint64_t hash) {
+    const size_t idx = static_cast<size_t>(hash >> (64 - precision));
+    uint64_t w = hash << precision;
+
+    // rank = position of the first set bit in the remaining bits
+    const uint8_t maxRank = static_cast<uint8_t>(64 - precision + 1);
+    uint8_t rank = 1;
+    while (rank < maxRank && !(w & (uint64_t{1} << 63))) {
+        ++rank;
+        w <<= 1;
+    }
+
+    if (rank > registers[idx]) registers[idx] = rank;
+}
+
+void HyperLogLog::addId(int64_t id) {
+    add(hashId(static_cast<uint64_t>(id)));
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+    if (other.precision != precision) {
+        throw std::invalid_argument("Cannot merge HyperLogLog sketches of different precision.");
+    }
+    for (size_t i = 0; i < registers.size(); ++i) {
+        if (other.registers[i] > registers[i]) registers[i] = other.registers[i];
+    }
+}
+
+double HyperLogLog::estimate() const {
+    const double m = static_cast<double>(registers.size());
+
+    double alpha;
+    if (registers.size() == 16) alpha = 0.673;
+    else if (registers.size() == 32) alpha = 0.697;
+    else if (registers.size() == 64) alpha = 0.709;
+    else alpha = 0.7213 / (1.0 + 1.079 / m);
+
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (uint8_t r : registers) {
+        sum += std::ldexp(1.0, -static_cast<int>(r));
+        if (r == 0) ++zeros;
+    }
+
+    double e = alpha * m * m / sum;
+
+    // Small-range correction (linear counting)
+    if (e <= 2.5 * m && zeros > 0) {
+        e = m * std::log(m / static_cast<double>(zeros));
+    }
+    return e;
+}
+
+double HyperLogLog::standardError() const {
+    return 1.04 / std::sqrt(static_cast<double>(registers.size()));
+}
+
+size_t HyperLogLog::memoryBytes() const {
+    return sizeof(*this) + registers.capacity();
+}
+
+// ---------------- CountMinSketch ----------------
+
+CountMinSketch::CountMinSketch(size_t width, size_t depth)
+    : width(width), depth(depth), total(0) {
+    if (width == 0 || depth == 0) {
+        throw std::invalid_argument("Count-Min width and depth must be positive.");
+    }
+    counters.assign(width * depth, 0);
+}
+
+size_t CountMinSketch::slot(size_t row, uint64_t key) const {
+    // One independent-enough hash per row by seeding splitmix with the row
+    const uint64_t h = HyperLogLog::hashId(key ^ (0x51afd7ed558ccd6dULL * (row + 1)));
+    return row * width + static_cast<size_t>(h % width);
+}
+
+void CountMinSketch::add(uint64_t key, int64_t count) {
+    total += count;
+    for (size_t r = 0; r < depth; ++r) counters[slot(r, key)] += count;
+}
+
+int64_t CountMinSketch::estimate(uint64_t key) const {
+    int64_t best = counters[slot(0, key)];
+    for (size_t r = 1; r < depth; ++r) {
+        const int64_t v = counters[slot(r, key)];
+        if (v < best) best = v;
+    }
+    return best;
+}
+
+void CountMinSketch::merge(const CountMinSketch& other) {
+    if (other.width != width || other.depth != depth) {
+        throw std::invalid_argument("Cannot merge Count-Min sketches of different shape.");
+    }
+    total += other.total;
+    for (size_t i = 0; i < counters.size(); ++i) counters[i] += other.counters[i];
+}
+
+int64_t CountMinSketch::totalCount() const {
+    return total;
+}
+
+double CountMinSketch::epsilon() const {
+    return std::exp(1.0) / static_cast<double>(width);
+}
+
+double CountMinSketch::delta() const {
+    return std::exp(-static_cast<double>(depth));
+}
+
+size_t CountMinSketch::memoryBytes() const {
+    return sizeof(*this) + counters.capacity() * sizeof(int64_t);
+}
+
+// ---------------- HeavyHitters ----------------
+
+HeavyHitters::HeavyHitters(size_t k, size_t width, size_t depth)
+    : k(k), cms(width, depth) {}
+
+void HeavyHitters::offer(int key, int64_t estimate) {
+    auto found = candidates.find(key);
+    if (found != candidates.end()) {
+        heap.erase({found->second, key});
+        found->second = estimate;
+        heap.insert({estimate, key});
+        return;
+    }
+
+    if (candidates.size() < k) {
+        candidates.emplace(key, estimate);
+        heap.insert({estimate, key});
+        return;
+    }
+
+    // Replace the current minimum if the newcomer beats it
+    auto smallest = heap.begin();
+    if (smallest == heap.end() || estimate <= smallest->first) return;
+
+    candidates.erase(smallest->second);
+    heap.erase(smallest);
+    candidates.emplace(key, estimate);
+    heap.insert({estimate, key});
+}
+
+void HeavyHitters::add(int key, int64_t count) {
+    const uint64_t hk = static_cast<uint64_t>(static_cast<int64_t>(key));
+    cms.add(hk, count);
+    offer(key, cms.estimate(hk));
+}
+
+void HeavyHitters::merge(const HeavyHitters& other) {
+    cms.merge(other.cms);
+
+    // Re-rank the union of both candidate sets against the merged counts
+    std::vector<int> keys;
+    keys.reserve(candidates.size() + other.candidates.size());
+    for (const auto& kv : candidates) keys.push_back(kv.first);
+    for (const auto& kv : other.candidates) keys.push_back(kv.first);
+
+    candidates.clear();
+    heap.clear();
+    for (int key : keys) {
+        offer(key, cms.estimate(static_cast<uint64_t>(static_cast<int64_t>(key))));
+    }
+}
+
+std::vector<std::pair<int, int64_t>> HeavyHitters::top() const {
+    std::vector<std::pair<int, int64_t>> rows;
+    rows.reserve(heap.size());
+    for (auto it = heap.rbegin(); it != heap.rend(); ++it) {
+        rows.push_back({it->second, it->first});
+    }
+    return rows;
+}
+
+const CountMinSketch& HeavyHitters::sketch() const {
+    return cms;
+}
+
+size_t HeavyHitters::memoryBytes() const {
+    // set/map nodes: rough per-node overhead of three pointers plus payload
+    return sizeof(*this) + cms.memoryBytes()
+         + candidates.size() * (sizeof(std::pair<int, int64_t>) + 3 * sizeof(void*))
+         + heap.size() * (sizeof(std::pair<int64_t, int>) + 4 * sizeof(void*));
+}
+
+// ---------------- OrderSketches ----------------
+
+OrderSketches::OrderSketches(size_t topK) : m_heavy(topK) {}
+
+void OrderSketches::addOrder(const Order& order) {
+    if (!order.getIsFinalized()) return;
+
+    const Customer* c = order.getCustomer();
+    const std::string& date = order.getDate();
+
+    if (c && date.size() >= 7) {
+        auto it = m_monthly.find(date.substr(0, 7));
+        if (it == m_monthly.end()) {
+            it = m_monthly.emplace(date.substr(0, 7), HyperLogLog(kMonthPrecision)).first;
+        }
+        it->second.addId(c->getId());
+    }
+
+    for (const auto& item : order.getItems()) {
+        if (!item.first) continue;
+        const int pid = item.first->getId();
+
+        m_heavy.add(pid, item.second);
+
+        if (c) {
+            auto it = m_productBuyers.find(pid);
+            if (it == m_productBuyers.end()) {
+                if (m_productBuyers.size() >= kMaxProductSketches) continue;
+                it = m_productBuyers.emplace(pid, HyperLogLog(kProductPrecision)).first;
+            }
+            it->second.addId(c->getId());
+        }
+    }
+}
+
+void OrderSketches::merge(const OrderSketches& other) {
+    for (const auto& [month, hll] : other.m_monthly) {
+        auto it = m_monthly.find(month);
+        if (it == m_monthly.end()) m_monthly.emplace(month, hll);
+        else it->second.merge(hll);
+    }
+    for (const auto& [pid, hll] : other.m_productBuyers) {
+        auto it = m_productBuyers.find(pid);
+        if (it != m_productBuyers.end()) it->second.merge(hll);
+        else if (m_productBuyers.size() < kMaxProductSketches) m_productBuyers.emplace(pid, hll);
+    }
+    m_heavy.merge(other.m_heavy);
+}
+
+OrderSketches OrderSketches::build(const std::vector<Order>& orders, size_t topK) {
+    const unsigned workers = parallelWorkerCount(orders.size());
+    std::vector<OrderSketches> partial(workers, OrderSketches(topK));
+
+    parallelFor(orders.size(), workers, [&](size_t begin, size_t end, unsigned w) {
+        for (size_t i = begin; i < end; ++i) partial[w].addOrder(orders[i]);
+    });
+
+    for (unsigned w = 1; w < workers; ++w) partial[0].merge(partial[w]);
+    return std::move(partial[0]);
+}
+
+const std::map<std::string, HyperLogLog>& OrderSketches::monthlyCustomers() const {
+    return m_monthly;
+}
+
+const HeavyHitters& OrderSketches::heavyHitters() const {
+    return m_heavy;
+}
+
+double OrderSketches::distinctBuyers(int productId) const {
+    auto it = m_productBuyers.find(productId);
+    return it == m_productBuyers.end() ? -1.0 : it->second.estimate();
+}
+
+size_t OrderSketches::memoryBytes() const {
+    size_t bytes = sizeof(*this) + m_heavy.memoryBytes();
+    for (const auto& kv : m_monthly) bytes += kv.first.capacity() + kv.second.memoryBytes();
+    for (const auto& kv : m_productBuyers) bytes += kv.second.memoryBytes();
+    return bytes;
+}
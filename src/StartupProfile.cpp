@@ -0,0 +1,13 @@
+#include "StartupProfile.h"
+
+const char* startupPhaseName(StartupPhase phase) {
+    switch (phase) {
+        case StartupPhase::Read: return "read";
+        case StartupPhase::Parse: return "parse";
+        case StartupPhase::Resolve: return "resolve";
+        case StartupPhase::Index: return "index";
+        case StartupPhase::Render: return "render";
+        case StartupPhase::Count: break;
+    }
+    return "?";
+}
@@ -0,0 +1,100 @@
+#include "StockIndex.h"
+
+void StockIndex::rebuild(const std::vector<Product>& products) {
+    m_qty.clear();
+    m_byQty.clear();
+    m_byMargin.clear();
+
+    m_qty.reserve(products.size());
+    for (const auto& p : products) {
+        m_qty[p.getId()] = p.getQuantity();
+        m_byQty.insert({p.getQuantity(), p.getId()});
+    }
+
+    // Keep reorder points for products that still exist
+    for (auto it = m_reorderPoint.begin(); it != m_reorderPoint.end();) {
+        auto q = m_qty.find(it->first);
+        if (q == m_qty.end()) {
+            it = m_reorderPoint.erase(it);
+            continue;
+        }
+        m_byMargin.insert({q->second - it->second, it->first});
+        ++it;
+    }
+}
+
+void StockIndex::update(const Product& product) {
+    const int id = product.getId();
+    const int qty = product.getQuantity();
+
+    auto found = m_qty.find(id);
+    if (found != m_qty.end()) {
+        if (found->second == qty) return;
+        m_byQty.erase({found->second, id});
+    }
+
+    auto rp = m_reorderPoint.find(id);
+    if (rp != m_reorderPoint.end() && found != m_qty.end()) {
+        m_byMargin.erase({found->second - rp->second, id});
+    }
+
+    m_qty[id] = qty;
+    m_byQty.insert({qty, id});
+    if (rp != m_reorderPoint.end()) m_byMargin.insert({qty - rp->second, id});
+}
+
+void StockIndex::remove(int productId) {
+    auto found = m_qty.find(productId);
+    if (found == m_qty.end()) return;
+
+    m_byQty.erase({found->second, productId});
+
+    auto rp = m_reorderPoint.find(productId);
+    if (rp != m_reorderPoint.end()) {
+        m_byMargin.erase({found->second - rp->second, productId});
+        m_reorderPoint.erase(rp);
+    }
+    m_qty.erase(found);
+}
+
+void StockIndex::setReorderPoint(int productId, int reorderPoint) {
+    auto q = m_qty.find(productId);
+    if (q == m_qty.end()) return;
+
+    auto rp = m_reorderPoint.find(productId);
+    if (rp != m_reorderPoint.end()) {
+        m_byMargin.erase({q->second - rp->second, productId});
+        rp->second = reorderPoint;
+    } else {
+        m_reorderPoint.emplace(productId, reorderPoint);
+    }
+    m_byMargin.insert({q->second - reorderPoint, productId});
+}
+
+void StockIndex::clearReorderPoints() {
+    m_reorderPoint.clear();
+    m_byMargin.clear();
+}
+
+int StockIndex::reorderPoint(int productId) const {
+    auto rp = m_reorderPoint.find(productId);
+    return rp == m_reorderPoint.end() ? -1 : rp->second;
+}
+
+std::vector<std::pair<int, int>> StockIndex::below(int threshold) const {
+    std::vector<std::pair<int, int>> out;
+    for (const auto& [qty, id] : m_byQty) {
+        if (qty >= threshold) break;
+        out.push_back({id, qty});
+    }
+    return out;
+}
+
+std::vector<int> StockIndex::atReorderPoint() const {
+    std::vector<int> out;
+    for (const auto& [margin, id] : m_byMargin) {
+        if (margin > 0) break;
+        out.push_back(id);
+    }
+    return out;
+}
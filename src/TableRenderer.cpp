@@ -0,0 +1,64 @@
+#include "TableRenderer.h"
+
+#include <ostream>
+#include <utility>
+
+namespace {
+// Cells past the declared columns are appended unpadded
+const TableRenderer::Column kUnpadded{"", 0, TableRenderer::Align::Left};
+
+const TableRenderer::Column& columnAt(const std::vector<TableRenderer::Column>& columns, size_t i) {
+    return i < columns.size() ? columns[i] : kUnpadded;
+}
+} // namespace
+
+// ---------------- Row ----------------
+
+TableRenderer::Row& TableRenderer::Row::text(std::string_view s) {
+    const Column& c = columnAt(columns, column++);
+    TextFormat::pad(buffer, s, c.width, c.align);
+    return *this;
+}
+
+TableRenderer::Row& TableRenderer::Row::number(long long v) {
+    const Column& c = columnAt(columns, column++);
+    TextFormat::integer(buffer, v, c.width, c.align);
+    return *this;
+}
+
+TableRenderer::Row& TableRenderer::Row::decimal(double v, int precision) {
+    const Column& c = columnAt(columns, column++);
+    TextFormat::fixed(buffer, v, precision, c.width, c.align);
+    return *this;
+}
+
+// ---------------- TableRenderer ----------------
+
+TableRenderer::TableRenderer(std::vector<Column> cols, size_t ruleWidth)
+    : columns(std::move(cols)) {
+    header = "\n";
+    for (const auto& c : columns) TextFormat::pad(header, c.header, c.width, c.align);
+    header += '\n';
+    header.append(ruleWidth, '-');
+    header += '\n';
+}
+
+void TableRenderer::writeHeader(std::ostream& out) const {
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+}
+
+void TableRenderer::writeRows(std::ostream& out, size_t first, size_t last, const RowFn& row) const {
+    std::string buffer;
+    buffer.reserve(kChunkBytes + 1024);
+    for (size_t i = first; i < last; ++i) {
+        Row r(columns, buffer);
+        row(i, r);
+        buffer += '\n';
+        if (buffer.size() >= kChunkBytes) {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    out.flush();
+}
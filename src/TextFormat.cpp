@@ -0,0 +1,43 @@
+#include "TextFormat.h"
+
+#include <charconv>
+#include <cstdio>
+
+void TextFormat::pad(std::string& out, std::string_view s, size_t width, Align align) {
+    const size_t spaces = s.size() < width ? width - s.size() : 0;
+    if (align == Align::Right) {
+        out.append(spaces, ' ');
+        out.append(s);
+    } else {
+        out.append(s);
+        out.append(spaces, ' ');
+    }
+}
+
+void TextFormat::integer(std::string& out, long long v, size_t width, Align align) {
+    char digits[24];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), v);
+    pad(out, std::string_view(digits, static_cast<size_t>(result.ptr - digits)), width, align);
+}
+
+void TextFormat::fixed(std::string& out, double v, int precision, size_t width, Align align) {
+    char digits[64];
+#if defined(__cpp_lib_to_chars)
+    const auto result = std::to_chars(digits, digits + sizeof(digits), v, std::chars_format::fixed, precision);
+    if (result.ec == std::errc()) {
+        pad(out, std::string_view(digits, static_cast<size_t>(result.ptr - digits)), width, align);
+        return;
+    }
+#endif
+    const int n = std::snprintf(digits, sizeof(digits), "%.*f", precision, v);
+    if (n >= 0 && static_cast<size_t>(n) < sizeof(digits)) {
+        pad(out, std::string_view(digits, static_cast<size_t>(n)), width, align);
+        return;
+    }
+
+    // Huge magnitudes only
+    std::string wide(static_cast<size_t>(n > 0 ? n : 0) + 1, '\0');
+    std::snprintf(wide.data(), wide.size(), "%.*f", precision, v);
+    wide.pop_back();
+    pad(out, wide, width, align);
+}
@@ -0,0 +1,192 @@
+#include "Trace.h"
+#include "Exceptions.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+const size_t kCounters = static_cast<size_t>(TraceCounter::Count);
+
+const char* counterName(size_t counter) {
+    switch (static_cast<TraceCounter>(counter)) {
+        case TraceCounter::RowsParsed: return "rows_parsed";
+        case TraceCounter::BytesWritten: return "bytes_written";
+        case TraceCounter::Lookups: return "lookups";
+        case TraceCounter::Count: break;
+    }
+    return "?";
+}
+
+struct Event {
+    char phase;             // 'X' complete span, 'C' counter sample
+    std::string name;
+    int64_t startNs;
+    int64_t durationNs;
+    uint8_t argCount;
+    std::pair<const char*, int64_t> args[kCounters > 4 ? kCounters : 4];
+};
+
+// One per thread that has recorded anything. The registry keeps it alive
+// after the thread exits so its events still reach the export.
+struct ThreadBuffer {
+    std::mutex mutex;
+    std::vector<Event> events;
+    uint32_t tid = 0;
+};
+
+using Clock = std::chrono::steady_clock;
+
+Clock::time_point g_origin;
+std::atomic<size_t> g_recorded{0};
+std::atomic<size_t> g_dropped{0};
+std::atomic<int64_t> g_counters[kCounters];
+
+std::mutex g_registryMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> g_buffers;
+
+thread_local std::shared_ptr<ThreadBuffer> t_buffer;
+thread_local int t_depth = 0;
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - g_origin).count();
+}
+
+ThreadBuffer& threadBuffer() {
+    if (!t_buffer) {
+        t_buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        t_buffer->tid = static_cast<uint32_t>(g_buffers.size() + 1);
+        g_buffers.push_back(t_buffer);
+    }
+    return *t_buffer;
+}
+
+void record(Event&& event) {
+    if (g_recorded.fetch_add(1, std::memory_order_relaxed) >= Trace::kMaxEvents) {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);   // only the export contends
+    buffer.events.push_back(std::move(event));
+}
+
+void writeEscaped(std::ostream& out, const std::string& s) {
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+            out << buf;
+        } else {
+            out << c;
+        }
+    }
+}
+
+// Chrome timestamps are microseconds; three decimals keep nanoseconds
+void writeMicros(std::ostream& out, int64_t ns) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%lld.%03lld", static_cast<long long>(ns / 1000),
+                  static_cast<long long>(ns % 1000));
+    out << buf;
+}
+} // namespace
+
+const size_t Trace::kMaxEvents;
+std::atomic<bool> Trace::s_enabled{false};
+
+void Trace::start() {
+    g_origin = Clock::now();
+    s_enabled.store(true, std::memory_order_release);
+}
+
+void Trace::addSlow(TraceCounter counter, int64_t delta) {
+    g_counters[static_cast<size_t>(counter)].fetch_add(delta, std::memory_order_relaxed);
+}
+
+size_t Trace::eventCount() {
+    return std::min(g_recorded.load(std::memory_order_relaxed), kMaxEvents);
+}
+
+void Trace::writeChromeJson(const std::string& path) {
+    std::ofstream out(path);
+    if (!out.is_open()) throw FileOperationException("Failed to write trace file: " + path);
+
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        buffers = g_buffers;
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":"
+        << g_dropped.load(std::memory_order_relaxed) << "},\"traceEvents\":[\n"
+        << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+        << "\"args\":{\"name\":\"BusinessManagementSystem\"}}";
+    for (const auto& buffer : buffers) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        for (const Event& e : buffer->events) {
+            out << ",\n{\"name\":\"";
+            writeEscaped(out, e.name);
+            out << "\",\"ph\":\"" << e.phase << "\",\"pid\":1,\"tid\":" << buffer->tid << ",\"ts\":";
+            writeMicros(out, e.startNs);
+            if (e.phase == 'X') {
+                out << ",\"dur\":";
+                writeMicros(out, e.durationNs);
+            }
+            if (e.argCount > 0) {
+                out << ",\"args\":{";
+                for (uint8_t i = 0; i < e.argCount; ++i) {
+                    out << (i ? "," : "") << "\"" << e.args[i].first << "\":" << e.args[i].second;
+                }
+                out << "}";
+            }
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+    if (!out) throw FileOperationException("Failed to write trace file: " + path);
+}
+
+void TraceSpan::begin(const char* spanName, const std::string* spanDetail) {
+    active = true;
+    name = spanName;
+    detail = spanDetail;
+    t_depth++;
+    startNs = nowNs();
+}
+
+void TraceSpan::end() {
+    const int64_t endNs = nowNs();
+
+    Event span;
+    span.phase = 'X';
+    span.name = name;
+    if (detail) {
+        span.name += ':';
+        span.name += *detail;
+    }
+    span.startNs = startNs;
+    span.durationNs = endNs - startNs;
+    span.argCount = argCount;
+    for (uint8_t i = 0; i < argCount; ++i) span.args[i] = {args[i].key, args[i].value};
+    record(std::move(span));
+
+    if (--t_depth > 0) return;
+    Event sample;
+    sample.phase = 'C';
+    sample.name = "counters";
+    sample.startNs = endNs;
+    sample.durationNs = 0;
+    sample.argCount = static_cast<uint8_t>(kCounters);
+    for (size_t i = 0; i < kCounters; ++i) {
+        sample.args[i] = {counterName(i), g_counters[i].load(std::memory_order_relaxed)};
+    }
+    record(std::move(sample));
+}
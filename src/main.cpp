@@ -1,17 +1,39 @@
 #include "Application.h"
+#include "Follower.h"
+#include "Trace.h"
 #include <csignal>
 #include <cstdlib>
 #include <exception>
 #include <iostream>
+#include <string>
 
 namespace {
 Application* g_appInstance = nullptr;
+std::string g_tracePath;
+
+// Writes the --trace file once, on whichever exit path comes first
+void writeTrace() {
+    if (g_tracePath.empty()) return;
+    const std::string path = g_tracePath;
+    g_tracePath.clear();
+    try {
+        Trace::writeChromeJson(path);
+        std::cerr << "Trace written to " << path << " (" << Trace::eventCount() << " events).\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Could not write trace: " << e.what() << "\n";
+    }
+}
+
+struct TraceWriter {
+    ~TraceWriter() { writeTrace(); }
+};
 
 void quickShutdown() {
     if (g_appInstance != nullptr) {
         g_appInstance->shutdown();
         g_appInstance = nullptr;
     }
+    writeTrace();
 }
 
 void handleSigInt(int signalCode) {
@@ -19,22 +41,219 @@ void handleSigInt(int signalCode) {
         std::quick_exit(130);
     }
 }
+
+void handleStopSignal(int) {
+    Server::requestStop();
+    Follower::requestStop();
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--data-dir DIR] [--cdc-log FILE] [--batch FILE|-] [--commit-every N]\n"
+              << "       " << program << " [--data-dir DIR] [--cdc-log FILE] --serve unix:PATH|tcp:PORT"
+              << " [--workers N] [--commit-every N]\n"
+              << "       " << program << " [--data-dir DIR] --follow LOG [--serve unix:PATH|tcp:PORT]"
+              << " [--workers N] [--commit-every N] [--cdc-log FILE]\n"
+              << "       " << program << " [--data-dir DIR] --shard-root ROOT --split-shards N [--shard-by hash|range]\n"
+              << "       " << program << " --shard-root ROOT --batch FILE|- [--commit-every N]\n"
+              << "       " << program << " [--data-dir DIR] --archive-before YYYY-MM-DD\n"
+              << "       " << program << " [--data-dir DIR] --export-invoices DIR|FILE [--bundle]"
+              << " [--from YYYY-MM-DD] [--to YYYY-MM-DD]\n"
+              << "       " << program << " [--data-dir DIR] --profile-startup N\n"
+              << "Any mode also takes --trace FILE (Chrome trace-event JSON, written on exit).\n";
+}
+
+bool parseCount(const char* text, size_t& value) {
+    try {
+        value = static_cast<size_t>(std::stoul(text));
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
 } // namespace
 
 
-int main() {
+int main(int argc, char** argv) {
+    std::string dataDir = "data";
+    std::string batchSource;
+    std::string serveEndpoint;
+    std::string changeLogPath;
+    std::string followLog;
+    std::string shardRoot;
+    std::string archiveBefore;
+    std::string invoiceOut;
+    std::string invoiceFrom;
+    std::string invoiceTo;
+    bool invoiceBundle = false;
+    size_t splitShards = 0;
+    size_t profileRuns = 0;
+    bool shardByRange = false;
+    size_t commitEvery = 1000;
+    size_t workers = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--data-dir" && hasValue) {
+            dataDir = argv[++i];
+        } else if (arg == "--batch" && hasValue) {
+            batchSource = argv[++i];
+        } else if (arg == "--cdc-log" && hasValue) {
+            changeLogPath = argv[++i];
+        } else if (arg == "--shard-root" && hasValue) {
+            shardRoot = argv[++i];
+        } else if (arg == "--split-shards" && hasValue) {
+            if (!parseCount(argv[++i], splitShards) || splitShards == 0) {
+                printUsage(argv[0]);
+                return 2;
+            }
+        } else if (arg == "--shard-by" && hasValue) {
+            const std::string scheme = argv[++i];
+            if (scheme != "hash" && scheme != "range") {
+                printUsage(argv[0]);
+                return 2;
+            }
+            shardByRange = scheme == "range";
+        } else if (arg == "--archive-before" && hasValue) {
+            archiveBefore = argv[++i];
+        } else if (arg == "--export-invoices" && hasValue) {
+            invoiceOut = argv[++i];
+        } else if (arg == "--bundle") {
+            invoiceBundle = true;
+        } else if (arg == "--from" && hasValue) {
+            invoiceFrom = argv[++i];
+        } else if (arg == "--to" && hasValue) {
+            invoiceTo = argv[++i];
+        } else if (arg == "--profile-startup" && hasValue) {
+            if (!parseCount(argv[++i], profileRuns) || profileRuns == 0) {
+                printUsage(argv[0]);
+                return 2;
+            }
+        } else if (arg == "--trace" && hasValue) {
+            g_tracePath = argv[++i];
+        } else if (arg == "--follow" && hasValue) {
+            followLog = argv[++i];
+        } else if (arg == "--serve" && hasValue) {
+            serveEndpoint = argv[++i];
+        } else if (arg == "--commit-every" && hasValue) {
+            if (!parseCount(argv[++i], commitEvery)) {
+                printUsage(argv[0]);
+                return 2;
+            }
+        } else if (arg == "--workers" && hasValue) {
+            if (!parseCount(argv[++i], workers)) {
+                printUsage(argv[0]);
+                return 2;
+            }
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (!batchSource.empty() && (!serveEndpoint.empty() || !followLog.empty())) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    // Sharded runs take a shard root plus exactly one of --split-shards or --batch
+    // (shards keep no change log)
+    if (!shardRoot.empty() && ((splitShards > 0) == !batchSource.empty() || !serveEndpoint.empty() ||
+                               !followLog.empty() || !changeLogPath.empty())) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    if (shardRoot.empty() && splitShards > 0) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    if (!archiveBefore.empty() && (!batchSource.empty() || !serveEndpoint.empty() || !followLog.empty() ||
+                                   !shardRoot.empty())) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    // --bundle, --from and --to only qualify an invoice export
+    if (invoiceOut.empty() && (invoiceBundle || !invoiceFrom.empty() || !invoiceTo.empty())) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    if (!invoiceOut.empty() && (!archiveBefore.empty() || !batchSource.empty() || !serveEndpoint.empty() ||
+                                !followLog.empty() || !shardRoot.empty())) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    if (profileRuns > 0 && (!invoiceOut.empty() || !archiveBefore.empty() || !batchSource.empty() ||
+                            !serveEndpoint.empty() || !followLog.empty() || !shardRoot.empty())) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
     #ifdef _WIN32
         system("chcp 65001 > nul");
     #endif
 
+    TraceWriter traceWriter;   // after the Application below is gone, so its final save is traced
+    if (!g_tracePath.empty()) Trace::start();
+
     try {
         std::at_quick_exit(quickShutdown);
         std::signal(SIGINT, handleSigInt);
 
-        Application app("data");
+        Application app(dataDir);
+        app.setChangeLog(changeLogPath);
         g_appInstance = &app;
 
-        app.initialize();
+        if (profileRuns > 0) {
+            const int code = app.profileStartup(profileRuns);
+            g_appInstance = nullptr;
+            return code;
+        }
+
+        if (!archiveBefore.empty()) {
+            const int code = app.archiveOrders(archiveBefore);
+            g_appInstance = nullptr;
+            return code;
+        }
+
+        if (!invoiceOut.empty()) {
+            const int code = app.exportInvoices(invoiceOut, invoiceBundle, invoiceFrom, invoiceTo);
+            g_appInstance = nullptr;
+            return code;
+        }
+
+        if (!shardRoot.empty()) {
+            const int code = splitShards > 0 ? app.splitShards(shardRoot, splitShards, shardByRange)
+                                             : app.runShardedBatch(shardRoot, batchSource, commitEvery);
+            g_appInstance = nullptr;
+            return code;
+        }
+
+        if (!batchSource.empty()) {
+            const int code = app.runBatch(batchSource, commitEvery);
+            g_appInstance = nullptr;
+            return code;
+        }
+
+        if (!serveEndpoint.empty() || !followLog.empty()) {
+            std::signal(SIGINT, handleStopSignal);
+            std::signal(SIGTERM, handleStopSignal);
+
+            ServerOptions options;
+            options.endpoint = serveEndpoint;
+            options.workers = static_cast<unsigned>(workers);
+            options.commitEvery = commitEvery;
+
+            const int code = followLog.empty() ? app.runServer(options)
+                                               : app.runFollower(followLog, options, commitEvery);
+            app.shutdown();
+            g_appInstance = nullptr;
+            return code;
+        }
+
+        if (!app.initialize()) {
+            app.shutdown();
+            g_appInstance = nullptr;
+            return 1;
+        }
         app.run();
         app.shutdown();
         g_appInstance = nullptr;
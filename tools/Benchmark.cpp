@@ -0,0 +1,307 @@
+// Benchmarks for BusinessManagementSystem's core paths over one data
+// directory (see DataGenerator for data at scale).
+//
+//   Benchmark --data-dir DIR [--repeat 3] [--lookups 1000000]
+//             [--finalize 10000] [--format json|csv] [--out FILE]
+//
+// Times loadAll, saveAll (into a scratch directory), every non-interactive
+// report, RFM segmentation, order queries, ID lookups and finalization
+// throughput. Results go to stdout or --out as JSON or CSV; progress goes to
+// stderr. The data directory itself is only read.
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "DataManager.h"
+#include "DateUtil.h"
+#include "MenuSystem.h"
+#include "RfmAnalysis.h"
+
+namespace {
+
+struct Options {
+    std::string dataDir;
+    size_t repeat = 3;
+    size_t lookups = 1000000;
+    size_t finalize = 10000;
+    std::string format = "json";
+    std::string outFile;
+};
+
+struct Dataset {
+    size_t products = 0;
+    size_t customers = 0;
+    size_t orders = 0;
+    size_t transactions = 0;
+    size_t archivedOrders = 0;
+};
+
+struct Result {
+    std::string name;
+    size_t runs = 0;
+    double minMs = 0.0;
+    double meanMs = 0.0;
+    double maxMs = 0.0;
+    size_t ops = 0;         // operations per run, 0 when the run is one operation
+
+    double opsPerSec() const { return ops && meanMs > 0.0 ? ops / (meanMs / 1000.0) : 0.0; }
+};
+
+class Suite {
+public:
+    // Runs `fn` `runs` times; `setup` (untimed) runs before each one
+    void time(const std::string& name, size_t runs, size_t ops, const std::function<void()>& fn,
+              const std::function<void()>& setup = nullptr) {
+        Result r;
+        r.name = name;
+        r.runs = runs;
+        r.ops = ops;
+        r.minMs = 1e300;
+        for (size_t i = 0; i < runs; ++i) {
+            if (setup) setup();
+            const auto t0 = std::chrono::steady_clock::now();
+            fn();
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            r.minMs = std::min(r.minMs, ms);
+            r.maxMs = std::max(r.maxMs, ms);
+            r.meanMs += ms / static_cast<double>(runs);
+        }
+        std::cerr << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(12) << r.meanMs << " ms";
+        if (ops) std::cerr << std::setw(16) << std::setprecision(0) << r.opsPerSec() << " ops/s";
+        std::cerr << "\n";
+        results.push_back(std::move(r));
+    }
+
+    const std::vector<Result>& all() const { return results; }
+
+private:
+    std::vector<Result> results;
+};
+
+std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+void writeJson(std::ostream& out, const Options& opt, const Dataset& data, const std::vector<Result>& results) {
+    out << std::setprecision(6) << std::fixed;
+    out << "{\n"
+        << "  \"data_dir\": \"" << jsonEscape(opt.dataDir) << "\",\n"
+        << "  \"dataset\": {\"products\": " << data.products
+        << ", \"customers\": " << data.customers
+        << ", \"orders\": " << data.orders
+        << ", \"transactions\": " << data.transactions
+        << ", \"archived_orders\": " << data.archivedOrders << "},\n"
+        << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"name\": \"" << jsonEscape(r.name) << "\", \"runs\": " << r.runs
+            << ", \"min_ms\": " << r.minMs << ", \"mean_ms\": " << r.meanMs << ", \"max_ms\": " << r.maxMs
+            << ", \"ops\": " << r.ops << ", \"ops_per_sec\": " << r.opsPerSec() << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+void writeCsv(std::ostream& out, const std::vector<Result>& results) {
+    out << std::setprecision(6) << std::fixed;
+    out << "name,runs,min_ms,mean_ms,max_ms,ops,ops_per_sec\n";
+    for (const auto& r : results) {
+        out << r.name << "," << r.runs << "," << r.minMs << "," << r.meanMs << "," << r.maxMs << ","
+            << r.ops << "," << r.opsPerSec() << "\n";
+    }
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const std::string value = argv[++i];
+        if (arg == "--data-dir") o.dataDir = value;
+        else if (arg == "--repeat") o.repeat = std::stoul(value);
+        else if (arg == "--lookups") o.lookups = std::stoul(value);
+        else if (arg == "--finalize") o.finalize = std::stoul(value);
+        else if (arg == "--format") o.format = value;
+        else if (arg == "--out") o.outFile = value;
+        else return false;
+    }
+    return !o.dataDir.empty() && o.repeat > 0 && (o.format == "json" || o.format == "csv");
+}
+
+// New orders for the finalize runs: 1-3 in-stock lines each, IDs above
+// everything loaded or archived
+std::vector<Order*> makeOrders(DataManager& dm, size_t count, int& nextId, std::mt19937_64& rng) {
+    const std::string today = DateUtil::fromDayNumber(DateUtil::todayDayNumber());
+    std::vector<Order*> made;
+    std::vector<int> ids;
+    made.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Customer* c = dm.customers()[rng() % dm.customers().size()];
+        Order& o = dm.createOrder(nextId++, c, today);
+        ids.push_back(o.getOrderId());
+        const size_t lines = 1 + rng() % 3;
+        for (size_t k = 0; k < lines; ++k) {
+            Product& p = dm.products()[rng() % dm.products().size()];
+            dm.adjustStock(p, 2);
+            dm.addOrderItem(o, &p, 1);
+        }
+    }
+    // createOrder may have grown the vector: resolve pointers afterwards
+    for (int id : ids) made.push_back(dm.findOrder(id));
+    return made;
+}
+
+int run(const Options& opt) {
+    namespace fs = std::filesystem;
+    Suite suite;
+    auto dm = std::make_unique<DataManager>();
+
+    // ---- Persistence ----
+    suite.time("loadAll", opt.repeat, 0, [&] { dm->loadAll(opt.dataDir); },
+               [&] { dm = std::make_unique<DataManager>(); });
+    if (dm->products().empty() || dm->customers().empty()) {
+        std::cerr << "Benchmark needs at least one product and one customer.\n";
+        return 1;
+    }
+    // Counted before the finalize runs add their orders
+    Dataset data;
+    data.products = dm->products().size();
+    data.customers = dm->customers().size();
+    data.orders = dm->orders().size();
+    data.transactions = dm->finance().getTransactions().size();
+    data.archivedOrders = dm->archive().orderCount();
+
+    const fs::path scratch = fs::temp_directory_path() /
+        ("bms-bench-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    fs::create_directories(scratch);
+    suite.time("saveAll", opt.repeat, 0, [&] { dm->saveAll(scratch.string()); });
+
+    // ---- Reports ----
+    MenuSystem menu(*dm, scratch.string());
+    for (const auto& name : MenuSystem::reportNames()) {
+        suite.time("report." + name, opt.repeat, 0, [&] {
+            std::ostringstream sink;
+            menu.renderReport(name, sink);
+        });
+    }
+    const int today = DateUtil::todayDayNumber();
+    suite.time("report.rfm", opt.repeat, 0, [&] {
+        RfmAnalysis::compute(dm->customers(), dm->orders(), today, nullptr, &dm->archive());
+    });
+
+    // ---- Queries and lookups ----
+    dm->syncIndexes();
+    std::mt19937_64 rng(42);
+    suite.time("query.orders-by-customer", opt.repeat, 1000, [&] {
+        for (int i = 0; i < 1000; ++i) {
+            OrderQuery q;
+            q.customerId = dm->customers()[rng() % dm->customers().size()]->getId();
+            dm->queryOrders(q);
+        }
+    });
+    // Anchored to the newest order so older datasets still select something
+    int newest = INT_MIN;
+    for (const auto& o : dm->orders()) {
+        int day;
+        if (DateUtil::toDayNumber(o.getDate(), day)) newest = std::max(newest, day);
+    }
+    if (newest != INT_MIN) {
+        suite.time("query.orders-last-30-days", opt.repeat, 0, [&] {
+            OrderQuery q;
+            q.fromDate = DateUtil::fromDayNumber(newest - 30);
+            dm->queryOrders(q);
+        });
+    }
+
+    std::vector<int> productIds, customerIds, orderIds;
+    for (const auto& p : dm->products()) productIds.push_back(p.getId());
+    for (const Customer* c : dm->customers()) customerIds.push_back(c->getId());
+    for (const auto& o : dm->orders()) orderIds.push_back(o.getOrderId());
+
+    auto lookups = [&](const std::string& name, const std::vector<int>& ids, const std::function<const void*(int)>& find) {
+        if (ids.empty() || opt.lookups == 0) return;
+        std::vector<int> probes(opt.lookups);
+        for (auto& id : probes) id = ids[rng() % ids.size()];
+        size_t found = 0;
+        suite.time(name, opt.repeat, probes.size(), [&] {
+            for (int id : probes) found += find(id) != nullptr;
+        });
+        if (found == 0) std::cerr << name << ": nothing found\n";
+    };
+    lookups("lookup.product", productIds, [&](int id) -> const void* { return dm->findProduct(id); });
+    lookups("lookup.customer", customerIds, [&](int id) -> const void* { return dm->findCustomer(id); });
+    lookups("lookup.order", orderIds, [&](int id) -> const void* { return dm->findOrder(id); });
+
+    // ---- Finalization (mutates the in-memory copy; nothing is saved) ----
+    int nextId = 1;
+    for (int id : orderIds) nextId = std::max(nextId, id + 1);
+    while (dm->archive().contains(nextId)) nextId++;
+
+    if (opt.finalize > 0) {
+        std::vector<Order*> batch;
+        Finance ledger;
+        suite.time("finalize.Order", opt.repeat, opt.finalize,
+                   [&] { for (Order* o : batch) o->finalize(ledger); },
+                   [&] { batch = makeOrders(*dm, opt.finalize, nextId, rng); });
+        suite.time("finalize.DataManager", opt.repeat, opt.finalize,
+                   [&] { for (Order* o : batch) dm->finalizeOrder(*o); },
+                   [&] { batch = makeOrders(*dm, opt.finalize, nextId, rng); });
+
+        std::vector<int> ids;
+        suite.time("finalize.batch", opt.repeat, opt.finalize,
+                   [&] { dm->finalizeBatch(ids); },
+                   [&] {
+                       ids.clear();
+                       for (Order* o : makeOrders(*dm, opt.finalize, nextId, rng)) ids.push_back(o->getOrderId());
+                   });
+    }
+
+    std::error_code ec;
+    fs::remove_all(scratch, ec);
+
+    std::ofstream file;
+    if (!opt.outFile.empty()) {
+        file.open(opt.outFile);
+        if (!file) {
+            std::cerr << "Could not write " << opt.outFile << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = opt.outFile.empty() ? std::cout : file;
+    if (opt.format == "csv") writeCsv(out, suite.all());
+    else writeJson(out, opt, data, suite.all());
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    try {
+        if (!parseArgs(argc, argv, opt)) {
+            std::cerr << "Usage: " << argv[0] << " --data-dir DIR [--repeat N] [--lookups N] [--finalize N]"
+                      << " [--format json|csv] [--out FILE]\n";
+            return 2;
+        }
+        return run(opt);
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark: " << e.what() << "\n";
+        return 1;
+    }
+}
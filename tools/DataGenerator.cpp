@@ -0,0 +1,482 @@
+// Synthetic data for BusinessManagementSystem benchmarks.
+//
+// Writes products.txt, customers.txt, orders.txt and finance.txt in the
+// regular data-directory format. Every order references existing products
+// and customers, every finalized order has its revenue entry and appears in
+// its customer's history, and the ledger is in date order.
+//
+//   DataGenerator --out DIR [--orders 100000] [--customers N] [--products N]
+//                 [--seed 1] [--skew 1.1] [--pending 0.02] [--premium 0.2]
+//                 [--start 2024-01-01] [--days 730]
+//
+// Product popularity follows a Zipf law with exponent --skew; orders per
+// customer are log-normal. Order IDs grow with their dates. Each order is a
+// pure function of (seed, ID), so memory stays proportional to customers
+// and products, not orders, and 100M orders fit on a small machine.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string outDir;
+    uint64_t orders = 100000;
+    uint64_t customers = 0;     // 0 = orders / 20
+    uint64_t products = 0;      // 0 = orders / 50, within [20, 50000]
+    uint64_t seed = 1;
+    double skew = 1.1;
+    double pending = 0.02;      // share of the newest orders left open
+    double premium = 0.2;
+    std::string start = "2024-01-01";
+    int days = 730;
+};
+
+// ---------------- Randomness ----------------
+
+uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Small per-entity generator: seeding is one hash, not a 2.5 KB state
+struct SplitMix {
+    uint64_t state;
+    uint64_t next() { return mix(state++); }
+    double unit() { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+    uint64_t below(uint64_t n) { return next() % n; }
+};
+
+// ---------------- Dates ----------------
+
+// Days since 1970-01-01 (proleptic Gregorian)
+int64_t daysFromCivil(int y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+void civilFromDays(int64_t z, char (&out)[32]) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+    const int64_t y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+    std::snprintf(out, sizeof(out), "%04d-%02u-%02u", static_cast<int>(y), m, d);
+}
+
+// ---------------- Order ID permutation ----------------
+
+// Orders are handed out to customers as contiguous slots j; the ID of slot
+// j is a*j + b mod n, so each customer's orders are spread over the ID
+// (and date) range, and the owner of an ID is found by inverting the map.
+class Permutation {
+public:
+    explicit Permutation(uint64_t n, uint64_t seed) : n(n) {
+        a = std::max<uint64_t>(1, static_cast<uint64_t>(static_cast<double>(n) * 0.6180339887));
+        while (std::gcd(a, n) != 1) a++;
+        b = seed % n;
+        aInverse = inverse(a % n, n);
+    }
+
+    uint64_t idOf(uint64_t slot) const { return (a * slot + b) % n + 1; }
+    uint64_t slotOf(uint64_t id) const { return aInverse * ((id - 1 + n - b) % n) % n; }
+
+private:
+    uint64_t n, a, b, aInverse;
+
+    static uint64_t inverse(uint64_t value, uint64_t mod) {
+        if (mod == 1) return 0;
+        int64_t t = 0, newT = 1;
+        int64_t r = static_cast<int64_t>(mod), newR = static_cast<int64_t>(value);
+        while (newR != 0) {
+            const int64_t q = r / newR;
+            t -= q * newT;
+            std::swap(t, newT);
+            r -= q * newR;
+            std::swap(r, newR);
+        }
+        return static_cast<uint64_t>(t < 0 ? t + static_cast<int64_t>(mod) : t);
+    }
+};
+
+// ---------------- Output ----------------
+
+class Writer {
+public:
+    explicit Writer(const std::string& path) : path(path), out(path, std::ios::binary | std::ios::trunc) {
+        if (!out.is_open()) throw std::runtime_error("Could not write " + path);
+        buf.reserve(kFlushAt + 4096);
+    }
+    ~Writer() { flush(); }
+
+    Writer& operator<<(const std::string& s) { buf += s; return maybeFlush(); }
+    Writer& operator<<(const char* s) { buf += s; return maybeFlush(); }
+    Writer& operator<<(char c) { buf += c; return maybeFlush(); }
+    Writer& operator<<(uint64_t v) { buf += std::to_string(v); return maybeFlush(); }
+    Writer& money(double v) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.2f", v);
+        buf += text;
+        return maybeFlush();
+    }
+
+    void flush() {
+        out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        buf.clear();
+        if (!out) throw std::runtime_error("Write failed: " + path);
+    }
+    uint64_t bytes() { flush(); return static_cast<uint64_t>(out.tellp()); }
+
+private:
+    static const size_t kFlushAt = 1 << 20;
+    std::string path;
+    std::ofstream out;
+    std::string buf;
+
+    Writer& maybeFlush() {
+        if (buf.size() >= kFlushAt) flush();
+        return *this;
+    }
+};
+
+// ---------------- Model ----------------
+
+const char* kFirstNames[] = {"Ava", "Liam", "Noah", "Emma", "Olivia", "Mia", "Lucas", "Amelia", "Ethan", "Sofia",
+                             "Arjun", "Fatima", "Hiro", "Chen", "Zara", "Mateo", "Layla", "Omar", "Ines", "Kofi"};
+const char* kLastNames[] = {"Smith", "Patel", "Garcia", "Kim", "Nguyen", "Okafor", "Rossi", "Muller", "Silva", "Khan",
+                            "Cohen", "Ivanov", "Tanaka", "Haddad", "Jensen", "Lopez", "Mensah", "Walsh", "Sato", "Ali"};
+const char* kAdjectives[] = {"Wireless", "Compact", "Premium", "Ergonomic", "Portable", "Smart", "Classic",
+                             "Heavy-Duty", "Eco", "Pro", "Mini", "Deluxe"};
+const char* kNouns[] = {"Keyboard", "Mouse", "Monitor", "Headset", "Charger", "Desk Lamp", "Webcam", "Speaker",
+                        "Router", "Backpack", "Notebook", "Cable", "Chair", "Tablet Stand", "Drive"};
+
+template<typename T, size_t N>
+const T& pick(const T (&items)[N], uint64_t r) { return items[r % N]; }
+
+struct Catalog {
+    std::vector<double> price;        // by product ID - 1
+    std::vector<double> popularityCdf; // by popularity rank
+    std::vector<uint32_t> byRank;     // rank -> product ID
+};
+
+struct Customers {
+    std::vector<uint64_t> firstSlot;  // customer ID - 1 -> first slot; size C + 1
+    std::vector<double> discount;
+};
+
+struct OrderLine {
+    uint32_t productId;
+    uint32_t qty;
+};
+
+struct GeneratedOrder {
+    uint64_t customerId;
+    int64_t day;
+    bool finalized;
+    std::vector<OrderLine> lines;
+    double total;
+};
+
+class Generator {
+public:
+    explicit Generator(const Options& o)
+        : opt(o), perm(o.orders, mix(o.seed ^ 0x5EED)) {
+        int y = 0;
+        unsigned m = 0, d = 0;
+        if (std::sscanf(opt.start.c_str(), "%d-%u-%u", &y, &m, &d) != 3 || m < 1 || m > 12 || d < 1 || d > 31) {
+            throw std::runtime_error("Invalid --start date: " + opt.start);
+        }
+        startDay = daysFromCivil(y, m, d);
+        pendingFrom = opt.orders - static_cast<uint64_t>(opt.pending * static_cast<double>(opt.orders)) + 1;
+    }
+
+    void run() {
+        namespace fs = std::filesystem;
+        fs::create_directories(opt.outDir);
+        const auto t0 = std::chrono::steady_clock::now();
+
+        buildCatalog();
+        buildCustomers();
+        writeProducts();
+        writeCustomers();
+        writeOrdersAndFinance();
+
+        const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << "products:     " << catalog.price.size() << "\n"
+                  << "customers:    " << customers.discount.size() << "\n"
+                  << "orders:       " << opt.orders << " (" << (opt.orders - pendingFrom + 1) << " open)\n"
+                  << "transactions: " << transactions << "\n"
+                  << "bytes:        " << totalBytes << "\n"
+                  << "seconds:      " << secs << "\n";
+    }
+
+private:
+    Options opt;
+    Permutation perm;
+    int64_t startDay = 0;
+    uint64_t pendingFrom = 0;   // IDs from here on stay open
+    Catalog catalog;
+    Customers customers;
+    uint64_t transactions = 0;
+    uint64_t totalBytes = 0;
+
+    std::string path(const char* file) const { return (std::filesystem::path(opt.outDir) / file).string(); }
+
+    void buildCatalog() {
+        const uint64_t n = opt.products;
+        catalog.price.resize(n);
+        for (uint64_t i = 0; i < n; ++i) {
+            SplitMix rng{mix(opt.seed * 31 + i)};
+            // Mostly cheap items, a long tail of expensive ones
+            catalog.price[i] = std::round(std::exp(2.0 + rng.unit() * 5.0) * 100.0) / 100.0 + 0.99;
+        }
+
+        catalog.byRank.resize(n);
+        std::iota(catalog.byRank.begin(), catalog.byRank.end(), 1u);
+        std::shuffle(catalog.byRank.begin(), catalog.byRank.end(), std::mt19937_64(opt.seed));
+
+        catalog.popularityCdf.resize(n);
+        double sum = 0.0;
+        for (uint64_t r = 0; r < n; ++r) {
+            sum += 1.0 / std::pow(static_cast<double>(r + 1), opt.skew);
+            catalog.popularityCdf[r] = sum;
+        }
+        for (double& c : catalog.popularityCdf) c /= sum;
+    }
+
+    void buildCustomers() {
+        const uint64_t n = opt.customers;
+        std::vector<double> weight(n);
+        customers.discount.resize(n);
+        std::mt19937_64 rng(opt.seed + 7);
+        std::lognormal_distribution<double> activity(0.0, 1.0);
+        double total = 0.0;
+        for (uint64_t i = 0; i < n; ++i) {
+            weight[i] = activity(rng);
+            total += weight[i];
+            SplitMix r{mix(opt.seed * 131 + i)};
+            customers.discount[i] = r.unit() < opt.premium ? 0.05 * static_cast<double>(1 + r.below(4)) : 0.0;
+        }
+
+        // Slot counts proportional to weight; the rounding remainder goes to the first customers
+        customers.firstSlot.assign(n + 1, 0);
+        std::vector<uint64_t> count(n);
+        uint64_t assigned = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+            count[i] = static_cast<uint64_t>(static_cast<double>(opt.orders) * weight[i] / total);
+            assigned += count[i];
+        }
+        for (uint64_t i = 0; assigned < opt.orders; i = (i + 1) % n, ++assigned) count[i]++;
+        for (uint64_t i = 0; i < n; ++i) customers.firstSlot[i + 1] = customers.firstSlot[i] + count[i];
+    }
+
+    uint32_t pickProduct(SplitMix& rng) const {
+        const double u = rng.unit();
+        const auto it = std::lower_bound(catalog.popularityCdf.begin(), catalog.popularityCdf.end(), u);
+        const size_t rank = std::min(static_cast<size_t>(it - catalog.popularityCdf.begin()), catalog.byRank.size() - 1);
+        return catalog.byRank[rank];
+    }
+
+    uint64_t customerOf(uint64_t orderId) const {
+        const uint64_t slot = perm.slotOf(orderId);
+        const auto it = std::upper_bound(customers.firstSlot.begin(), customers.firstSlot.end(), slot);
+        return static_cast<uint64_t>(it - customers.firstSlot.begin());   // 1-based
+    }
+
+    bool finalized(uint64_t orderId) const { return orderId < pendingFrom; }
+
+    void generate(uint64_t id, GeneratedOrder& o) const {
+        SplitMix rng{mix(opt.seed ^ (id * 0x2545F4914F6CDD1Dull))};
+        o.customerId = customerOf(id);
+        o.day = startDay + static_cast<int64_t>((id - 1) * static_cast<uint64_t>(opt.days) / opt.orders);
+        o.finalized = finalized(id);
+
+        // 1 item most often, up to 5
+        size_t items = 1;
+        while (items < 5 && rng.unit() < 0.45) items++;
+        o.lines.clear();
+        double subtotal = 0.0;
+        for (size_t i = 0; i < items; ++i) {
+            const uint32_t pid = pickProduct(rng);
+            const uint32_t qty = rng.unit() < 0.8 ? 1u : static_cast<uint32_t>(2 + rng.below(4));
+            bool merged = false;
+            for (auto& line : o.lines) {
+                if (line.productId == pid) {
+                    line.qty += qty;
+                    merged = true;
+                    break;
+                }
+            }
+            if (!merged) o.lines.push_back({pid, qty});
+            subtotal += catalog.price[pid - 1] * qty;
+        }
+        o.total = o.finalized ? subtotal * (1.0 - customers.discount[o.customerId - 1]) : 0.0;
+    }
+
+    void writeProducts() {
+        Writer out(path("products.txt"));
+        out << "ID,Name,Price,Cost,Quantity\n";
+        for (uint64_t i = 0; i < catalog.price.size(); ++i) {
+            SplitMix rng{mix(opt.seed * 37 + i)};
+            const double price = catalog.price[i];
+            const double cost = std::round(price * (0.35 + 0.4 * rng.unit()) * 100.0) / 100.0;
+            // Mostly healthy stock, a few items running low
+            const uint64_t qty = rng.unit() < 0.05 ? rng.below(10) : 20 + rng.below(2000);
+            out << (i + 1) << ',' << pick(kAdjectives, rng.next()) << ' ' << pick(kNouns, rng.next())
+                << ' ' << (i + 1) << ',';
+            out.money(price) << ',';
+            out.money(cost) << ',' << qty << '\n';
+        }
+        totalBytes += out.bytes();
+    }
+
+    void writeCustomers() {
+        Writer out(path("customers.txt"));
+        out << "ID,Name,Type,LoyaltyPercentage,OrderIDs\n";
+        std::vector<uint64_t> history;
+        for (uint64_t c = 0; c < customers.discount.size(); ++c) {
+            SplitMix rng{mix(opt.seed * 41 + c)};
+            const double discount = customers.discount[c];
+            out << (c + 1) << ',' << pick(kFirstNames, rng.next()) << ' ' << pick(kLastNames, rng.next()) << ','
+                << (discount > 0.0 ? "Premium," : "Regular,");
+            if (discount > 0.0) out.money(discount);
+            else out << '0';
+            out << ',';
+
+            // Order history holds finalized orders only, as Order::finalize records it
+            history.clear();
+            for (uint64_t slot = customers.firstSlot[c]; slot < customers.firstSlot[c + 1]; ++slot) {
+                const uint64_t id = perm.idOf(slot);
+                if (finalized(id)) history.push_back(id);
+            }
+            std::sort(history.begin(), history.end());
+            for (size_t i = 0; i < history.size(); ++i) {
+                if (i) out << ';';
+                out << history[i];
+            }
+            out << '\n';
+        }
+        totalBytes += out.bytes();
+    }
+
+    void writeOrdersAndFinance() {
+        const std::string ledgerPart = path("finance.txt.part");
+        double revenue = 0.0, expenses = 0.0;
+        {
+            Writer orders(path("orders.txt"));
+            Writer ledger(ledgerPart);
+            orders << "OrderID,CustomerID,Date,TotalAmount,Finalized,Items\n";
+
+            GeneratedOrder o;
+            char date[32];
+            uint64_t invoice = 0;
+            for (uint64_t id = 1; id <= opt.orders; ++id) {
+                generate(id, o);
+                civilFromDays(o.day, date);
+
+                orders << id << ',' << o.customerId << ',' << date << ',';
+                orders.money(o.total) << ',' << (o.finalized ? "true," : "false,");
+                for (size_t i = 0; i < o.lines.size(); ++i) {
+                    if (i) orders << ';';
+                    orders << static_cast<uint64_t>(o.lines[i].productId) << ':'
+                           << static_cast<uint64_t>(o.lines[i].qty);
+                }
+                orders << '\n';
+
+                if (o.finalized) {
+                    ledger << "Revenue,";
+                    ledger.money(o.total) << ',' << date << ',' << id << ",Order #" << id << '\n';
+                    revenue += o.total;
+                    transactions++;
+                }
+                // A supplier invoice about every 400 orders
+                if (mix(opt.seed ^ (id * 0x9E37)) % 400 == 0) {
+                    SplitMix rng{mix(id + opt.seed)};
+                    const double amount = std::round((200.0 + rng.unit() * 4800.0) * 100.0) / 100.0;
+                    ledger << "Expense,";
+                    ledger.money(amount) << ',' << date << ",-1,Supplier invoice " << ++invoice << '\n';
+                    expenses += amount;
+                    transactions++;
+                }
+            }
+            totalBytes += orders.bytes();
+        }
+
+        // The totals line comes first, so the transactions are staged and appended
+        {
+            std::ofstream out(path("finance.txt"), std::ios::binary | std::ios::trunc);
+            char totals[64];
+            std::snprintf(totals, sizeof(totals), "%.2f,%.2f\n", revenue, expenses);
+            out << "TotalRevenue,TotalExpenses\n" << totals << "TransactionType,Amount,Date,OrderID,Description\n";
+            std::ifstream part(ledgerPart, std::ios::binary);
+            if (part.peek() != std::ifstream::traits_type::eof()) out << part.rdbuf();
+            if (!out) throw std::runtime_error("Write failed: " + path("finance.txt"));
+            totalBytes += static_cast<uint64_t>(out.tellp());
+        }
+        std::filesystem::remove(ledgerPart);
+    }
+};
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const std::string value = argv[++i];
+        if (arg == "--out") o.outDir = value;
+        else if (arg == "--orders") o.orders = std::stoull(value);
+        else if (arg == "--customers") o.customers = std::stoull(value);
+        else if (arg == "--products") o.products = std::stoull(value);
+        else if (arg == "--seed") o.seed = std::stoull(value);
+        else if (arg == "--skew") o.skew = std::stod(value);
+        else if (arg == "--pending") o.pending = std::stod(value);
+        else if (arg == "--premium") o.premium = std::stod(value);
+        else if (arg == "--start") o.start = value;
+        else if (arg == "--days") o.days = std::stoi(value);
+        else return false;
+    }
+    if (o.customers == 0) o.customers = std::max<uint64_t>(10, o.orders / 20);
+    if (o.products == 0) o.products = std::min<uint64_t>(50000, std::max<uint64_t>(20, o.orders / 50));
+    return !o.outDir.empty() && o.orders > 0 && o.orders <= 2000000000ull && o.customers > 0 &&
+           o.products > 0 && o.products < 4000000000ull && o.days > 0 &&
+           o.pending >= 0.0 && o.pending < 1.0 && o.premium >= 0.0 && o.premium <= 1.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    try {
+        if (!parseArgs(argc, argv, opt)) {
+            std::cerr << "Usage: " << argv[0] << " --out DIR [--orders N] [--customers N] [--products N]"
+                      << " [--seed S] [--skew 1.1] [--pending 0.02] [--premium 0.2]"
+                      << " [--start YYYY-MM-DD] [--days N]\n";
+            return 2;
+        }
+        Generator(opt).run();
+    } catch (const std::exception& e) {
+        std::cerr << "DataGenerator: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,212 @@
+// Load generator for BusinessManagementSystem --serve.
+//
+// Opens one connection per client thread and issues a read/write mix.
+// A "write" is one sale: restock 1 unit, create an order, add the unit,
+// finalize (four requests), so stock levels stay where they were.
+//
+//   LoadGenerator --connect unix:/tmp/bms.sock [--clients 8] [--requests 10000]
+//                 [--write-ratio 0.1] [--product 2] [--customer 101]
+//                 [--order-base N] [--date 2026-01-01]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+struct Options {
+    std::string endpoint;
+    unsigned clients = 8;
+    size_t requests = 10000;      // per client
+    double writeRatio = 0.1;
+    int productId = 2;
+    int customerId = 101;
+    long orderBase = -1;
+    std::string date = "2026-01-01";
+};
+
+int connectTo(const std::string& ep) {
+    int fd = -1;
+    if (ep.rfind("unix:", 0) == 0) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, ep.c_str() + 5, sizeof(addr.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            close(fd);
+            fd = -1;
+        }
+    } else if (ep.rfind("tcp:", 0) == 0) {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(std::stoi(ep.substr(4))));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    if (fd < 0) throw std::runtime_error("Could not connect to " + ep);
+    return fd;
+}
+
+// Sends one request and reads its full response; returns false on "ERR".
+class Client {
+public:
+    explicit Client(const std::string& endpoint) : fd(connectTo(endpoint)) {}
+    ~Client() { close(fd); }
+
+    bool request(const std::string& line) {
+        const std::string msg = line + "\n";
+        size_t sent = 0;
+        while (sent < msg.size()) {
+            const ssize_t n = write(fd, msg.data() + sent, msg.size() - sent);
+            if (n <= 0) throw std::runtime_error("Connection lost");
+            sent += static_cast<size_t>(n);
+        }
+
+        const std::string status = readLine();
+        if (status.rfind("OK ", 0) != 0) return false;
+        const long payloadLines = std::stol(status.substr(3));
+        for (long i = 0; i < payloadLines; ++i) readLine();
+        return true;
+    }
+
+private:
+    int fd;
+    std::string buf;
+    size_t pos = 0;
+
+    std::string readLine() {
+        for (;;) {
+            const size_t nl = buf.find('\n', pos);
+            if (nl != std::string::npos) {
+                std::string line = buf.substr(pos, nl - pos);
+                pos = nl + 1;
+                if (pos > 4096) {
+                    buf.erase(0, pos);
+                    pos = 0;
+                }
+                return line;
+            }
+            char chunk[8192];
+            const ssize_t n = read(fd, chunk, sizeof(chunk));
+            if (n <= 0) throw std::runtime_error("Connection lost");
+            buf.append(chunk, static_cast<size_t>(n));
+        }
+    }
+};
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string key = argv[i];
+        const std::string value = argv[i + 1];
+        if (key == "--connect") o.endpoint = value;
+        else if (key == "--clients") o.clients = static_cast<unsigned>(std::stoul(value));
+        else if (key == "--requests") o.requests = std::stoul(value);
+        else if (key == "--write-ratio") o.writeRatio = std::stod(value);
+        else if (key == "--product") o.productId = std::stoi(value);
+        else if (key == "--customer") o.customerId = std::stoi(value);
+        else if (key == "--order-base") o.orderBase = std::stol(value);
+        else if (key == "--date") o.date = value;
+        else return false;
+    }
+    return argc % 2 == 1 && !o.endpoint.empty() && o.clients > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    try {
+        if (!parseArgs(argc, argv, opt)) {
+            std::cerr << "Usage: " << argv[0] << " --connect unix:PATH|tcp:PORT [--clients N]"
+                      << " [--requests N] [--write-ratio R] [--product ID] [--customer ID]"
+                      << " [--order-base N] [--date YYYY-MM-DD]\n";
+            return 2;
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Invalid argument value\n";
+        return 2;
+    }
+
+    // Distinct order IDs per run unless the caller picks them
+    if (opt.orderBase < 0) opt.orderBase = 1000000000L + (std::time(nullptr) % 100000) * 10000L;
+
+    std::atomic<long> nextOrder{opt.orderBase};
+    std::atomic<size_t> total{0}, errors{0};
+    std::vector<std::vector<double>> latencies(opt.clients);
+    std::vector<std::thread> threads;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < opt.clients; ++t) {
+        threads.emplace_back([&, t] {
+            try {
+                Client client(opt.endpoint);
+                std::mt19937 rng(t + 1);
+                std::uniform_real_distribution<double> coin(0.0, 1.0);
+                auto& lat = latencies[t];
+                lat.reserve(opt.requests);
+
+                auto timed = [&](const std::string& line) {
+                    const auto t0 = std::chrono::steady_clock::now();
+                    const bool ok = client.request(line);
+                    lat.push_back(std::chrono::duration<double, std::micro>(
+                        std::chrono::steady_clock::now() - t0).count());
+                    total++;
+                    if (!ok) errors++;
+                };
+
+                const std::string pid = std::to_string(opt.productId);
+                for (size_t i = 0; i < opt.requests;) {
+                    if (coin(rng) < opt.writeRatio && i + 4 <= opt.requests) {
+                        const std::string oid = std::to_string(nextOrder++);
+                        timed("restock " + pid + " 1 " + opt.date);
+                        timed("create-order " + oid + " " + std::to_string(opt.customerId) + " " + opt.date);
+                        timed("add-item " + oid + " " + pid + " 1");
+                        timed("finalize " + oid);
+                        i += 4;
+                    } else {
+                        if (i % 2 == 0) timed("product " + pid);
+                        else timed("customer " + std::to_string(opt.customerId));
+                        i += 1;
+                    }
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "client " << t << ": " << e.what() << "\n";
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> all;
+    for (const auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+    auto pct = [&](double p) {
+        return all.empty() ? 0.0 : all[std::min(all.size() - 1, static_cast<size_t>(p * all.size()))];
+    };
+
+    std::cout << "requests:   " << total.load() << " (" << errors.load() << " errors)\n"
+              << "elapsed:    " << seconds << " s\n"
+              << "throughput: " << (seconds > 0 ? total.load() / seconds : 0.0) << " req/s\n"
+              << "latency us: p50 " << pct(0.50) << ", p99 " << pct(0.99)
+              << ", max " << (all.empty() ? 0.0 : all.back()) << "\n";
+    return errors.load() == 0 ? 0 : 1;
+}
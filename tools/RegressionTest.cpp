@@ -0,0 +1,128 @@
+// Regression checks for fixed bugs, one function per case.
+//
+//   RegressionTest
+//
+// Prints one line per check and exits non-zero if any failed.
+
+#include <climits>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "BatchRunner.h"
+#include "DataManager.h"
+#include "DateUtil.h"
+#include "Finance.h"
+#include "Query.h"
+#include "RegularCustomer.h"
+#include "SalesVelocity.h"
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    std::cout << (ok ? "ok   " : "FAIL ") << what << "\n";
+    if (!ok) ++failures;
+}
+
+// Open orders are filtered and sorted on their running subtotal
+void openOrderTotals() {
+    DataManager dm;
+    dm.addProduct(1, "Cable", 5.0, 2.0, 100);
+    dm.addProduct(2, "Monitor", 200.0, 120.0, 100);
+    Product* cheap = dm.findProduct(1);
+    Product* dear = dm.findProduct(2);
+    dm.addCustomer(new RegularCustomer(1, "Open"));
+    Customer* customer = dm.findCustomer(1);
+
+    Order& small = dm.createOrder(10, customer, "2026-01-01");
+    dm.addOrderItem(small, cheap, 3);
+    Order& large = dm.createOrder(11, customer, "2026-01-02");
+    dm.addOrderItem(large, dear, 2);
+    dm.addOrderItem(large, cheap, 1);
+
+    OrderQuery q;
+    q.minTotal = 100.0;
+    QueryResult r = dm.queryOrders(q);
+    check(r.rows.size() == 1 && dm.orders()[r.rows[0]].getOrderId() == 11,
+          "min total matches the open order with items worth 405");
+
+    q = OrderQuery{};
+    q.sortBy = OrderSortKey::Total;
+    q.descending = true;
+    r = dm.queryOrders(q);
+    check(r.rows.size() == 2 && dm.orders()[r.rows[0]].getOrderId() == 11,
+          "sort by total puts the larger open order first");
+
+    dm.removeOrderItem(*dm.findOrder(11), dear);
+    q = OrderQuery{};
+    q.maxTotal = 10.0;
+    r = dm.queryOrders(q);
+    check(r.rows.size() == 1 && dm.orders()[r.rows[0]].getOrderId() == 11,
+          "removing an item lowers the open order's total");
+}
+
+// Batch CSV keeps the cents of large totals
+void csvMoney() {
+    RegularCustomer customer(7, "Big spender");
+    Order order(20, &customer, "2026-01-03");
+    order.setTotalAmount(1234567.891);
+    std::ostringstream row;
+    BatchRunner::printOrderRow(order, row);
+    check(row.str() == "20,7,2026-01-03,1234567.89,false\n", "order rows print totals with two decimals");
+}
+
+// A mistyped first date must not push every later entry out of the index
+void financeBadLeadingDate() {
+    Finance f;
+    f.recordRevenue(50.0, "Typo", "0201-03-01");
+    for (int day = 1; day <= 28; ++day) {
+        const std::string date = std::string("2026-02-") + (day < 10 ? "0" : "") + std::to_string(day);
+        f.recordRevenue(10.0, "Sale", date);
+        f.recordExpense(4.0, "Cost", date);
+    }
+    check(f.outlierCount() <= 1, "only the mistyped entry stays outside the index");
+    check(f.getRevenueBetween("2026-02-01", "2026-02-28") == 280.0, "revenue over the real dates");
+    check(f.getExpensesBetween("2026-02-10", "2026-02-19") == 40.0, "expenses over part of the real dates");
+    check(f.getRevenueBetween("", "") == 330.0, "open range still counts the mistyped entry");
+    check(f.getRevenueBetween("0201-01-01", "0201-12-31") == 50.0, "the mistyped entry is found by its own date");
+}
+
+// Only real calendar days in exactly YYYY-MM-DD are dates
+void strictDates() {
+    int day;
+    check(DateUtil::toDayNumber("2024-02-29", day), "leap day parses");
+    check(!DateUtil::toDayNumber("2026-02-29", day), "Feb 29 of a common year is rejected");
+    check(!DateUtil::toDayNumber("2026-04-31", day), "Apr 31 is rejected");
+    check(!DateUtil::toDayNumber("2026-01-01junk", day), "trailing characters are rejected");
+}
+
+// Far-off sale dates stay out of the daily buckets but are still counted
+void velocityOutliers() {
+    int today;
+    DateUtil::toDayNumber("2026-02-15", today);
+    int typo;
+    DateUtil::toDayNumber("0206-02-15", typo);
+
+    SalesVelocity v;
+    v.recordSale(1, typo, 7);               // mistyped year first
+    for (int d = 0; d < 30; ++d) v.recordSale(1, today - d, 2);   // back-dated run
+    v.recordSale(1, today + 3650000, 5);    // far future
+    check(v.unitsInLastDays(1, today, 30) == 60, "recent window ignores far-off sales");
+    check(v.unitsSold(1, typo, typo) == 7, "mistyped-year sale is still found by its day");
+    check(v.unitsSold(1, INT_MIN, INT_MAX) == 72, "all-time total counts every sale");
+}
+
+} // namespace
+
+int main() {
+    openOrderTotals();
+    csvMoney();
+    financeBadLeadingDate();
+    strictDates();
+    velocityOutliers();
+
+    std::cout << (failures ? "FAILED" : "PASSED") << "\n";
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,184 @@
+// Concurrency stress test for Order::finalize.
+//
+//   StressTest [--threads 8] [--orders 32000] [--rounds 200]
+//
+// Contended stock: --orders orders, each wanting one unit of a product that
+// only has stock for some of them, are finalized from --threads threads.
+// Stock must never go negative, and the units taken, the revenue recorded
+// and the customer histories must all match the orders that succeeded.
+//
+// Same order: for --rounds rounds, every thread finalizes one shared order
+// at once. Exactly one call may succeed; the rest must throw and leave the
+// stock untouched.
+//
+// Prints one line per check and exits non-zero on the first failure. Built
+// with -fsanitize=thread it also checks for data races.
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Exceptions.h"
+#include "Finance.h"
+#include "Order.h"
+#include "Product.h"
+#include "RegularCustomer.h"
+
+namespace {
+
+struct Options {
+    unsigned threads = 8;
+    size_t orders = 32000;
+    size_t rounds = 200;
+};
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    std::cout << (ok ? "ok   " : "FAIL ") << what << "\n";
+    if (!ok) ++failures;
+}
+
+// Runs fn(thread) on `threads` threads, released together
+template <typename Fn>
+void runTogether(unsigned threads, Fn fn) {
+    std::atomic<unsigned> ready{0};
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            ready.fetch_add(1);
+            while (ready.load() < threads) std::this_thread::yield();
+            fn(t);
+        });
+    }
+    for (auto& th : pool) th.join();
+}
+
+void contendedStock(const Options& opt) {
+    const int stock = static_cast<int>(opt.orders * 5 / 8 + 1);
+    Product product(1, "Contended", 2.0, 1.0, stock);
+    RegularCustomer customer(1, "Stress");
+    Finance finance;
+
+    std::vector<Order> orders;
+    orders.reserve(opt.orders);
+    for (size_t i = 0; i < opt.orders; ++i) {
+        orders.emplace_back(static_cast<int>(i + 1), &customer, "2026-01-01");
+        orders.back().addItem(&product, 1);
+    }
+
+    std::atomic<size_t> succeeded{0};
+    std::atomic<size_t> rejected{0};
+    std::atomic<bool> negative{false};
+    runTogether(opt.threads, [&](unsigned t) {
+        for (size_t i = t; i < orders.size(); i += opt.threads) {
+            try {
+                orders[i].finalize(finance);
+                succeeded.fetch_add(1);
+            } catch (const InsufficientStockException&) {
+                rejected.fetch_add(1);
+            }
+            if (product.getQuantity() < 0) negative.store(true);
+        }
+    });
+
+    size_t finalized = 0;
+    for (const auto& o : orders) finalized += o.getIsFinalized() ? 1 : 0;
+
+    std::cout << "contended stock: " << succeeded.load() << " finalized, " << rejected.load()
+              << " rejected\n";
+    check(!negative.load(), "stock never went negative");
+    check(succeeded.load() + rejected.load() == opt.orders, "every finalize succeeded or was rejected");
+    check(finalized == succeeded.load(), "finalized orders match successful calls");
+    check(static_cast<size_t>(stock - product.getQuantity()) == succeeded.load(),
+          "units taken match finalized orders");
+    check(finance.getTransactions().size() == succeeded.load(), "one revenue entry per finalized order");
+    check(customer.getOrderHistory().size() == succeeded.load(), "one history entry per finalized order");
+}
+
+void sameOrder(const Options& opt) {
+    // Enough lines that reserving them outlasts a scheduler time slice, so
+    // the calls overlap even on a single core. The order is built once
+    // (addItem is linear in the lines) and copied for each round.
+    const size_t kLines = 30000;
+    const int stock = 1000000;
+    std::vector<Product> products;
+    products.reserve(kLines);
+    for (size_t i = 0; i < kLines; ++i) {
+        products.emplace_back(static_cast<int>(i + 1), "Shared", 2.0, 1.0, stock);
+    }
+    RegularCustomer customer(1, "Stress");
+    Finance finance;
+
+    Order pending(1, &customer, "2026-01-01");
+    pending.reserveItems(kLines);
+    for (auto& p : products) pending.addItem(&p, 3);
+
+    size_t badRounds = 0;
+    for (size_t round = 0; round < opt.rounds; ++round) {
+        Order order(pending);
+
+        std::atomic<unsigned> succeeded{0};
+        std::atomic<unsigned> rejected{0};
+        runTogether(opt.threads, [&](unsigned) {
+            try {
+                order.finalize(finance);
+                succeeded.fetch_add(1);
+            } catch (const InvalidInputException&) {
+                rejected.fetch_add(1);
+            }
+        });
+        if (succeeded.load() != 1 || rejected.load() != opt.threads - 1) ++badRounds;
+    }
+
+    std::cout << "same order: " << opt.rounds << " rounds on " << opt.threads << " threads\n";
+    check(badRounds == 0, "exactly one finalize per order succeeded");
+    bool stockOk = true;
+    for (const auto& p : products) stockOk = stockOk && p.getQuantity() == stock - static_cast<int>(3 * opt.rounds);
+    check(stockOk, "stock taken once per order");
+    check(finance.getTransactions().size() == opt.rounds, "one revenue entry per order");
+    check(customer.getOrderHistory().size() == opt.rounds, "one history entry per order");
+}
+
+size_t parseCount(const char* flag, const char* value) {
+    char* end = nullptr;
+    const unsigned long long v = std::strtoull(value, &end, 10);
+    if (!*value || *end || v == 0) {
+        std::cerr << "Invalid value for " << flag << ": " << value << "\n";
+        std::exit(2);
+    }
+    return static_cast<size_t>(v);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Usage: StressTest [--threads N] [--orders N] [--rounds N]\n";
+            return 2;
+        }
+        if (arg == "--threads") {
+            opt.threads = static_cast<unsigned>(parseCount("--threads", argv[++i]));
+        } else if (arg == "--orders") {
+            opt.orders = parseCount("--orders", argv[++i]);
+        } else if (arg == "--rounds") {
+            opt.rounds = parseCount("--rounds", argv[++i]);
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 2;
+        }
+    }
+
+    contendedStock(opt);
+    sameOrder(opt);
+
+    std::cout << (failures ? "FAILED" : "PASSED") << "\n";
+    return failures ? 1 : 0;
+}